@@ -0,0 +1,229 @@
+/**
+ * Enemy strategy dispatch benchmark - the shape of the enemy update loop,
+ *  with simplified strategy bodies (no spatial index or command buffers).
+ *
+ * - switch: one loop over every enemy, switching on a strategy enum stored in
+ *    a component, with a has<>/get<> lookup per entity for the components only
+ *    some strategies touch (the UpdateEnemiesSystem layout before strategy
+ *    tags)
+ * - tagged: one loop per strategy, over the group of its EnemyStrategyTag
+ *    (the UpdateProvoked/Blitzing/WanderingEnemiesSystem layout)
+ *
+ * Strategies are shuffled across entities, like the demo spawns them.
+ *
+ * Usage: igdemo-enemy-strategy-bench [frames]
+ */
+
+#include <igdemo/logic/counter-rng.h>
+#include <igdemo/logic/enemy-strategy.h>
+#include <igdemo/logic/locomotion.h>
+#include <igdemo/logic/renderable.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+
+namespace {
+
+using igdemo::AnimationType;
+using igdemo::BlitzStrategyTag;
+using igdemo::EnemyStrategy;
+using igdemo::EnemyStrategyComponent;
+using igdemo::OrientationComponent;
+using igdemo::PositionComponent;
+using igdemo::RenderableComponent;
+using igdemo::RespondIfProvokedStrategyTag;
+using igdemo::WanderStrategyTag;
+
+const float kDt = 1.f / 60.f;
+const glm::vec2 kHeroPosition(10.f, -4.f);
+
+// Strategy stored as data, as EnemyStrategyComponent used to
+struct LegacyStrategyComponent {
+  EnemyStrategy strategy;
+  std::uint32_t rngSeed;
+};
+
+struct WanderTarget {
+  glm::vec2 map_position;
+  std::uint32_t rng_offset;
+};
+
+std::unique_ptr<entt::registry> make_world(std::uint32_t entity_count) {
+  auto world = std::make_unique<entt::registry>();
+  world->group<LegacyStrategyComponent>(
+      entt::get<PositionComponent, OrientationComponent>);
+  world->group<RespondIfProvokedStrategyTag>(
+      entt::get<PositionComponent, OrientationComponent, RenderableComponent>);
+  world->group<BlitzStrategyTag>(
+      entt::get<PositionComponent, OrientationComponent, RenderableComponent>);
+  world->group<WanderStrategyTag>(
+      entt::get<EnemyStrategyComponent, PositionComponent,
+                OrientationComponent, RenderableComponent>);
+
+  std::mt19937 rng(entity_count);
+  std::uniform_real_distribution<float> pos_dist(-50.f, 50.f);
+  std::uniform_int_distribution<int> strategy_dist(0, 2);
+  for (std::uint32_t i = 0; i < entity_count; i++) {
+    auto e = world->create();
+    auto strategy = static_cast<EnemyStrategy>(strategy_dist(rng));
+    world->emplace<PositionComponent>(
+        e, glm::vec2(pos_dist(rng), pos_dist(rng)));
+    world->emplace<OrientationComponent>(e, 0.f);
+    world->emplace<RenderableComponent>(
+        e, RenderableComponent{igdemo::ModelType::YBOT,
+                               igdemo::MaterialType::RED, AnimationType::IDLE});
+    world->emplace<LegacyStrategyComponent>(
+        e, LegacyStrategyComponent{strategy, i});
+    world->emplace<EnemyStrategyComponent>(e, EnemyStrategyComponent{i});
+    world->emplace<WanderTarget>(e, WanderTarget{glm::vec2(0.f), 0u});
+
+    switch (strategy) {
+      case EnemyStrategy::BlitzNearestHero:
+        world->emplace<BlitzStrategyTag>(e);
+        break;
+      case EnemyStrategy::RespondIfProvoked:
+        world->emplace<RespondIfProvokedStrategyTag>(e);
+        break;
+      case EnemyStrategy::WanderLikeAChuckleFuck:
+      default:
+        world->emplace<WanderStrategyTag>(e);
+    }
+  }
+  return world;
+}
+
+void approach(glm::vec2 target, float speed, PositionComponent& pos,
+              OrientationComponent& orientation) {
+  glm::vec2 to_target = target - pos.map_position;
+  float len = glm::length(to_target);
+  glm::vec2 dir = to_target / glm::max(len, 0.001f);
+  orientation.radAngle = glm::atan(dir.x, dir.y);
+  pos.map_position += dir * glm::min(kDt * speed, len);
+}
+
+void provoked(RenderableComponent& renderable) {
+  renderable.animation = AnimationType::IDLE;
+}
+
+void blitz(PositionComponent& pos, OrientationComponent& orientation,
+           RenderableComponent& renderable) {
+  approach(kHeroPosition, 9.f, pos, orientation);
+  renderable.animation = AnimationType::RUN;
+}
+
+void wander(std::uint32_t seed, WanderTarget& target, PositionComponent& pos,
+            OrientationComponent& orientation,
+            RenderableComponent& renderable) {
+  if (glm::length(target.map_position - pos.map_position) < 0.5f) {
+    auto rng = igdemo::CounterRng::Of(seed);
+    target.map_position.x = rng.uniform(target.rng_offset * 2u, -50.f, 50.f);
+    target.map_position.y =
+        rng.uniform(target.rng_offset * 2u + 1u, -50.f, 50.f);
+    target.rng_offset++;
+  }
+  approach(target.map_position, 1.5f, pos, orientation);
+  renderable.animation = AnimationType::WALK;
+}
+
+void switch_frame(entt::registry& world) {
+  auto group = world.group<LegacyStrategyComponent>(
+      entt::get<PositionComponent, OrientationComponent>);
+  for (auto [e, strategy, pos, orientation] : group.each()) {
+    if (!world.all_of<RenderableComponent>(e)) {
+      continue;
+    }
+    auto& renderable = world.get<RenderableComponent>(e);
+    switch (strategy.strategy) {
+      case EnemyStrategy::RespondIfProvoked:
+        provoked(renderable);
+        break;
+      case EnemyStrategy::BlitzNearestHero:
+        blitz(pos, orientation, renderable);
+        break;
+      case EnemyStrategy::WanderLikeAChuckleFuck:
+      default:
+        wander(strategy.rngSeed, world.get<WanderTarget>(e), pos,
+               orientation, renderable);
+    }
+  }
+}
+
+void tagged_frame(entt::registry& world) {
+  for (auto [e, pos, orientation, renderable] :
+       world
+           .group<RespondIfProvokedStrategyTag>(
+               entt::get<PositionComponent, OrientationComponent,
+                         RenderableComponent>)
+           .each()) {
+    provoked(renderable);
+  }
+
+  for (auto [e, pos, orientation, renderable] :
+       world
+           .group<BlitzStrategyTag>(entt::get<PositionComponent,
+                                              OrientationComponent,
+                                              RenderableComponent>)
+           .each()) {
+    blitz(pos, orientation, renderable);
+  }
+
+  for (auto [e, strategy, pos, orientation, renderable] :
+       world
+           .group<WanderStrategyTag>(
+               entt::get<EnemyStrategyComponent, PositionComponent,
+                         OrientationComponent, RenderableComponent>)
+           .each()) {
+    wander(strategy.rngSeed, world.get<WanderTarget>(e), pos, orientation,
+           renderable);
+  }
+}
+
+template <typename FrameFnT>
+double time_frames(std::uint32_t frame_count, FrameFnT&& frame) {
+  for (std::uint32_t i = 0; i < 5; i++) {
+    frame();
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (std::uint32_t i = 0; i < frame_count; i++) {
+    frame();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         frame_count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::uint32_t frame_count = argc > 1 ? std::atoi(argv[1]) : 200;
+
+  std::cout << "Enemy strategy dispatch: " << frame_count << " frames\n\n";
+  std::cout << std::setw(10) << "enemies" << std::setw(12) << "switch_ms"
+            << std::setw(12) << "tagged_ms" << std::setw(12) << "speedup"
+            << "\n";
+
+  for (std::uint32_t entity_count : {1000u, 10000u, 100000u}) {
+    // Separate worlds - both paths start from the same positions
+    auto switch_world = make_world(entity_count);
+    auto tagged_world = make_world(entity_count);
+
+    double switch_ms =
+        time_frames(frame_count, [&] { switch_frame(*switch_world); });
+    double tagged_ms =
+        time_frames(frame_count, [&] { tagged_frame(*tagged_world); });
+
+    std::cout << std::fixed << std::setprecision(3) << std::setw(10)
+              << entity_count << std::setw(12) << switch_ms << std::setw(12)
+              << tagged_ms << std::setw(12) << switch_ms / tagged_ms << "\n";
+  }
+
+  return 0;
+}
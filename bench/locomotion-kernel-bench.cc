@@ -0,0 +1,162 @@
+/**
+ * World transform benchmark - LocomotionSystem's transform math, over the
+ *  locomotion owning group of an entt registry.
+ *
+ * - glm: per entity, build scale, rotate and translate matrices and multiply
+ *    them (the LocomotionSystem path before batching)
+ * - batched: gather the group into a LocomotionBatch and build transforms
+ *    with igdemo::compute_world_transforms
+ *
+ * at 1k, 10k and 100k entities. Both include writing the transforms back into
+ *  WorldTransformComponent.
+ *
+ * Usage: igdemo-locomotion-bench [frames]
+ */
+
+#include <igdemo/logic/locomotion-kernel.h>
+#include <igdemo/logic/locomotion.h>
+#include <igdemo/render/world-transform-component.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <entt/entt.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/transform.hpp>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+using igdemo::OrientationComponent;
+using igdemo::PositionComponent;
+using igdemo::ScaleComponent;
+using igdemo::WorldTransformComponent;
+
+std::unique_ptr<entt::registry> make_world(std::uint32_t entity_count) {
+  auto world = std::make_unique<entt::registry>();
+  world->group<PositionComponent, OrientationComponent, ScaleComponent,
+               WorldTransformComponent>();
+
+  std::mt19937 rng(entity_count);
+  std::uniform_real_distribution<float> pos_dist(-50.f, 50.f);
+  std::uniform_real_distribution<float> angle_dist(-3.14159f, 3.14159f);
+  for (std::uint32_t i = 0; i < entity_count; i++) {
+    auto e = world->create();
+    world->emplace<PositionComponent>(
+        e, glm::vec2(pos_dist(rng), pos_dist(rng)));
+    world->emplace<OrientationComponent>(e, angle_dist(rng));
+    world->emplace<ScaleComponent>(e, 1.f);
+    world->emplace<WorldTransformComponent>(e, glm::mat4(1.f));
+  }
+  return world;
+}
+
+auto locomotion_group(entt::registry& world) {
+  return world.group<PositionComponent, OrientationComponent, ScaleComponent,
+                     WorldTransformComponent>();
+}
+
+void glm_frame(entt::registry& world) {
+  for (auto [e, p, o, r, wt] : locomotion_group(world).each()) {
+    glm::mat4 matScl = glm::scale(glm::vec3(r.scale));
+    glm::mat4 matRot = glm::rotate(o.radAngle, glm::vec3(0.f, 1.f, 0.f));
+    glm::mat4 matPos =
+        glm::translate(glm::vec3(p.map_position.x, 0.f, p.map_position.y));
+    wt.worldTransform = matPos * matRot * matScl;
+  }
+}
+
+void batched_frame(entt::registry& world, igdemo::LocomotionBatch& batch,
+                   std::vector<WorldTransformComponent*>& outputs,
+                   std::vector<glm::mat4>& transforms) {
+  batch.clear();
+  outputs.clear();
+  for (auto [e, p, o, r, wt] : locomotion_group(world).each()) {
+    batch.push(p.map_position, o.radAngle, r.scale);
+    outputs.push_back(&wt);
+  }
+
+  transforms.resize(batch.size());
+  igdemo::compute_world_transforms(batch, transforms.data());
+
+  for (std::size_t i = 0; i < outputs.size(); i++) {
+    outputs[i]->worldTransform = transforms[i];
+  }
+}
+
+template <typename FrameFnT>
+double time_frames(std::uint32_t frame_count, FrameFnT&& frame) {
+  for (std::uint32_t i = 0; i < 5; i++) {
+    frame();
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (std::uint32_t i = 0; i < frame_count; i++) {
+    frame();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         frame_count;
+}
+
+float max_difference(const std::vector<glm::mat4>& a,
+                     const std::vector<glm::mat4>& b) {
+  float diff = 0.f;
+  for (std::size_t i = 0; i < a.size(); i++) {
+    for (int col = 0; col < 4; col++) {
+      for (int row = 0; row < 4; row++) {
+        diff = std::max(diff, std::abs(a[i][col][row] - b[i][col][row]));
+      }
+    }
+  }
+  return diff;
+}
+
+std::vector<glm::mat4> read_transforms(entt::registry& world) {
+  std::vector<glm::mat4> rsl;
+  for (auto [e, p, o, r, wt] : locomotion_group(world).each()) {
+    rsl.push_back(wt.worldTransform);
+  }
+  return rsl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::uint32_t frame_count = argc > 1 ? std::atoi(argv[1]) : 200;
+
+  std::cout << "World transforms: " << frame_count << " frames\n\n";
+  std::cout << std::setw(10) << "entities" << std::setw(12) << "glm_ms"
+            << std::setw(14) << "batched_ms" << std::setw(12) << "speedup"
+            << std::setw(14) << "max_diff"
+            << "\n";
+
+  for (std::uint32_t entity_count : {1000u, 10000u, 100000u}) {
+    auto world = make_world(entity_count);
+    igdemo::LocomotionBatch batch;
+    std::vector<WorldTransformComponent*> outputs;
+    std::vector<glm::mat4> transforms;
+
+    double glm_ms = time_frames(frame_count, [&] { glm_frame(*world); });
+    auto glm_transforms = read_transforms(*world);
+
+    double batched_ms = time_frames(frame_count, [&] {
+      batched_frame(*world, batch, outputs, transforms);
+    });
+    auto batched_transforms = read_transforms(*world);
+
+    std::cout << std::fixed << std::setprecision(3) << std::setw(10)
+              << entity_count << std::setw(12) << glm_ms << std::setw(14)
+              << batched_ms << std::setw(12) << glm_ms / batched_ms
+              << std::setw(14) << std::scientific << std::setprecision(2)
+              << max_difference(glm_transforms, batched_transforms) << "\n";
+  }
+
+  return 0;
+}
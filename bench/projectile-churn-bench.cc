@@ -0,0 +1,140 @@
+/**
+ * Projectile churn benchmark - a steady state of short-lived projectiles,
+ *  with a fixed number spawned (and about as many expiring) every frame.
+ *
+ * - registry: one entity per projectile, with position, velocity and
+ *    lifetime components (the layout before ProjectilePool). Spawning creates
+ *    an entity, expiring destroys it.
+ * - pool: ProjectilePool - spawning pushes to each array, integrate moves and
+ *    ages every projectile, expiring is a swap-remove.
+ *
+ * Usage: igdemo-projectile-churn-bench [frames]
+ */
+
+#include <igdemo/logic/projectile-pool.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using igdemo::EvtSpawnProjectile;
+using igdemo::ProjectilePool;
+using igdemo::ProjectileSource;
+
+const float kDt = 1.f / 60.f;
+
+// Long enough that the live count settles at spawns_per_frame * 60
+const float kLifetime = 1.f;
+
+// Per-entity projectile components, as the registry layout used to store them
+struct Position {
+  glm::vec2 map_position;
+};
+
+struct Velocity {
+  glm::vec2 velocity;
+};
+
+struct Lifetime {
+  float timeRemaining;
+};
+
+EvtSpawnProjectile make_spawn(std::uint32_t i) {
+  float fi = static_cast<float>(i % 1024u);
+  return EvtSpawnProjectile{glm::vec2(fi, -fi), glm::vec2(1.f, 0.5f),
+                            kLifetime,
+                            (i & 1u) ? ProjectileSource::Hero
+                                     : ProjectileSource::Enemy};
+}
+
+struct RegistryChurn {
+  entt::registry world;
+  std::vector<entt::entity> expired;
+  std::uint32_t spawned = 0u;
+
+  void frame(std::uint32_t spawns_per_frame) {
+    for (std::uint32_t i = 0u; i < spawns_per_frame; i++) {
+      auto spawn = make_spawn(spawned++);
+      auto e = world.create();
+      world.emplace<Position>(e, spawn.position);
+      world.emplace<Velocity>(e, spawn.velocity);
+      world.emplace<Lifetime>(e, spawn.lifetime);
+    }
+
+    expired.clear();
+    auto view = world.view<Position, const Velocity, Lifetime>();
+    for (auto [e, pos, vel, lifetime] : view.each()) {
+      pos.map_position += vel.velocity * kDt;
+      lifetime.timeRemaining -= kDt;
+      if (lifetime.timeRemaining <= 0.f) {
+        expired.push_back(e);
+      }
+    }
+    world.destroy(expired.begin(), expired.end());
+  }
+};
+
+struct PoolChurn {
+  ProjectilePool pool;
+  std::uint32_t spawned = 0u;
+
+  void frame(std::uint32_t spawns_per_frame) {
+    for (std::uint32_t i = 0u; i < spawns_per_frame; i++) {
+      pool.spawn(make_spawn(spawned++));
+    }
+    pool.integrate(kDt);
+    pool.remove_expired();
+  }
+};
+
+template <typename FrameFnT>
+double time_frames(std::uint32_t frame_count, FrameFnT&& frame) {
+  // Warm up past one lifetime, so the live count has settled
+  for (std::uint32_t i = 0; i < 90; i++) {
+    frame();
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (std::uint32_t i = 0; i < frame_count; i++) {
+    frame();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         frame_count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::uint32_t frame_count = argc > 1 ? std::atoi(argv[1]) : 200;
+
+  std::cout << "Projectile churn: " << frame_count << " frames\n\n";
+  std::cout << std::setw(12) << "spawns/frame" << std::setw(10) << "live"
+            << std::setw(14) << "registry_ms" << std::setw(12) << "pool_ms"
+            << std::setw(12) << "speedup"
+            << "\n";
+
+  for (std::uint32_t spawns_per_frame : {10u, 100u, 1000u}) {
+    RegistryChurn registry_churn;
+    PoolChurn pool_churn;
+
+    double registry_ms = time_frames(
+        frame_count, [&] { registry_churn.frame(spawns_per_frame); });
+    double pool_ms =
+        time_frames(frame_count, [&] { pool_churn.frame(spawns_per_frame); });
+
+    std::cout << std::fixed << std::setprecision(3) << std::setw(12)
+              << spawns_per_frame << std::setw(10) << pool_churn.pool.size()
+              << std::setw(14) << registry_ms << std::setw(12) << pool_ms
+              << std::setw(12) << registry_ms / pool_ms << "\n";
+  }
+
+  return 0;
+}
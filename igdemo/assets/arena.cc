@@ -68,9 +68,11 @@ load_arena_resources(
         wv.attach<WorldTransformComponent>(e);
         wv.attach<StaticPbrModelBindGroup>(e, device, queue,
                                            ctxPipeline.model_bgl);
-        wv.attach<PositionComponent>(
-            e, glm::vec2(ctxLevelMeta.mapXMin + ctxLevelMeta.mapXRange / 2.f,
-                         ctxLevelMeta.mapZMin + ctxLevelMeta.mapZRange / 2.f));
+        const glm::vec2 center(
+            ctxLevelMeta.mapXMin + ctxLevelMeta.mapXRange / 2.f,
+            ctxLevelMeta.mapZMin + ctxLevelMeta.mapZRange / 2.f);
+        wv.attach<PositionComponent>(e, center);
+        wv.attach<PreviousPositionComponent>(e, center);
 
         return errors;
       },
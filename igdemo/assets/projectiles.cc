@@ -1,14 +1,14 @@
 #include <igasync/promise_combiner.h>
 #include <igdemo/assets/projectiles.h>
-#include <igdemo/logic/locomotion.h>
-#include <igdemo/logic/projectile.h>
+#include <igdemo/logic/projectile-pool.h>
 #include <igdemo/render/ctx-components.h>
 #include <igdemo/render/geo/sphere.h>
 #include <igdemo/render/static-pbr.h>
-#include <igdemo/render/world-transform-component.h>
 
 namespace igdemo {
 
+const float kProjectileScale = 0.35f;
+
 std::shared_ptr<igasync::Promise<std::vector<std::string>>>
 load_projectile_resources(
     const IgdemoProcTable& procs, entt::registry* r,
@@ -80,6 +80,7 @@ load_projectile_resources(
                 sphere,
                 basicEnemyProjectileMaterial,
                 basicHeroProjectileMaterial,
+                {},
             });
 
         return errors;
@@ -89,42 +90,33 @@ load_projectile_resources(
 
 igecs::WorldView::Decl ProjectileRenderUtil::decl() {
   return igecs::WorldView::Decl()
-      .ctx_reads<CtxProjectileRenderResources>()
+      .ctx_writes<CtxProjectileRenderResources>()
+      .ctx_reads<CtxProjectilePool>()
       .ctx_reads<CtxWgpuDevice>()
-      .ctx_reads<CtxStaticPbrPipeline>()
-      .reads<Projectile>()
-      .writes<ScaleComponent>()
-      .writes<WorldTransformComponent>()
-      .writes<StaticPbrInstance>()
-      .writes<OrientationComponent>()
-      .writes<StaticPbrModelBindGroup>();
+      .ctx_reads<CtxStaticPbrPipeline>();
 }
 
-bool ProjectileRenderUtil::has_render_resources(igecs::WorldView* wv,
-                                                entt::entity e) {
-  return wv->has<StaticPbrInstance>(e) && wv->has<WorldTransformComponent>(e) &&
-         wv->has<OrientationComponent>(e) && wv->has<ScaleComponent>(e) &&
-         wv->has<StaticPbrModelBindGroup>(e);
-}
+void ProjectileRenderUtil::reserve_model_bind_groups(igecs::WorldView* wv) {
+  const auto& pool = wv->ctx<CtxProjectilePool>().pool;
+  if (pool.size() == 0u) {
+    return;
+  }
 
-void ProjectileRenderUtil::attach_render_resources(igecs::WorldView* wv,
-                                                   entt::entity e) {
-  const auto& ctxResources = wv->ctx<CtxProjectileRenderResources>();
+  auto& ctxResources = wv->mut_ctx<CtxProjectileRenderResources>();
   const auto& ctxDevice = wv->ctx<CtxWgpuDevice>();
   const auto& shader = wv->ctx<CtxStaticPbrPipeline>();
 
-  const auto& projectile = wv->read<Projectile>(e);
-
-  wv->attach<StaticPbrInstance>(
-      e, StaticPbrInstance{((projectile.type == ProjectileSource::Hero)
-                                ? &ctxResources.basicHeroProjectileMaterial
-                                : &ctxResources.basicEnemyProjectileMaterial),
-                           &ctxResources.projectileSphereGeometry});
-  wv->attach<OrientationComponent>(e, OrientationComponent{0.f});
-  wv->attach<ScaleComponent>(e, ScaleComponent{0.35f});
-  wv->attach<WorldTransformComponent>(e);
-  wv->attach<StaticPbrModelBindGroup>(e, ctxDevice.device, ctxDevice.queue,
-                                      shader.model_bgl);
+  auto& bindGroups = ctxResources.modelBindGroups;
+  while (bindGroups.size() < pool.size()) {
+    bindGroups.emplace_back(ctxDevice.device, ctxDevice.queue,
+                            shader.model_bgl);
+  }
+}
+
+glm::mat4 ProjectileRenderUtil::world_transform(glm::vec2 map_position) {
+  glm::mat4 transform(kProjectileScale);
+  transform[3] = glm::vec4(map_position.x, 0.f, map_position.y, 1.f);
+  return transform;
 }
 
 }  // namespace igdemo
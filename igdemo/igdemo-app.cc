@@ -9,16 +9,25 @@
 #include <igdemo/logic/framecommon.h>
 #include <igdemo/logic/hero.h>
 #include <igdemo/logic/levelmetadata.h>
+#include <igdemo/logic/projectile-pool.h>
 #include <igdemo/platform/keyboard-mouse-input-emitter.h>
 #include <igdemo/render/camera.h>
 #include <igdemo/render/ctx-components.h>
+#include <igdemo/render/static-pbr.h>
+#include <igdemo/render/world-transform-component.h>
 #include <igdemo/scheduler.h>
 #include <igdemo/systems/animation.h>
+#include <igdemo/systems/destroy-actor.h>
+#include <igdemo/systems/enemy-locomotion.h>
+#include <igdemo/systems/frame-packet.h>
+#include <igdemo/systems/locomotion.h>
 #include <igdemo/systems/pbr-geo-pass.h>
+#include <igdemo/systems/projectile-hit.h>
 #include <igdemo/systems/update-spatial-index.h>
 
 #include <glm/gtc/constants.hpp>
 #include <random>
+#include <vector>
 
 namespace {
 
@@ -56,13 +65,27 @@ IgdemoApp::Create(iggpu::AppBase* app_base, IgdemoConfig config,
                   std::shared_ptr<igasync::TaskList> async_tasks) {
   auto registry = std::make_unique<entt::registry>();
 
+  // Change tracking is not set up on first use - writes expect it to exist,
+  //  and WorldViews look it up when they are created
+  igecs::track_changes<WorldTransformComponent>(*registry);
+  igecs::track_changes<StaticPbrModelBindGroup>(*registry);
+
   // Synchronous context setup for systems globals...
   auto wv = igecs::WorldView::Thin(registry.get());
   wv.attach_ctx<CtxWgpuDevice>(app_base->Device, app_base->Queue,
                                app_base->SurfaceFormat, nullptr);
   wv.attach_ctx<CtxGeneral3dBuffers>(app_base->Device, app_base->Queue);
   init_animation_systems(&wv);
+  init_frame_packet_systems(&wv);
   wv.attach_ctx<CtxFrameTime>();
+  // Event queues are otherwise created on first use, which is not safe if the
+  //  first events come from several partitions or parallel_each chunks at once
+  wv.attach_ctx<igecs::CtxEventQueue<EvtDestroyActor>>();
+  wv.attach_ctx<igecs::CtxEventQueue<EvtProjectileDamage>>();
+  wv.attach_ctx<igecs::CtxEventQueue<EvtSpawnProjectile>>();
+  wv.attach_ctx<CtxProjectilePool>();
+  init_locomotion_systems(&wv);
+  init_enemy_locomotion_systems(&wv);
   ::create_main_camera(&wv);
   wv.attach_ctx<CtxGeneralSceneParams>(
       CtxGeneralSceneParams{/* sunDirection */ glm::vec3(1.f, -4.f, 1.f),
@@ -89,6 +112,9 @@ IgdemoApp::Create(iggpu::AppBase* app_base, IgdemoConfig config,
     std::uniform_int_distribution<> hero_strategy_distribution(0, 1);
     std::uniform_real_distribution<> rot_distribution(0.f, 3.14159f * 2.f);
 
+    // Spawns are batched - thousands of enemies are created at start-up
+    std::vector<enemy::EnemySpawn> enemy_spawns;
+    enemy_spawns.reserve(config.numEnemyMobs);
     for (int i = 0; i < config.numEnemyMobs; i++) {
       glm::vec2 spawn_pos(x_pos_distribution(gen), z_pos_distribution(gen));
       float orientation = rot_distribution(gen);
@@ -108,10 +134,14 @@ IgdemoApp::Create(iggpu::AppBase* app_base, IgdemoConfig config,
           break;
       }
 
-      enemy::create_enemy_entity(&wv, strat, config.rngSeed + i, spawn_pos,
-                                 orientation, igdemo::ModelType::YBOT, 0.01f);
+      enemy_spawns.push_back(enemy::EnemySpawn{strat, config.rngSeed + i,
+                                               spawn_pos, orientation});
     }
+    enemy::create_enemy_entities(&wv, enemy_spawns, igdemo::ModelType::YBOT,
+                                 0.01f);
 
+    std::vector<HeroSpawn> hero_spawns;
+    hero_spawns.reserve(config.numHeroes);
     for (int i = 0; i < config.numHeroes; i++) {
       glm::vec2 spawn_pos(x_pos_distribution(gen), z_pos_distribution(gen));
       float orientation = rot_distribution(gen);
@@ -128,9 +158,10 @@ IgdemoApp::Create(iggpu::AppBase* app_base, IgdemoConfig config,
           break;
       }
 
-      create_hero_entity(&wv, strat, config.rngSeed + i, spawn_pos, orientation,
-                         igdemo::ModelType::YBOT, 0.0175f);
+      hero_spawns.push_back(
+          HeroSpawn{strat, config.rngSeed + i, spawn_pos, orientation});
     }
+    create_hero_entities(&wv, hero_spawns, igdemo::ModelType::YBOT, 0.0175f);
   }
 
   // Load stuff from the network and initialize resources...
@@ -183,9 +214,18 @@ IgdemoApp::Create(iggpu::AppBase* app_base, IgdemoConfig config,
   auto skybox_load_errorskey =
       combiner->add(load_skybox_promise, main_thread_tasks);
 
+  std::shared_ptr<igecs::WorkStealingPool> ecs_worker_pool = nullptr;
+  if (config.multithreaded && config.useWorkStealingPool) {
+    ecs_worker_pool = igecs::WorkStealingPool::Create(
+        static_cast<std::uint32_t>(worker_thread_ids.size()));
+    worker_thread_ids = ecs_worker_pool->thread_ids();
+  }
+
   auto frame_execution_graph_key = combiner->add_consuming(
       main_thread_tasks->run(build_update_and_render_scheduler,
-                             worker_thread_ids),
+                             worker_thread_ids,
+                             config.inferSystemDependencies,
+                             config.pipelineFrames, config.simulationTickRate),
       main_thread_tasks);
 
   auto projectiles_promise = load_projectile_resources(
@@ -205,8 +245,8 @@ IgdemoApp::Create(iggpu::AppBase* app_base, IgdemoConfig config,
   return combiner->combine(
       [config, proc_table, reg_promise_key, ybot_load_errors_key,
        shaders_load_errorskey, skybox_load_errorskey, frame_execution_graph_key,
-       arena_load_errorskey, app_base, main_thread_tasks,
-       async_tasks](igasync::PromiseCombiner::Result rsl)
+       arena_load_errorskey, app_base, main_thread_tasks, async_tasks,
+       ecs_worker_pool](igasync::PromiseCombiner::Result rsl)
           -> std::variant<std::unique_ptr<IgdemoApp>, IgdemoLoadError> {
         const auto& ybot_load_errors = rsl.get(ybot_load_errors_key);
         const auto& shader_load_errors = rsl.get(shaders_load_errorskey);
@@ -240,7 +280,7 @@ IgdemoApp::Create(iggpu::AppBase* app_base, IgdemoConfig config,
         auto app = std::unique_ptr<IgdemoApp>(
             new IgdemoApp(config, proc_table, std::move(registry),
                           std::move(frame_execution_graph), app_base,
-                          main_thread_tasks, async_tasks));
+                          main_thread_tasks, async_tasks, ecs_worker_pool));
         return app;
       },
       main_thread_tasks);
@@ -256,10 +296,16 @@ void IgdemoApp::update_and_render(float dt) {
   app_base_->Surface.GetCurrentTexture(&surfaceTexture);
   wv.mut_ctx<CtxWgpuDevice>().renderTarget =
       surfaceTexture.texture.CreateView();
-  wv.mut_ctx<CtxFrameTime>().secondsSinceLastFrame = dt;
+  frame_execution_graph_.advance_time(
+      std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+          std::chrono::duration<float>(dt)));
 
   // Execute frame graph...
-  frame_execution_graph_.execute(async_tasks_, r_.get());
+  if (ecs_worker_pool_) {
+    frame_execution_graph_.execute(ecs_worker_pool_, r_.get());
+  } else {
+    frame_execution_graph_.execute(async_tasks_, r_.get());
+  }
 
   // Profiling...
   frame_id_++;
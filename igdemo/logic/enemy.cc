@@ -3,37 +3,68 @@
 #include <igdemo/logic/locomotion.h>
 #include <igdemo/logic/projectile.h>
 #include <igdemo/logic/renderable.h>
+#include <igecs/prefab.h>
 
 namespace igdemo::enemy {
 
+std::vector<entt::entity> create_enemy_entities(
+    igecs::WorldView* wv, std::span<const EnemySpawn> spawns,
+    ModelType modelType, float modelScale) {
+  igecs::Prefab<PositionComponent, PreviousPositionComponent,
+                OrientationComponent, HealthComponent, RenderableComponent,
+                ScaleComponent, EnemyTag, EnemyStrategyComponent,
+                ProjectileFireCooldown>
+      prefab(PositionComponent{}, PreviousPositionComponent{},
+             OrientationComponent{}, HealthComponent{100.f, 100.f},
+             RenderableComponent{modelType, MaterialType::RED,
+                                 AnimationType::IDLE},
+             ScaleComponent{modelScale}, EnemyTag{}, EnemyStrategyComponent{},
+             ProjectileFireCooldown{.maxAllowed = 12,
+                                    .currentStored = 12,
+                                    .mainCd = 2.5f,
+                                    .secondaryCd = 0.85f,
+                                    .mainCdRemaining = 0.f,
+                                    .secondaryCdRemaining = 0.f});
+
+  std::vector<entt::entity> entities(spawns.size());
+  prefab.spawn(wv, entities, [spawns](std::size_t i, auto& enemy) {
+    std::get<PositionComponent>(enemy).map_position = spawns[i].startPos;
+    std::get<PreviousPositionComponent>(enemy).map_position =
+        spawns[i].startPos;
+    std::get<OrientationComponent>(enemy).radAngle =
+        spawns[i].startOrientation;
+    std::get<EnemyStrategyComponent>(enemy).rngSeed = spawns[i].rngSeed;
+  });
+
+  // Strategy tags differ between enemies - one batch per strategy
+  std::vector<entt::entity> wandering, blitzing, provoked;
+  for (std::size_t i = 0u; i < spawns.size(); i++) {
+    switch (spawns[i].strategy) {
+      case EnemyStrategy::BlitzNearestHero:
+        blitzing.push_back(entities[i]);
+        break;
+      case EnemyStrategy::RespondIfProvoked:
+        provoked.push_back(entities[i]);
+        break;
+      case EnemyStrategy::WanderLikeAChuckleFuck:
+      default:
+        wandering.push_back(entities[i]);
+    }
+  }
+  wv->insert<WanderStrategyTag>(wandering.begin(), wandering.end());
+  wv->insert<BlitzStrategyTag>(blitzing.begin(), blitzing.end());
+  wv->insert<RespondIfProvokedStrategyTag>(provoked.begin(), provoked.end());
+
+  return entities;
+}
+
 entt::entity create_enemy_entity(igecs::WorldView* wv,
                                  EnemyStrategy enemyStrategy,
                                  std::uint32_t rngSeed, glm::vec2 startPos,
                                  float startOrientation, ModelType modelType,
                                  float modelScale) {
-  auto e = wv->create();
-
-  wv->attach<PositionComponent>(e, PositionComponent{startPos});
-  wv->attach<OrientationComponent>(e, OrientationComponent{startOrientation});
-
-  wv->attach<HealthComponent>(e, HealthComponent{100.f, 100.f});
-
-  wv->attach<RenderableComponent>(
-      e,
-      RenderableComponent{modelType, MaterialType::RED, AnimationType::IDLE});
-  wv->attach<ScaleComponent>(e, modelScale);
-  wv->attach<EnemyTag>(e);
-  wv->attach<EnemyStrategyComponent>(
-      e, EnemyStrategyComponent{enemyStrategy, rngSeed});
-  wv->attach<ProjectileFireCooldown>(
-      e, ProjectileFireCooldown{.maxAllowed = 12,
-                                .currentStored = 12,
-                                .mainCd = 2.5f,
-                                .secondaryCd = 0.85f,
-                                .mainCdRemaining = 0.f,
-                                .secondaryCdRemaining = 0.f});
-
-  return e;
+  const EnemySpawn spawn{enemyStrategy, rngSeed, startPos, startOrientation};
+  return create_enemy_entities(wv, {&spawn, 1u}, modelType, modelScale)[0];
 }
 
 }  // namespace igdemo::enemy
@@ -3,34 +3,48 @@
 #include <igdemo/logic/locomotion.h>
 #include <igdemo/logic/projectile.h>
 #include <igdemo/logic/renderable.h>
+#include <igecs/prefab.h>
 
 namespace igdemo {
 
+std::vector<entt::entity> create_hero_entities(
+    igecs::WorldView* wv, std::span<const HeroSpawn> spawns,
+    ModelType modelType, float modelScale) {
+  igecs::Prefab<PositionComponent, PreviousPositionComponent,
+                OrientationComponent, HealthComponent, RenderableComponent,
+                ScaleComponent, HeroTag, HeroStrategyComponent,
+                ProjectileFireCooldown>
+      prefab(PositionComponent{}, PreviousPositionComponent{},
+             OrientationComponent{}, HealthComponent{500.f, 500.f},
+             RenderableComponent{modelType, MaterialType::GREEN,
+                                 AnimationType::IDLE},
+             ScaleComponent{modelScale}, HeroTag{}, HeroStrategyComponent{},
+             ProjectileFireCooldown{.maxAllowed = 4,
+                                    .currentStored = 4,
+                                    .mainCd = 1.25f,
+                                    .secondaryCd = 0.45f,
+                                    .mainCdRemaining = 0.f,
+                                    .secondaryCdRemaining = 0.f});
+
+  std::vector<entt::entity> entities(spawns.size());
+  prefab.spawn(wv, entities, [spawns](std::size_t i, auto& hero) {
+    std::get<PositionComponent>(hero).map_position = spawns[i].startPos;
+    std::get<PreviousPositionComponent>(hero).map_position =
+        spawns[i].startPos;
+    std::get<OrientationComponent>(hero).radAngle = spawns[i].startOrientation;
+    std::get<HeroStrategyComponent>(hero) =
+        HeroStrategyComponent{spawns[i].strategy, spawns[i].rngSeed};
+  });
+
+  return entities;
+}
+
 entt::entity create_hero_entity(igecs::WorldView* wv, HeroStrategy heroStrategy,
                                 std::uint32_t rngSeed, glm::vec2 startPos,
                                 float startOrientation, ModelType modelType,
                                 float modelScale) {
-  auto e = wv->create();
-
-  wv->attach<PositionComponent>(e, PositionComponent{startPos});
-  wv->attach<OrientationComponent>(e, OrientationComponent{startOrientation});
-  wv->attach<HealthComponent>(e, HealthComponent{500.f, 500.f});
-  wv->attach<RenderableComponent>(
-      e,
-      RenderableComponent{modelType, MaterialType::GREEN, AnimationType::IDLE});
-  wv->attach<ScaleComponent>(e, ScaleComponent{modelScale});
-  wv->attach<HeroTag>(e);
-  wv->attach<HeroStrategyComponent>(
-      e, HeroStrategyComponent{heroStrategy, rngSeed});
-  wv->attach<ProjectileFireCooldown>(
-      e, ProjectileFireCooldown{.maxAllowed = 4,
-                                .currentStored = 4,
-                                .mainCd = 1.25f,
-                                .secondaryCd = 0.45f,
-                                .mainCdRemaining = 0.f,
-                                .secondaryCdRemaining = 0.f});
-
-  return e;
+  const HeroSpawn spawn{heroStrategy, rngSeed, startPos, startOrientation};
+  return create_hero_entities(wv, {&spawn, 1u}, modelType, modelScale)[0];
 }
 
 }  // namespace igdemo
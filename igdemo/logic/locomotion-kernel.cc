@@ -0,0 +1,121 @@
+#include <igdemo/logic/locomotion-kernel.h>
+#include <igdemo/logic/simd4.h>
+
+#include <cstdint>
+
+namespace {
+
+using namespace igdemo::simd4;
+
+// Cody-Waite split of pi/2 - qf * kPiOver2A is exact for the quadrant counts
+//  angles in this game reach
+const float kTwoOverPi = 0.636619772367581343f;
+const float kPiOver2A = 1.5703125f;
+const float kPiOver2B = 4.837512969970703125e-4f;
+const float kPiOver2C = 7.54978995489188216e-8f;
+
+// Minimax polynomials over [-pi/4, pi/4] (Cephes sinf/cosf)
+const float kSin1 = -1.6666654611e-1f;
+const float kSin2 = 8.3321608736e-3f;
+const float kSin3 = -1.9515295891e-4f;
+const float kCos1 = 4.166664568298827e-2f;
+const float kCos2 = -1.388731625493765e-3f;
+const float kCos3 = 2.443315711809948e-5f;
+
+// sin and cos of four angles at once - reduced to [-pi/4, pi/4] by quadrant
+void sincos4(F4 x, F4* out_sin, F4* out_cos) {
+  const I4 q = round_to_int(mul(x, splat(kTwoOverPi)));
+  const F4 qf = to_float(q);
+  F4 y = sub(x, mul(qf, splat(kPiOver2A)));
+  y = sub(y, mul(qf, splat(kPiOver2B)));
+  y = sub(y, mul(qf, splat(kPiOver2C)));
+
+  const F4 y2 = mul(y, y);
+  F4 s = add(splat(kSin2), mul(y2, splat(kSin3)));
+  s = add(splat(kSin1), mul(y2, s));
+  s = add(y, mul(mul(y, y2), s));
+
+  F4 c = add(splat(kCos2), mul(y2, splat(kCos3)));
+  c = add(splat(kCos1), mul(y2, c));
+  c = add(sub(splat(1.f), mul(y2, splat(0.5f))), mul(mul(y2, y2), c));
+
+  // Odd quadrants swap sin and cos, quadrants 2-3 negate sin, 1-2 negate cos
+  const M4 swap = bit_set(q, 1);
+  *out_sin = negate_if(bit_set(q, 2), select(swap, c, s));
+  *out_cos = negate_if(bit_set(increment(q), 2), select(swap, s, c));
+}
+
+// translate(x, 0, z) * rotate(angle, +Y) * scale(s)
+void write_transform(float x, float z, float s, float scaled_sin,
+                     float scaled_cos, glm::mat4* out) {
+  (*out)[0] = glm::vec4(scaled_cos, 0.f, -scaled_sin, 0.f);
+  (*out)[1] = glm::vec4(0.f, s, 0.f, 0.f);
+  (*out)[2] = glm::vec4(scaled_sin, 0.f, scaled_cos, 0.f);
+  (*out)[3] = glm::vec4(x, 0.f, z, 1.f);
+}
+
+void compute_four(const float* x, const float* z, const float* angle,
+                  const float* scale, glm::mat4* out) {
+  F4 angle_sin, angle_cos;
+  sincos4(load(angle), &angle_sin, &angle_cos);
+
+  const F4 s = load(scale);
+  alignas(16) float scaled_sin[4];
+  alignas(16) float scaled_cos[4];
+  store(scaled_sin, mul(s, angle_sin));
+  store(scaled_cos, mul(s, angle_cos));
+
+  for (int i = 0; i < 4; i++) {
+    write_transform(x[i], z[i], scale[i], scaled_sin[i], scaled_cos[i],
+                    out + i);
+  }
+}
+
+}  // namespace
+
+namespace igdemo {
+
+void LocomotionBatch::clear() {
+  x.clear();
+  z.clear();
+  angle.clear();
+  scale.clear();
+}
+
+void LocomotionBatch::push(glm::vec2 map_position, float rad_angle,
+                           float uniform_scale) {
+  x.push_back(map_position.x);
+  z.push_back(map_position.y);
+  angle.push_back(rad_angle);
+  scale.push_back(uniform_scale);
+}
+
+void compute_world_transforms(const LocomotionBatch& batch, glm::mat4* out) {
+  const std::size_t count = batch.size();
+  const std::size_t full_count = count - count % 4u;
+
+  std::size_t i = 0u;
+  for (; i < full_count; i += 4u) {
+    compute_four(&batch.x[i], &batch.z[i], &batch.angle[i], &batch.scale[i],
+                 out + i);
+  }
+
+  // Tail is padded out to a full lane group
+  if (i < count) {
+    float x[4]{}, z[4]{}, angle[4]{}, scale[4]{};
+    glm::mat4 tail[4];
+    const std::size_t tail_count = count - i;
+    for (std::size_t j = 0u; j < tail_count; j++) {
+      x[j] = batch.x[i + j];
+      z[j] = batch.z[i + j];
+      angle[j] = batch.angle[i + j];
+      scale[j] = batch.scale[i + j];
+    }
+    compute_four(x, z, angle, scale, tail);
+    for (std::size_t j = 0u; j < tail_count; j++) {
+      out[i + j] = tail[j];
+    }
+  }
+}
+
+}  // namespace igdemo
@@ -0,0 +1,73 @@
+#include <igdemo/logic/projectile-pool.h>
+#include <igdemo/logic/simd4.h>
+
+namespace igdemo {
+
+void ProjectilePool::spawn(const EvtSpawnProjectile& spawn) {
+  x_.push_back(spawn.position.x);
+  z_.push_back(spawn.position.y);
+  prev_x_.push_back(spawn.position.x);
+  prev_z_.push_back(spawn.position.y);
+  vx_.push_back(spawn.velocity.x);
+  vz_.push_back(spawn.velocity.y);
+  lifetime_.push_back(spawn.lifetime);
+  source_.push_back(spawn.source);
+}
+
+void ProjectilePool::integrate(float dt) {
+  using namespace simd4;
+
+  const std::uint32_t count = size();
+  const std::uint32_t full_count = count - count % 4u;
+  const F4 dt4 = splat(dt);
+
+  std::uint32_t i = 0u;
+  for (; i < full_count; i += 4u) {
+    const F4 x = load(&x_[i]);
+    const F4 z = load(&z_[i]);
+    store(&prev_x_[i], x);
+    store(&prev_z_[i], z);
+    store(&x_[i], add(x, mul(load(&vx_[i]), dt4)));
+    store(&z_[i], add(z, mul(load(&vz_[i]), dt4)));
+    store(&lifetime_[i], sub(load(&lifetime_[i]), dt4));
+  }
+  for (; i < count; i++) {
+    prev_x_[i] = x_[i];
+    prev_z_[i] = z_[i];
+    x_[i] += vx_[i] * dt;
+    z_[i] += vz_[i] * dt;
+    lifetime_[i] -= dt;
+  }
+}
+
+void ProjectilePool::remove_expired() {
+  std::uint32_t count = size();
+  for (std::uint32_t i = 0u; i < count;) {
+    if (lifetime_[i] > 0.f) {
+      i++;
+      continue;
+    }
+
+    // The moved projectile has not been checked yet - stay at i
+    count--;
+    x_[i] = x_[count];
+    z_[i] = z_[count];
+    prev_x_[i] = prev_x_[count];
+    prev_z_[i] = prev_z_[count];
+    vx_[i] = vx_[count];
+    vz_[i] = vz_[count];
+    lifetime_[i] = lifetime_[count];
+    source_[i] = source_[count];
+  }
+
+  x_.resize(count);
+  z_.resize(count);
+  prev_x_.resize(count);
+  prev_z_.resize(count);
+  vx_.resize(count);
+  vz_.resize(count);
+  lifetime_.resize(count);
+  source_.resize(count);
+}
+
+}  // namespace igdemo
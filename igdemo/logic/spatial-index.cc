@@ -107,6 +107,12 @@ std::vector<entt::entity> GridIndex::collisions(igecs::WorldView* wv,
                                                 glm::vec2 pos,
                                                 float radius) const {
   std::vector<entt::entity> collidingEntities;
+  collisions(wv, pos, radius, collidingEntities);
+  return collidingEntities;
+}
+
+void GridIndex::collisions(igecs::WorldView* wv, glm::vec2 pos, float radius,
+                           std::vector<entt::entity>& out) const {
   int startX, startZ;
   get_grid_cells(pos, startX, startZ);
 
@@ -128,13 +134,11 @@ std::vector<entt::entity> GridIndex::collisions(igecs::WorldView* wv,
         const auto& data = wv->read<GridIndexDataComponent>(entry);
         auto dist = glm::length2(data.pos - pos);
         if (dist <= (radius + data.radius) * (radius + data.radius)) {
-          collidingEntities.push_back(entry);
+          out.push_back(entry);
         }
       }
     }
   }
-
-  return collidingEntities;
 }
 
 const GridIndex::CellContents& GridIndex::get_cell(int xGrid, int zGrid) const {
@@ -12,6 +12,10 @@ using FpSeconds = std::chrono::duration<float, std::chrono::seconds::period>;
 int main(int argc, char** argv) {
   bool singlethreaded;
   int thread_count;
+  bool work_stealing;
+  bool infer_deps;
+  bool pipeline_frames;
+  std::uint32_t tick_rate;
   std::uint32_t rng_seed;
   std::uint32_t num_enemy_mobs;
   std::uint32_t num_heroes;
@@ -34,6 +38,21 @@ int main(int argc, char** argv) {
            "--threadcount", thread_count,
            "Number of threads to use (or 0 to use hardware_concurrency)")
         ->default_val(0);
+    cli.add_option("--work_stealing", work_stealing,
+                   "Run ECS worker tasks on a work stealing thread pool")
+        ->default_val(false);
+    cli.add_option("--infer_deps", infer_deps,
+                   "Derive ECS system dependencies from system declarations")
+        ->default_val(false);
+    cli.add_option("--pipeline_frames", pipeline_frames,
+                   "Render the previous frame while running logic for the "
+                   "current one (adds a frame of latency)")
+        ->default_val(false);
+    cli.add_option("--tick_rate", tick_rate,
+                   "Simulation ticks per second (or 0 to run simulation once "
+                   "per frame)")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
     cli.add_option("--seed", rng_seed,
                    "Seed value for random number generation")
         ->default_val(std::chrono::high_resolution_clock::now()
@@ -80,6 +99,10 @@ int main(int argc, char** argv) {
   igdemo::IgdemoConfig config{};
   config.multithreaded = !singlethreaded;
   config.threadCountOverride = thread_count;
+  config.useWorkStealingPool = work_stealing;
+  config.inferSystemDependencies = infer_deps;
+  config.pipelineFrames = pipeline_frames;
+  config.simulationTickRate = tick_rate;
   config.numEnemyMobs = num_enemy_mobs;
   config.numHeroes = num_heroes;
   config.numWarmupFrames = warmup_frame_count;
@@ -1,3 +1,4 @@
+#include <igdemo/logic/framecommon.h>
 #include <igdemo/logic/locomotion.h>
 #include <igdemo/scheduler.h>
 #include <igdemo/systems/animation.h>
@@ -5,6 +6,7 @@
 #include <igdemo/systems/destroy-actor.h>
 #include <igdemo/systems/enemy-locomotion.h>
 #include <igdemo/systems/fly-camera.h>
+#include <igdemo/systems/frame-packet.h>
 #include <igdemo/systems/hero-locomotion.h>
 #include <igdemo/systems/locomotion.h>
 #include <igdemo/systems/move-projectile.h>
@@ -16,52 +18,178 @@
 #include <igdemo/systems/update-health.h>
 #include <igdemo/systems/update-spatial-index.h>
 
+#include <iostream>
+#include <optional>
+
 namespace igdemo {
 
 igecs::Scheduler build_update_and_render_scheduler(
-    const std::vector<std::thread::id>& worker_thread_ids) {
+    const std::vector<std::thread::id>& worker_thread_ids,
+    bool infer_dependencies, bool pipeline_frames,
+    std::uint32_t simulation_tick_rate) {
   auto builder = igecs::Scheduler::Builder("IgDemo Frame");
   builder.main_thread_id(std::this_thread::get_id());
   builder.max_spin_time(std::chrono::milliseconds(5000));
 
+  // When inferring, nodes are ordered against conflicting nodes by the order
+  //  they are added here - the depends_on() calls below are kept as the
+  //  hand-written graph to compare against.
+  builder.infer_dependencies(infer_dependencies);
+
   for (int i = 0; i < worker_thread_ids.size(); i++) {
     builder.worker_thread_id(worker_thread_ids[i]);
   }
 
-  auto hero_locomotion = builder.add_node().build<HeroLocomotionSystem>();
+  // Simulation systems (marked fixed_tick) run at a fixed rate, everything
+  //  else runs once per frame. Each run gets its time step through
+  //  CtxFrameTime - per-frame systems that neither read it nor touch
+  //  simulation state (the pipelined present and render passes) run while the
+  //  simulation ticks.
+  if (simulation_tick_rate > 0u) {
+    using Duration = std::chrono::high_resolution_clock::duration;
+    builder.fixed_tick(std::chrono::duration_cast<Duration>(
+        std::chrono::duration<double>(1.0 / simulation_tick_rate)));
+  }
+  builder.on_tick(
+      [](entt::registry* world, const igecs::Scheduler::TickInfo& tick) {
+        auto wv = igecs::WorldView::Thin(world);
+        auto& frameTime = wv.mut_ctx<CtxFrameTime>();
+        frameTime.secondsSinceLastFrame = tick.dt_seconds;
+        frameTime.tickIndex = tick.tick_index;
+        frameTime.interpolationAlpha = tick.interpolation_alpha;
+      },
+      igecs::WorldView::Decl().ctx_writes<CtxFrameTime>());
+
+  // Render systems only read from the frame packet handed over by the
+  //  present node, so they never conflict with logic systems. Same-frame
+  //  rendering presents right after extract, pipelined rendering presents
+  //  the previous frame's packet at the start of the frame so that encoding
+  //  render passes on the main thread overlaps with logic on workers.
+  //
+  // Nodes are added in the order they should run in, for inference's sake.
+  auto add_render_nodes = [&builder](const igecs::Scheduler::Node& present) {
+    auto pbr_upload_scene_buffers = builder.add_node()
+                                        .main_thread_only()
+                                        .depends_on(present)
+                                        .build<PbrUploadSceneBuffersSystem>();
+
+    auto pbr_upload_instance_buffers =
+        builder.add_node()
+            .main_thread_only()
+            .depends_on(present)
+            .build<PbrUploadPerInstanceBuffersSystem>();
+
+    auto skybox_pass = builder.add_node()
+                           .main_thread_only()
+                           .depends_on(pbr_upload_scene_buffers)
+                           .build<SkyboxRenderSystem>();
+
+    auto pbr_geo_pass = builder.add_node()
+                            .main_thread_only()
+                            .depends_on(pbr_upload_scene_buffers)
+                            .depends_on(pbr_upload_instance_buffers)
+                            .depends_on(skybox_pass)
+                            .build<PbrGeoPassSystem>();
+
+    auto tonemapping_pass = builder.add_node()
+                                .main_thread_only()
+                                .depends_on(pbr_geo_pass)
+                                .depends_on(skybox_pass)
+                                .build<TonemapPass>();
+  };
+
+  std::optional<igecs::Scheduler::Node> pipelined_present = {};
+  if (pipeline_frames) {
+    pipelined_present.emplace(builder.add_node()
+                                  .main_thread_only()
+                                  .build<PresentFramePacketSystem>());
+    add_render_nodes(*pipelined_present);
+  }
+
+  // Without a fixed tick rate, logic runs once per frame and there is no
+  //  previous tick to interpolate from (see LocomotionSystem)
+  std::optional<igecs::Scheduler::Node> snapshot_positions = {};
+  if (simulation_tick_rate > 0u) {
+    snapshot_positions.emplace(
+        builder.add_node().fixed_tick().build<SnapshotPositionsSystem>());
+  }
+
+  auto hero_locomotion_builder = builder.add_node();
+  hero_locomotion_builder.fixed_tick();
+  if (snapshot_positions) {
+    hero_locomotion_builder.depends_on(*snapshot_positions);
+  }
+  auto hero_locomotion = hero_locomotion_builder.build<HeroLocomotionSystem>();
+
+  // Systems that only write to the entities they iterate over (and defer any
+  //  structural changes) are split into one partition per thread
+  const auto thread_count =
+      static_cast<std::uint32_t>(worker_thread_ids.size()) + 1u;
 
-  auto enemy_locomotion = builder.add_node()
+  // Enemy strategies write the same component types, so they still run one
+  //  after the other - but each loops over its own storage, with no dispatch
+  auto provoked_enemies = builder.add_node()
+                              .fixed_tick()
                               .depends_on(hero_locomotion)
-                              .build<UpdateEnemiesSystem>();
+                              .partitioned(thread_count)
+                              .build<UpdateProvokedEnemiesSystem>();
+
+  auto blitzing_enemies = builder.add_node()
+                              .fixed_tick()
+                              .depends_on(provoked_enemies)
+                              .partitioned(thread_count)
+                              .build<UpdateBlitzingEnemiesSystem>();
+
+  auto wandering_enemies = builder.add_node()
+                               .fixed_tick()
+                               .depends_on(blitzing_enemies)
+                               .partitioned(thread_count)
+                               .build<UpdateWanderingEnemiesSystem>();
 
   auto spawn_projectiles = builder.add_node()
-                               .depends_on(enemy_locomotion)
+                               .fixed_tick()
+                               .depends_on(wandering_enemies)
+                               .partitioned(thread_count)
                                .build<SpawnProjectilesSystem>();
 
   auto update_projectiles = builder.add_node()
+                                .fixed_tick()
                                 .depends_on(spawn_projectiles)
                                 .build<MoveProjectileSystem>();
 
   auto locomotion = builder.add_node()
                         .depends_on(update_projectiles)
+                        .partitioned(thread_count)
                         .build<LocomotionSystem>();
 
   auto update_spatial_index = builder.add_node()
+                                  .fixed_tick()
                                   .depends_on(update_projectiles)
-                                  .depends_on(enemy_locomotion)
+                                  .depends_on(wandering_enemies)
                                   .main_thread_only()
                                   .build<UpdateSpatialIndexSystem>();
 
+  // Hits are tested in parallel, and reported as damage events - applying
+  //  the damage is a separate (serial) reduction step
+  auto projectile_hits = builder.add_node()
+                             .fixed_tick()
+                             .depends_on(update_spatial_index)
+                             .partitioned(thread_count)
+                             .build<ProjectileHitSystem>();
+
   auto apply_projectile_damage = builder.add_node()
-                                     .depends_on(update_spatial_index)
-                                     .build<ProjectileHitSystem>();
+                                     .fixed_tick()
+                                     .depends_on(projectile_hits)
+                                     .build<ApplyProjectileDamageSystem>();
 
   auto update_health = builder.add_node()
+                           .fixed_tick()
                            .depends_on(apply_projectile_damage)
                            .build<UpdateHealthSystem>();
 
   // Run at the end of the logic pass (but before rendering pass begins)
   auto destroy_actors = builder.add_node()
+                            .fixed_tick()
                             .main_thread_only()
                             .depends_on(update_health)
                             .depends_on(apply_projectile_damage)
@@ -93,39 +221,36 @@ igecs::Scheduler build_update_and_render_scheduler(
   auto fly_camera =
       builder.add_node().main_thread_only().build<FlyCameraSystem>();
 
-  auto pbr_upload_scene_buffers =
-      builder.add_node()
-          .main_thread_only()
-          .depends_on(fly_camera)
-          // TODO (sessamekesh): .depends_on update camera system
-          .build<PbrUploadSceneBuffersSystem>();
+  // Copies everything render systems need out of logic components - this is
+  //  the last thing that touches logic state in a frame
+  auto extract_frame_packet_builder = builder.add_node();
+  extract_frame_packet_builder.depends_on(locomotion)
+      .depends_on(attach_renderables)
+      .depends_on(transform_ozz_animation_to_model_space)
+      .depends_on(fly_camera);
+  if (pipelined_present) {
+    extract_frame_packet_builder.depends_on(*pipelined_present);
+  }
+  auto extract_frame_packet =
+      extract_frame_packet_builder.build<ExtractFramePacketSystem>();
 
-  auto pbr_upload_instance_buffers =
-      builder.add_node()
-          .main_thread_only()
-          .depends_on(locomotion)
-          .depends_on(transform_ozz_animation_to_model_space)
-          .build<PbrUploadPerInstanceBuffersSystem>();
-
-  auto skybox_pass = builder.add_node()
-                         .main_thread_only()
-                         .depends_on(pbr_upload_scene_buffers)
-                         .build<SkyboxRenderSystem>();
-
-  auto pbr_geo_pass = builder.add_node()
-                          .main_thread_only()
-                          .depends_on(pbr_upload_scene_buffers)
-                          .depends_on(pbr_upload_instance_buffers)
-                          .depends_on(skybox_pass)
-                          .build<PbrGeoPassSystem>();
-
-  auto tonemapping_pass = builder.add_node()
-                              .main_thread_only()
-                              .depends_on(pbr_geo_pass)
-                              .depends_on(skybox_pass)
-                              .build<TonemapPass>();
-
-  return builder.build();
+  if (!pipeline_frames) {
+    auto present = builder.add_node()
+                       .main_thread_only()
+                       .depends_on(extract_frame_packet)
+                       .build<PresentFramePacketSystem>();
+    add_render_nodes(present);
+  }
+
+  auto scheduler = builder.build();
+  if (infer_dependencies) {
+    std::cout << "Hand-written frame graph: "
+              << scheduler.hand_written_graph_stats() << "\n"
+              << "Inferred frame graph: " << scheduler.graph_stats()
+              << std::endl;
+  }
+
+  return scheduler;
 }
 
 }  // namespace igdemo
@@ -1,4 +1,3 @@
-#include <igasync/promise_combiner.h>
 #include <igdemo/logic/framecommon.h>
 #include <igdemo/render/skeletal-animation.h>
 #include <igdemo/render/world-transform-component.h>
@@ -30,11 +29,6 @@ class hash_tuple {
   }
 };
 
-struct CtxOzzSamplingConcurrencyParams {
-  std::uint32_t samplingChunkSize;
-  std::uint32_t transformationChunkSize;
-};
-
 struct OzzSamplingBuffer {
   ozz::animation::SamplingJob::Context samplingContext;
   std::vector<ozz::math::SoaTransform> animLocals;
@@ -109,8 +103,6 @@ struct CtxOzzJobRemappers {
 namespace igdemo {
 
 void init_animation_systems(igecs::WorldView* wv) {
-  wv->attach_ctx<CtxOzzSamplingConcurrencyParams>(
-      CtxOzzSamplingConcurrencyParams{20, 20});
   wv->attach_ctx<CtxOzzJobRemappers>();
 }
 
@@ -147,19 +139,9 @@ void AdvanceAnimationTimeSystem::run(igecs::WorldView* wv) {
 //
 // SampleOzzAnimationSystem
 //
-void SampleOzzAnimationSystem::set_entities_per_task(igecs::WorldView* wv,
-                                                     std::uint32_t chunk_size) {
-  if (chunk_size > 0) {
-    wv->mut_ctx<CtxOzzSamplingConcurrencyParams>().samplingChunkSize =
-        chunk_size;
-  }
-}
-
 const igecs::WorldView::Decl& SampleOzzAnimationSystem::decl() {
   static igecs::WorldView::Decl decl =
       igecs::WorldView::Decl()
-          // Defined by calling init_animation_systems
-          .ctx_reads<CtxOzzSamplingConcurrencyParams>()
           // Iterators (external)
           .reads<AnimationStateComponent>()
           // Iterators (internal)
@@ -169,42 +151,25 @@ const igecs::WorldView::Decl& SampleOzzAnimationSystem::decl() {
 }
 
 std::shared_ptr<igasync::Promise<void>> SampleOzzAnimationSystem::run(
-    igecs::WorldView* wv, std::shared_ptr<igasync::TaskList> main_thread,
-    std::shared_ptr<igasync::TaskList> any_thread,
+    igecs::WorldView* wv,
+    std::shared_ptr<igasync::ExecutionContext> main_thread,
+    std::shared_ptr<igasync::ExecutionContext> any_thread,
     std::function<void(igasync::TaskProfile profile)> profile_cb) {
-  auto process_list = std::make_shared<std::vector<entt::entity>>();
-
-  const auto& chunk_size =
-      wv->ctx<CtxOzzSamplingConcurrencyParams>().samplingChunkSize;
-
-  // Pass 1: Attach sampling buffers to any components that don't have them,
-  //  and collect references to the entities that should be processed.
+  // Pass 1: Attach sampling buffers to any components that don't have them
   {
     auto view = wv->view<const AnimationStateComponent>();
     for (auto [e, animation_state] : view.each()) {
       if (!wv->has<OzzSamplingBuffer>(e)) {
         wv->attach<OzzSamplingBuffer>(e, animation_state.animation->animation);
       }
-      process_list->push_back(e);
     }
   }
 
-  // Schedule tasks in the appropriate chunk sizes to run
-  auto combiner = igasync::PromiseCombiner::Create();
-
-  for (std::uint32_t startChunk = 0; startChunk < process_list->size();
-       startChunk += chunk_size) {
-    std::uint32_t ct =
-        std::min(chunk_size,
-                 static_cast<std::uint32_t>(process_list->size()) - startChunk);
-
-    combiner->add(any_thread->run([startChunk, ct, process_list, wv]() {
-      for (int i = startChunk; i < startChunk + ct; i++) {
-        entt::entity e = (*process_list)[i];
-
-        const auto& animationState = wv->read<AnimationStateComponent>(e);
-        auto& ozzSamplingBuffer = wv->write<OzzSamplingBuffer>(e);
-
+  // Pass 2: Sample animations, in parallel
+  return wv->parallel_each<const AnimationStateComponent, OzzSamplingBuffer>(
+      any_thread, [](entt::entity e,
+                     const AnimationStateComponent& animationState,
+                     OzzSamplingBuffer& ozzSamplingBuffer) {
         ozzSamplingBuffer.maybe_resize(animationState.animation->animation);
 
         ozz::animation::SamplingJob sampling_job;
@@ -215,30 +180,16 @@ std::shared_ptr<igasync::Promise<void>> SampleOzzAnimationSystem::run(
         sampling_job.ratio = (animationState.sample_time /
                               animationState.animation->animation.duration());
         sampling_job.Run();
-      }
-    }),
-                  any_thread);
-  }
-
-  return combiner->combine([](auto) {}, any_thread);
+      });
 }
 
 //
 // TransformOzzAnimationToModelSpaceSystem
 //
-void TransformOzzAnimationToModelSpaceSystem::set_entities_per_task(
-    igecs::WorldView* wv, std::uint32_t chunk_size) {
-  if (chunk_size > 0) {
-    wv->mut_ctx<CtxOzzSamplingConcurrencyParams>().transformationChunkSize =
-        chunk_size;
-  }
-}
-
 const igecs::WorldView::Decl& TransformOzzAnimationToModelSpaceSystem::decl() {
   static igecs::WorldView::Decl decl =
       igecs::WorldView::Decl()
           // Defined by calling init_animation_systems
-          .ctx_reads<CtxOzzSamplingConcurrencyParams>()
           .ctx_writes<CtxOzzJobRemappers>()
 
           // Iterators (external)
@@ -254,60 +205,45 @@ const igecs::WorldView::Decl& TransformOzzAnimationToModelSpaceSystem::decl() {
 
 std::shared_ptr<igasync::Promise<void>>
 TransformOzzAnimationToModelSpaceSystem::run(
-    igecs::WorldView* wv, std::shared_ptr<igasync::TaskList> main_thread,
-    std::shared_ptr<igasync::TaskList> any_thread,
+    igecs::WorldView* wv,
+    std::shared_ptr<igasync::ExecutionContext> main_thread,
+    std::shared_ptr<igasync::ExecutionContext> any_thread,
     std::function<void(igasync::TaskProfile profile)> profile_cb) {
-  auto process_list = std::make_shared<std::vector<entt::entity>>();
-
-  const auto& chunk_size =
-      wv->ctx<CtxOzzSamplingConcurrencyParams>().transformationChunkSize;
-
-  // Pass 1: Attach sampling buffers to any components that don't have them,
-  //  and collect references to the entities that should be processed.
+  // Pass 1: Attach transformation buffers to any components that don't have
+  //  them, and make sure job contexts exist for every animation/skeleton pair
+  //  (these are only read from while transforming)
+  auto* transform_contexts = &wv->mut_ctx<CtxOzzJobRemappers>();
   {
-    auto& transform_contexts = wv->mut_ctx<CtxOzzJobRemappers>();
     auto view = wv->view<const AnimationStateComponent, const OzzSamplingBuffer,
                          SkinComponent>();
     for (auto [e, animation_state, sampling_buffer, skin] : view.each()) {
-      // Make sure (derived) OzzTransformationsBuffers is attached
       if (!wv->has<OzzTransformationsBuffers>(e)) {
         wv->attach<OzzTransformationsBuffers>(e, *skin.skeleton);
       }
 
-      // Make sure appropriate sampling contexts exist
-      transform_contexts.ras_context(animation_state.animation, skin.skeleton);
-      transform_contexts.pgs_context(skin.skeleton, skin.boneNames);
-
-      process_list->push_back(e);
+      transform_contexts->ras_context(animation_state.animation, skin.skeleton);
+      transform_contexts->pgs_context(skin.skeleton, skin.boneNames);
     }
   }
 
-  // Schedule tasks in the appropriate chunk sizes to run
-  auto combiner = igasync::PromiseCombiner::Create();
-
-  for (std::uint32_t startChunk = 0; startChunk < process_list->size();
-       startChunk += chunk_size) {
-    std::uint32_t ct =
-        std::min(chunk_size,
-                 static_cast<std::uint32_t>(process_list->size()) - startChunk);
-
-    combiner->add(any_thread->run([startChunk, ct, process_list, wv]() {
-      auto& transform_contexts = wv->mut_ctx<CtxOzzJobRemappers>();
-      for (int i = startChunk; i < startChunk + ct; i++) {
-        entt::entity e = (*process_list)[i];
-
-        const auto* animation = wv->read<AnimationStateComponent>(e).animation;
-        const auto& ozzSamplingBuffer = wv->read<OzzSamplingBuffer>(e);
-        auto& skinComponent = wv->write<SkinComponent>(e);
-        auto& ozzTransformationsBuffers =
-            wv->write<OzzTransformationsBuffers>(e);
+  // Pass 2: Transform sampled animations, in parallel
+  return wv->parallel_each<const AnimationStateComponent,
+                           const OzzSamplingBuffer, SkinComponent,
+                           OzzTransformationsBuffers>(
+      any_thread,
+      [transform_contexts](
+          entt::entity e, const AnimationStateComponent& animationState,
+          const OzzSamplingBuffer& ozzSamplingBuffer,
+          SkinComponent& skinComponent,
+          OzzTransformationsBuffers& ozzTransformationsBuffers) {
+        const auto* animation = animationState.animation;
 
         // Job 1 - remap animation to skeleton indices
         igasset::RemapAnimationToSkeletonIndicesJob ras_job;
         ras_job.animation = animation;
         ras_job.skeleton = skinComponent.skeleton;
         ras_job.context =
-            &transform_contexts.ras_context(animation, skinComponent.skeleton);
+            &transform_contexts->ras_context(animation, skinComponent.skeleton);
         ras_job.input = ozz::span(&ozzSamplingBuffer.animLocals[0],
                                   ozzSamplingBuffer.animLocals.size());
         ras_job.output =
@@ -330,7 +266,7 @@ TransformOzzAnimationToModelSpaceSystem::run(
         // inverse bind poses
         igasset::PrepareGpuSkinningDataJob pgs_job;
         pgs_job.skeleton = skinComponent.skeleton;
-        pgs_job.context = &transform_contexts.pgs_context(
+        pgs_job.context = &transform_contexts->pgs_context(
             skinComponent.skeleton, skinComponent.boneNames);
         pgs_job.inv_bind_poses = skinComponent.invBindPoses;
         pgs_job.model_bones = skinComponent.boneNames;
@@ -340,12 +276,7 @@ TransformOzzAnimationToModelSpaceSystem::run(
         pgs_job.output =
             ozz::span(&skinComponent.skin[0], skinComponent.skin.size());
         pgs_job.Run();
-      }
-    }),
-                  any_thread);
-  }
-
-  return combiner->combine([](auto) {}, any_thread);
+      });
 }
 
 }  // namespace igdemo
@@ -1,6 +1,5 @@
 #include <igdemo/assets/projectiles.h>
 #include <igdemo/assets/ybot.h>
-#include <igdemo/logic/projectile.h>
 #include <igdemo/logic/renderable.h>
 #include <igdemo/render/animated-pbr.h>
 #include <igdemo/systems/attach-renderables.h>
@@ -11,7 +10,6 @@ const igecs::WorldView::Decl& AttachRenderablesSystem::decl() {
   static igecs::WorldView::Decl decl =
       igecs::WorldView::Decl()
           .reads<RenderableComponent>()
-          .reads<Projectile>()
           .merge_in_decl(YbotRenderResources::decl())
           .merge_in_decl(YbotAnimationResources::decl())
           .merge_in_decl(ProjectileRenderUtil::decl());
@@ -44,14 +42,7 @@ void AttachRenderablesSystem::run(igecs::WorldView* wv) {
     }
   }
 
-  {
-    auto view = wv->view<const Projectile>();
-    for (auto [e, rc] : view.each()) {
-      if (!ProjectileRenderUtil::has_render_resources(wv, e)) {
-        ProjectileRenderUtil::attach_render_resources(wv, e);
-      }
-    }
-  }
+  ProjectileRenderUtil::reserve_model_bind_groups(wv);
 }
 
 }  // namespace igdemo
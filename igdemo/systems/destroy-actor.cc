@@ -9,6 +9,7 @@ const igecs::WorldView::Decl& DestroyActorSystem::decl() {
   static igecs::WorldView::Decl d = igecs::WorldView::Decl()
                                         .merge_in_decl(GridIndex::mut_decl())
                                         .evt_consumes<EvtDestroyActor>()
+                                        .destroys_entities()
                                         .ctx_writes<CtxSpatialIndex>()
                                         .reads<HeroTag>()
                                         .reads<enemy::EnemyTag>();
@@ -20,6 +21,7 @@ void DestroyActorSystem::run(igecs::WorldView* wv) {
 
   auto& ctxSpatialIndex = wv->mut_ctx<CtxSpatialIndex>();
 
+  // One event per actor, sorted by entity
   for (auto& evt : events) {
     if (wv->has<HeroTag>(evt.e)) {
       ctxSpatialIndex.heroIndex.remove(wv, evt.e);
@@ -1,3 +1,4 @@
+#include <igdemo/logic/counter-rng.h>
 #include <igdemo/logic/enemy.h>
 #include <igdemo/logic/framecommon.h>
 #include <igdemo/logic/levelmetadata.h>
@@ -8,7 +9,6 @@
 #include <igdemo/systems/enemy-locomotion.h>
 
 #include <glm/gtx/norm.hpp>
-#include <random>
 
 namespace {
 
@@ -20,8 +20,8 @@ const float kChucklefuckWanderSpeed = 1.5f;
 const float kBlitzingSpeed = 9.f;
 
 struct NextChucklefuckWanderLocation {
-  int rng_seed;
-  int location_rng_offset;
+  std::uint32_t rng_seed;
+  std::uint32_t location_rng_offset;
   glm::vec2 map_position;
 };
 
@@ -29,46 +29,32 @@ struct NextChucklefuckWanderLocation {
 
 namespace igdemo {
 
-const igecs::WorldView::Decl& UpdateEnemiesSystem::decl() {
-  static igecs::WorldView::Decl d =
-      igecs::WorldView::Decl()
-          .merge_in_decl(GridIndex::decl())
-          .ctx_reads<CtxSpatialIndex>()
-          .ctx_reads<CtxFrameTime>()
-          .ctx_reads<CtxLevelMetadata>()
-          .reads<enemy::EnemyTag>()
-          .reads<enemy::EnemyAggro>()
-          .reads<EnemyStrategyComponent>()
-          .writes<RenderableComponent>()
-          .writes<PositionComponent>()
-          .writes<OrientationComponent>()
-          .writes<ProjectileFiringIntent>()
-          .writes<NextChucklefuckWanderLocation>();
-
-  return d;
-}
-
-static void maybe_set_animation_state(igecs::WorldView* wv, entt::entity e,
-                                      AnimationType animation_type) {
-  if (wv->has<RenderableComponent>(e)) {
-    auto& renderable = wv->write<RenderableComponent>(e);
-    renderable.animation = animation_type;
-  }
+void init_enemy_locomotion_systems(igecs::WorldView* wv) {
+  // Partial-owning - position and orientation are owned by the locomotion
+  //  group (see init_locomotion_systems)
+  wv->group<RespondIfProvokedStrategyTag>(
+      entt::get<PositionComponent, OrientationComponent, RenderableComponent>);
+  wv->group<BlitzStrategyTag>(
+      entt::get<PositionComponent, OrientationComponent, RenderableComponent>);
+  wv->group<WanderStrategyTag>(
+      entt::get<EnemyStrategyComponent, PositionComponent,
+                OrientationComponent, RenderableComponent>);
 }
 
 static void enemy_respond_if_provoked(igecs::WorldView* wv, entt::entity e,
                                       float dt, PositionComponent& pos,
-                                      OrientationComponent& orientation) {
+                                      OrientationComponent& orientation,
+                                      RenderableComponent& renderable) {
   if (!wv->has<enemy::EnemyAggro>(e)) {
     // Just... sit around.
-    maybe_set_animation_state(wv, e, AnimationType::IDLE);
+    renderable.animation = AnimationType::IDLE;
     return;
   }
 
   const auto& aggro = wv->read<enemy::EnemyAggro>(e);
   if (!wv->valid(aggro.e)) {
-    wv->remove<enemy::EnemyAggro>(e);
-    maybe_set_animation_state(wv, e, AnimationType::IDLE);
+    wv->defer_remove<enemy::EnemyAggro>(e);
+    renderable.animation = AnimationType::IDLE;
     return;
   }
 
@@ -84,24 +70,25 @@ static void enemy_respond_if_provoked(igecs::WorldView* wv, entt::entity e,
   orientation.radAngle = glm::atan(to_enemy_dir.x, to_enemy_dir.y);
   pos.map_position +=
       to_enemy_dir * glm::min(dt * kEnemyProvokedMovementSpeed, to_enemy_len);
-  maybe_set_animation_state(wv, e, AnimationType::RUN);
+  renderable.animation = AnimationType::RUN;
 
   // Fire projectile
-  wv->attach_or_replace<ProjectileFiringIntent>(
+  wv->defer_attach_or_replace<ProjectileFiringIntent>(
       e, ProjectileFiringIntent{enemy_position});
 }
 
 static void enemy_blitz(igecs::WorldView* wv, entt::entity e, float dt,
                         const CtxSpatialIndex& spatial_index,
                         PositionComponent& pos,
-                        OrientationComponent& orientation) {
+                        OrientationComponent& orientation,
+                        RenderableComponent& renderable) {
   auto optNeighborEntity =
       spatial_index.heroIndex.nearest_neighbor(wv, pos.map_position);
 
   if (!optNeighborEntity || !wv->valid(*optNeighborEntity) ||
       !wv->has<PositionComponent>(*optNeighborEntity)) {
     // Nobody to approach, just hang out
-    maybe_set_animation_state(wv, e, AnimationType::IDLE);
+    renderable.animation = AnimationType::IDLE;
     return;
   }
 
@@ -116,29 +103,33 @@ static void enemy_blitz(igecs::WorldView* wv, entt::entity e, float dt,
   orientation.radAngle = glm::atan(to_enemy_dir.x, to_enemy_dir.y);
   pos.map_position +=
       to_enemy_dir * glm::min(dt * kBlitzingSpeed, to_enemy_len);
-  maybe_set_animation_state(wv, e, AnimationType::RUN);
+  renderable.animation = AnimationType::RUN;
 
   // Fire projectile
-  wv->attach_or_replace<ProjectileFiringIntent>(
+  wv->defer_attach_or_replace<ProjectileFiringIntent>(
       e, ProjectileFiringIntent{heroPos.map_position});
 }
 
 static void enemy_wander(igecs::WorldView* wv, entt::entity e, float dt,
                          std::uint32_t rngBase, PositionComponent& pos,
-                         OrientationComponent& orientation) {
+                         OrientationComponent& orientation,
+                         RenderableComponent& renderable) {
   const auto& ctxLvlMetadata = wv->ctx<CtxLevelMetadata>();
 
-  if (!wv->has<NextChucklefuckWanderLocation>(e)) {
-    NextChucklefuckWanderLocation wl{};
+  // Attaching is deferred - a new wander location is updated here, and
+  //  attached once the system is done
+  NextChucklefuckWanderLocation new_location{};
+  const bool is_new = !wv->has<NextChucklefuckWanderLocation>(e);
+  if (is_new) {
     // TODO (sessamekesh): Add another offset here based on entity ID or
     // something?
-    wl.rng_seed = rngBase + 1234;
-    wl.location_rng_offset = 0;
-    wl.map_position = pos.map_position;
-    wv->attach<NextChucklefuckWanderLocation>(e, wl);
+    new_location.rng_seed = rngBase + 1234;
+    new_location.location_rng_offset = 0;
+    new_location.map_position = pos.map_position;
   }
 
-  auto& wander_location = wv->write<NextChucklefuckWanderLocation>(e);
+  auto& wander_location =
+      is_new ? new_location : wv->write<NextChucklefuckWanderLocation>(e);
 
   float distance = kChucklefuckWanderSpeed * dt;
   glm::vec2 toDest = wander_location.map_position - pos.map_position;
@@ -149,19 +140,17 @@ static void enemy_wander(igecs::WorldView* wv, entt::entity e, float dt,
     distance -= distToDest;
     pos.map_position = wander_location.map_position;
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    gen.seed(wander_location.rng_seed + wander_location.location_rng_offset);
-    std::uniform_real_distribution<> x_pos_distribution(
-        ctxLvlMetadata.mapXMin,
-        ctxLvlMetadata.mapXMin + ctxLvlMetadata.mapXRange);
-    std::uniform_real_distribution<> z_pos_distribution(
-        ctxLvlMetadata.mapZMin,
-        ctxLvlMetadata.mapZMin + ctxLvlMetadata.mapZRange);
-
+    // Two draws (x, z) per wander location
+    const auto rng = CounterRng::Of(wander_location.rng_seed);
+    const std::uint64_t counter =
+        std::uint64_t{wander_location.location_rng_offset} * 2u;
     wander_location.location_rng_offset++;
-    wander_location.map_position.x = x_pos_distribution(gen);
-    wander_location.map_position.y = x_pos_distribution(gen);
+    wander_location.map_position.x =
+        rng.uniform(counter, ctxLvlMetadata.mapXMin,
+                    ctxLvlMetadata.mapXMin + ctxLvlMetadata.mapXRange);
+    wander_location.map_position.y =
+        rng.uniform(counter + 1u, ctxLvlMetadata.mapZMin,
+                    ctxLvlMetadata.mapZMin + ctxLvlMetadata.mapZRange);
 
     toDest = wander_location.map_position - pos.map_position;
     distToDest = glm::length(toDest);
@@ -170,27 +159,94 @@ static void enemy_wander(igecs::WorldView* wv, entt::entity e, float dt,
 
   pos.map_position += dirToDest * distance;
   orientation.radAngle = glm::atan(dirToDest.x, dirToDest.y);
-  maybe_set_animation_state(wv, e, AnimationType::WALK);
+  renderable.animation = AnimationType::WALK;
+
+  if (is_new) {
+    wv->defer_attach<NextChucklefuckWanderLocation>(e, new_location);
+  }
+}
+
+//
+// UpdateProvokedEnemiesSystem
+//
+const igecs::WorldView::Decl& UpdateProvokedEnemiesSystem::decl() {
+  static igecs::WorldView::Decl d =
+      igecs::WorldView::Decl()
+          .ctx_reads<CtxFrameTime>()
+          .owning_group<const RespondIfProvokedStrategyTag>(
+              entt::get<PositionComponent, OrientationComponent,
+                        RenderableComponent>)
+          .writes<enemy::EnemyAggro>()
+          .writes<ProjectileFiringIntent>();
+
+  return d;
+}
+
+void UpdateProvokedEnemiesSystem::run(igecs::WorldView* wv) {
+  const auto& dt = wv->ctx<CtxFrameTime>().secondsSinceLastFrame;
+
+  // Runs partitioned - structural changes are deferred to the end of the node
+  auto view = wv->primary_group<const RespondIfProvokedStrategyTag>(
+      entt::get<PositionComponent, OrientationComponent,
+                RenderableComponent>);
+  for (auto [e, pos, orientation, renderable] : view.each()) {
+    enemy_respond_if_provoked(wv, e, dt, pos, orientation, renderable);
+  }
 }
 
-void UpdateEnemiesSystem::run(igecs::WorldView* wv) {
+//
+// UpdateBlitzingEnemiesSystem
+//
+const igecs::WorldView::Decl& UpdateBlitzingEnemiesSystem::decl() {
+  static igecs::WorldView::Decl d =
+      igecs::WorldView::Decl()
+          .merge_in_decl(GridIndex::decl())
+          .ctx_reads<CtxSpatialIndex>()
+          .ctx_reads<CtxFrameTime>()
+          .owning_group<const BlitzStrategyTag>(
+              entt::get<PositionComponent, OrientationComponent,
+                        RenderableComponent>)
+          .writes<ProjectileFiringIntent>();
+
+  return d;
+}
+
+void UpdateBlitzingEnemiesSystem::run(igecs::WorldView* wv) {
   const auto& ctxSpatialIndex = wv->ctx<CtxSpatialIndex>();
-  auto view = wv->view<const EnemyStrategyComponent, PositionComponent,
-                       OrientationComponent, const enemy::EnemyTag>();
   const auto& dt = wv->ctx<CtxFrameTime>().secondsSinceLastFrame;
 
-  for (auto [e, strategy, pos, orientation] : view.each()) {
-    switch (strategy.strategy) {
-      case EnemyStrategy::RespondIfProvoked:
-        enemy_respond_if_provoked(wv, e, dt, pos, orientation);
-        break;
-      case EnemyStrategy::BlitzNearestHero:
-        enemy_blitz(wv, e, dt, ctxSpatialIndex, pos, orientation);
-        break;
-      case EnemyStrategy::WanderLikeAChuckleFuck:
-      default:
-        enemy_wander(wv, e, dt, strategy.rngSeed, pos, orientation);
-    }
+  auto view = wv->primary_group<const BlitzStrategyTag>(
+      entt::get<PositionComponent, OrientationComponent,
+                RenderableComponent>);
+  for (auto [e, pos, orientation, renderable] : view.each()) {
+    enemy_blitz(wv, e, dt, ctxSpatialIndex, pos, orientation, renderable);
+  }
+}
+
+//
+// UpdateWanderingEnemiesSystem
+//
+const igecs::WorldView::Decl& UpdateWanderingEnemiesSystem::decl() {
+  static igecs::WorldView::Decl d =
+      igecs::WorldView::Decl()
+          .ctx_reads<CtxFrameTime>()
+          .ctx_reads<CtxLevelMetadata>()
+          .owning_group<const WanderStrategyTag>(
+              entt::get<const EnemyStrategyComponent, PositionComponent,
+                        OrientationComponent, RenderableComponent>)
+          .writes<NextChucklefuckWanderLocation>();
+
+  return d;
+}
+
+void UpdateWanderingEnemiesSystem::run(igecs::WorldView* wv) {
+  const auto& dt = wv->ctx<CtxFrameTime>().secondsSinceLastFrame;
+
+  auto view = wv->primary_group<const WanderStrategyTag>(
+      entt::get<const EnemyStrategyComponent, PositionComponent,
+                OrientationComponent, RenderableComponent>);
+  for (auto [e, strategy, pos, orientation, renderable] : view.each()) {
+    enemy_wander(wv, e, dt, strategy.rngSeed, pos, orientation, renderable);
   }
 }
 
@@ -0,0 +1,153 @@
+#include <igdemo/assets/projectiles.h>
+#include <igdemo/logic/framecommon.h>
+#include <igdemo/logic/projectile-pool.h>
+#include <igdemo/render/frame-packet.h>
+#include <igdemo/render/world-transform-component.h>
+#include <igdemo/systems/frame-packet.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace igdemo {
+
+void init_frame_packet_systems(igecs::WorldView* wv) {
+  wv->attach_ctx<CtxExtractedFramePacket>();
+  wv->attach_ctx<CtxRenderFramePacket>();
+}
+
+//
+// ExtractFramePacketSystem
+//
+const igecs::WorldView::Decl& ExtractFramePacketSystem::decl() {
+  static igecs::WorldView::Decl decl =
+      igecs::WorldView::Decl()
+          // Defined by calling init_frame_packet_systems
+          .ctx_writes<CtxExtractedFramePacket>()
+
+          // Defined outside of system
+          .ctx_reads<CtxActiveCamera>()
+          .ctx_reads<CtxFrameTime>()
+          .ctx_reads<CtxProjectilePool>()
+          .ctx_reads<CtxProjectileRenderResources>()
+
+          // Individual entity reads
+          .reads<CameraComponent>()
+
+          // Iterators (external)
+          .reads<AnimatedPbrInstance>()
+          .reads<AnimatedPbrSkinBindGroup>()
+          .reads<SkinComponent>()
+          .reads<StaticPbrInstance>()
+          .reads<StaticPbrModelBindGroup>()
+          .reads<WorldTransformComponent>();
+
+  return decl;
+}
+
+void ExtractFramePacketSystem::run(igecs::WorldView* wv) {
+  auto& packet = wv->mut_ctx<CtxExtractedFramePacket>().packet;
+  const auto& mainCameraEntity = wv->ctx<CtxActiveCamera>().activeCameraEntity;
+
+  packet.isValid = true;
+  packet.camera = wv->read<CameraComponent>(mainCameraEntity);
+
+  // Packets are recycled every other frame - instances are overwritten in
+  //  place so that skin matrix storage is reused instead of reallocated
+  std::size_t animated_count = 0;
+  {
+    auto view = wv->view<const AnimatedPbrInstance, const SkinComponent,
+                         const WorldTransformComponent,
+                         const AnimatedPbrSkinBindGroup>();
+    for (auto [e, instance, skin, worldTransform, bindGroup] : view.each()) {
+      if (animated_count == packet.animatedInstances.size()) {
+        packet.animatedInstances.push_back(FramePacket::AnimatedInstance{
+            instance.material, instance.geometry, bindGroup, skin.skin,
+            worldTransform.worldTransform});
+      } else {
+        auto& dst = packet.animatedInstances[animated_count];
+        dst.material = instance.material;
+        dst.geometry = instance.geometry;
+        dst.skinBindGroup = bindGroup;
+        dst.skin.assign(skin.skin.begin(), skin.skin.end());
+        dst.worldTransform = worldTransform.worldTransform;
+      }
+      animated_count++;
+    }
+  }
+  packet.animatedInstances.erase(
+      packet.animatedInstances.begin() + animated_count,
+      packet.animatedInstances.end());
+
+  packet.staticInstances.clear();
+  {
+    auto view = wv->view<const StaticPbrInstance, const WorldTransformComponent,
+                         const StaticPbrModelBindGroup>();
+    for (auto [e, instance, worldTransform, bindGroup] : view.each()) {
+      packet.staticInstances.push_back(FramePacket::StaticInstance{
+          instance.material, instance.geometry, bindGroup,
+          worldTransform.worldTransform});
+    }
+  }
+
+  // Model buffers keep their contents between frames - only upload the ones
+  //  that are out of date
+  auto& lastExtractVersion =
+      wv->mut_ctx<CtxExtractedFramePacket>().lastExtractVersion;
+  packet.staticUploads.clear();
+  {
+    auto view = wv->changed_view<const StaticPbrInstance,
+                                 const WorldTransformComponent,
+                                 const StaticPbrModelBindGroup>(
+        lastExtractVersion);
+    for (auto [e, instance, worldTransform, bindGroup] : view.each()) {
+      packet.staticUploads.push_back(
+          FramePacket::StaticUpload{bindGroup, worldTransform.worldTransform});
+    }
+  }
+
+  // Pooled projectiles move every tick - every one is drawn and uploaded, at
+  //  its position interpolated between the last two ticks
+  const float alpha = wv->ctx<CtxFrameTime>().interpolationAlpha;
+  const auto& pool = wv->ctx<CtxProjectilePool>().pool;
+  const auto& resources = wv->ctx<CtxProjectileRenderResources>();
+  const std::size_t projectile_count =
+      std::min<std::size_t>(pool.size(), resources.modelBindGroups.size());
+  {
+    for (std::uint32_t i = 0u; i < projectile_count; i++) {
+      const auto* material = pool.source(i) == ProjectileSource::Hero
+                                 ? &resources.basicHeroProjectileMaterial
+                                 : &resources.basicEnemyProjectileMaterial;
+      const auto& bindGroup = resources.modelBindGroups[i];
+      const glm::mat4 worldTransform =
+          ProjectileRenderUtil::world_transform(
+              pool.interpolated_position(i, alpha));
+      packet.staticInstances.push_back(FramePacket::StaticInstance{
+          material, &resources.projectileSphereGeometry, bindGroup,
+          worldTransform});
+      packet.staticUploads.push_back(
+          FramePacket::StaticUpload{bindGroup, worldTransform});
+    }
+  }
+
+  lastExtractVersion = wv->version();
+}
+
+//
+// PresentFramePacketSystem
+//
+const igecs::WorldView::Decl& PresentFramePacketSystem::decl() {
+  static igecs::WorldView::Decl decl =
+      igecs::WorldView::Decl()
+          // Defined by calling init_frame_packet_systems
+          .ctx_writes<CtxExtractedFramePacket>()
+          .ctx_writes<CtxRenderFramePacket>();
+
+  return decl;
+}
+
+void PresentFramePacketSystem::run(igecs::WorldView* wv) {
+  std::swap(wv->mut_ctx<CtxExtractedFramePacket>().packet,
+            wv->mut_ctx<CtxRenderFramePacket>().packet);
+}
+
+}  // namespace igdemo
@@ -1,3 +1,4 @@
+#include <igdemo/logic/counter-rng.h>
 #include <igdemo/logic/framecommon.h>
 #include <igdemo/logic/hero.h>
 #include <igdemo/logic/levelmetadata.h>
@@ -7,7 +8,6 @@
 #include <igdemo/systems/hero-locomotion.h>
 
 #include <glm/gtc/constants.hpp>
-#include <random>
 
 namespace igdemo {
 
@@ -111,11 +111,8 @@ static void spray_n_pray(igecs::WorldView* wv, entt::entity e, float dt,
 
   target.timeToSwitch -= dt;
   if (target.timeToSwitch <= 0.f) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    gen.seed(target.rngOffset);
-    std::uniform_real_distribution<> angle_distribution(0.f, glm::pi<float>());
-    float angle = angle_distribution(gen);
+    float angle = CounterRng::Of(rngBase).uniform(target.rngOffset, 0.f,
+                                                  glm::pi<float>());
 
     glm::vec2 offset = glm::vec2(glm::sin(angle), glm::cos(angle));
     target.rngOffset++;
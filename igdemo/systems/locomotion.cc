@@ -1,34 +1,108 @@
+#include <igdemo/logic/framecommon.h>
+#include <igdemo/logic/locomotion-kernel.h>
 #include <igdemo/logic/locomotion.h>
 #include <igdemo/logic/renderable.h>
 #include <igdemo/render/world-transform-component.h>
 #include <igdemo/systems/locomotion.h>
 
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtx/transform.hpp>
+#include <vector>
 
 namespace igdemo {
 
+void init_locomotion_systems(igecs::WorldView* wv) {
+  // Creating the group packs the storages - before any system runs
+  wv->group<PositionComponent, OrientationComponent, ScaleComponent,
+            WorldTransformComponent>();
+}
+
+//
+// SnapshotPositionsSystem
+//
+const igecs::WorldView::Decl& SnapshotPositionsSystem::decl() {
+  static igecs::WorldView::Decl decl =
+      igecs::WorldView::Decl()
+          .reads<PositionComponent>()
+          .writes<PreviousPositionComponent>();
+
+  return decl;
+}
+
+void SnapshotPositionsSystem::run(igecs::WorldView* wv) {
+  // Every positioned entity is spawned with a previous position
+  auto view = wv->view<const PositionComponent, PreviousPositionComponent>();
+
+  for (auto [e, p, prev] : view.each()) {
+    prev.map_position = p.map_position;
+  }
+}
+
+//
+// LocomotionSystem
+//
 const igecs::WorldView::Decl& LocomotionSystem::decl() {
   static igecs::WorldView::Decl decl = igecs::WorldView::Decl()
-                                           .reads<PositionComponent>()
-                                           .reads<OrientationComponent>()
-                                           .reads<ScaleComponent>()
+                                           // Declared outside of system
+                                           .ctx_reads<CtxFrameTime>()
+
+                                           // Iterators
+                                           .owning_group<
+                                               const PositionComponent,
+                                               const OrientationComponent,
+                                               const ScaleComponent,
+                                               const WorldTransformComponent>()
+
+                                           .reads<PreviousPositionComponent>()
                                            .writes<WorldTransformComponent>();
 
   return decl;
 }
 
 void LocomotionSystem::run(igecs::WorldView* wv) {
-  auto view = wv->view<const PositionComponent, const OrientationComponent,
-                       const ScaleComponent, WorldTransformComponent>();
+  // Alpha is always 1 without a fixed tick rate - previous positions are not
+  //  snapshotted then, and there is nothing to blend
+  const float alpha = wv->ctx<CtxFrameTime>().interpolationAlpha;
+  const bool interpolate = alpha < 1.f;
+
+  // Partitions run concurrently - each thread gathers into its own batch
+  thread_local LocomotionBatch batch;
+  thread_local std::vector<entt::entity> entities;
+  thread_local std::vector<const WorldTransformComponent*> current;
+  thread_local std::vector<glm::mat4> transforms;
+  batch.clear();
+  entities.clear();
+  current.clear();
+
+  // Runs partitioned - only visits (and writes) this partition's entities.
+  //  Every entity is recomputed, not just a changed_view: actor logic writes
+  //  position and orientation through mutable views (which mark every entity
+  //  changed), and interpolated positions move every frame anyway. Idle
+  //  actors are instead filtered when writing the results below.
+  auto view =
+      wv->primary_group<const PositionComponent, const OrientationComponent,
+                        const ScaleComponent, const WorldTransformComponent>();
 
   for (auto [e, p, o, r, wt] : view.each()) {
-    glm::mat4 matScl = glm::scale(glm::vec3(r.scale));
-    glm::mat4 matRot = glm::rotate(o.radAngle, glm::vec3(0.f, 1.f, 0.f));
-    glm::mat4 matPos =
-        glm::translate(glm::vec3(p.map_position.x, 0.f, p.map_position.y));
+    glm::vec2 pos = p.map_position;
+    if (interpolate) {
+      pos = glm::mix(wv->read<PreviousPositionComponent>(e).map_position,
+                     p.map_position, alpha);
+    }
+
+    batch.push(pos, o.radAngle, r.scale);
+    entities.push_back(e);
+    current.push_back(&wt);
+  }
+
+  transforms.resize(batch.size());
+  compute_world_transforms(batch, transforms.data());
 
-    wt.worldTransform = matPos * matRot * matScl;
+  // Only actual changes are written, so that the transforms of idle actors
+  //  are not uploaded again (see ExtractFramePacketSystem)
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    if (transforms[i] != current[i]->worldTransform) {
+      wv->write<WorldTransformComponent>(entities[i]).worldTransform =
+          transforms[i];
+    }
   }
 }
 
@@ -1,6 +1,7 @@
 #include <igdemo/assets/skybox.h>
 #include <igdemo/render/camera.h>
 #include <igdemo/render/ctx-components.h>
+#include <igdemo/render/frame-packet.h>
 #include <igdemo/render/static-pbr.h>
 #include <igdemo/render/world-transform-component.h>
 #include <igdemo/systems/pbr-geo-pass.h>
@@ -14,15 +15,12 @@ const igecs::WorldView::Decl& PbrUploadSceneBuffersSystem::decl() {
                                            // Define outside of system
                                            .ctx_reads<CtxWgpuDevice>()
                                            .ctx_reads<CtxGeneralSceneParams>()
-                                           .ctx_reads<CtxActiveCamera>()
                                            .ctx_reads<CtxHdrPassOutput>()
+                                           .ctx_reads<CtxRenderFramePacket>()
 
                                            // Defined inside of system
                                            .ctx_writes<CtxSceneLightingParams>()
-                                           .ctx_writes<CtxGeneral3dBuffers>()
-
-                                           // Individual entity read
-                                           .reads<CameraComponent>();
+                                           .ctx_writes<CtxGeneral3dBuffers>();
 
   return decl;
 }
@@ -30,12 +28,16 @@ const igecs::WorldView::Decl& PbrUploadSceneBuffersSystem::decl() {
 void PbrUploadSceneBuffersSystem::run(igecs::WorldView* wv) {
   const auto& queue = wv->ctx<CtxWgpuDevice>().queue;
   const auto& generalSceneParams = wv->ctx<CtxGeneralSceneParams>();
-  const auto& mainCameraEntity = wv->ctx<CtxActiveCamera>().activeCameraEntity;
   const auto& ctxHdrPassOutput = wv->ctx<CtxHdrPassOutput>();
+  const auto& packet = wv->ctx<CtxRenderFramePacket>().packet;
   auto& sceneLightingParams = wv->mut_ctx<CtxSceneLightingParams>();
   auto& general3dBuffers = wv->mut_ctx<CtxGeneral3dBuffers>();
 
-  const auto& mainCamera = wv->read<CameraComponent>(mainCameraEntity);
+  if (!packet.isValid) {
+    return;
+  }
+
+  const auto& mainCamera = packet.camera;
 
   float aspect_ratio = static_cast<float>(ctxHdrPassOutput.width) /
                        static_cast<float>(ctxHdrPassOutput.height);
@@ -68,12 +70,7 @@ const igecs::WorldView::Decl& PbrUploadPerInstanceBuffersSystem::decl() {
   static igecs::WorldView::Decl decl = igecs::WorldView::Decl()
                                            // Define outside of system
                                            .ctx_reads<CtxWgpuDevice>()
-
-                                           // Iterators (external)
-                                           .reads<SkinComponent>()
-                                           .reads<WorldTransformComponent>()
-                                           .writes<AnimatedPbrSkinBindGroup>()
-                                           .writes<StaticPbrModelBindGroup>();
+                                           .ctx_reads<CtxRenderFramePacket>();
 
   return decl;
 }
@@ -81,22 +78,15 @@ const igecs::WorldView::Decl& PbrUploadPerInstanceBuffersSystem::decl() {
 void PbrUploadPerInstanceBuffersSystem::run(igecs::WorldView* wv) {
   const auto& ctxDevice = wv->ctx<CtxWgpuDevice>();
   const auto& queue = ctxDevice.queue;
+  const auto& packet = wv->ctx<CtxRenderFramePacket>().packet;
 
-  {
-    auto view = wv->view<const SkinComponent, const WorldTransformComponent,
-                         AnimatedPbrSkinBindGroup>();
-
-    for (auto [e, skin, worldTransform, buffers] : view.each()) {
-      buffers.update(queue, skin.skin, worldTransform.worldTransform);
-    }
+  for (const auto& instance : packet.animatedInstances) {
+    instance.skinBindGroup.update(queue, instance.skin,
+                                  instance.worldTransform);
   }
 
-  {
-    auto view =
-        wv->view<const WorldTransformComponent, StaticPbrModelBindGroup>();
-    for (auto [e, worldTransform, buffers] : view.each()) {
-      buffers.update(queue, worldTransform.worldTransform);
-    }
+  for (const auto& upload : packet.staticUploads) {
+    upload.modelBindGroup.update(queue, upload.worldTransform);
   }
 }
 
@@ -156,18 +146,13 @@ const igecs::WorldView::Decl& PbrGeoPassSystem::decl() {
           .ctx_writes<CtxGeneral3dBuffers>()
           .ctx_writes<CtxHdrPassOutput>()
           .ctx_reads<CtxHdrSkybox>()
+          .ctx_reads<CtxRenderFramePacket>()
 
           // DEFINED BY SYSTEM
           .ctx_reads<CtxAnimatedPbrPipeline>()
           .ctx_reads<CtxStaticPbrPipeline>()
           .ctx_reads<AnimatedPbrFrameBindGroup>()
-          .ctx_reads<StaticPbrFrameBindGroup>()
-
-          // COMPONENT ITERATORS
-          .reads<StaticPbrInstance>()
-          .reads<StaticPbrModelBindGroup>()
-          .reads<AnimatedPbrInstance>()
-          .reads<AnimatedPbrSkinBindGroup>();
+          .ctx_reads<StaticPbrFrameBindGroup>();
 
   return decl;
 }
@@ -183,6 +168,11 @@ void PbrGeoPassSystem::run(igecs::WorldView* wv) {
   const auto& ctxAnimatedPbrBindGroup = wv->ctx<AnimatedPbrFrameBindGroup>();
   const auto& ctxStaticPbrBindGroup = wv->ctx<StaticPbrFrameBindGroup>();
   const auto& ctxSkybox = wv->ctx<CtxHdrSkybox>();
+  const auto& packet = wv->ctx<CtxRenderFramePacket>().packet;
+
+  if (!packet.isValid) {
+    return;
+  }
 
   const auto& device = ctxWgpuDevice.device;
   const auto& queue = ctxWgpuDevice.queue;
@@ -215,44 +205,34 @@ void PbrGeoPassSystem::run(igecs::WorldView* wv) {
     pass.SetPipeline(ctxStaticPipeline.pipeline);
     pass.SetBindGroup(0, ctxStaticPbrBindGroup.frameBindGroup);
     pass.SetBindGroup(3, ctxSkybox.iblBindGroupStatic.bindGroup);
-    {
-      auto view =
-          wv->view<const StaticPbrInstance, const StaticPbrModelBindGroup>();
-
-      for (auto [e, instance, bg] : view.each()) {
-        const auto* geo = instance.geometry;
-        const auto* mat = instance.material;
-
-        pass.SetVertexBuffer(0, geo->vertexBuffer, 0, geo->vertexBufferSize);
-        pass.SetIndexBuffer(geo->indexBuffer, geo->indexFormat, 0,
-                            geo->indexBufferSize);
-        pass.SetBindGroup(1, mat->objBindGroup);
-        pass.SetBindGroup(2, bg.bindGroup);
-        pass.DrawIndexed(geo->numIndices);
-      }
+    for (const auto& instance : packet.staticInstances) {
+      const auto* geo = instance.geometry;
+      const auto* mat = instance.material;
+
+      pass.SetVertexBuffer(0, geo->vertexBuffer, 0, geo->vertexBufferSize);
+      pass.SetIndexBuffer(geo->indexBuffer, geo->indexFormat, 0,
+                          geo->indexBufferSize);
+      pass.SetBindGroup(1, mat->objBindGroup);
+      pass.SetBindGroup(2, instance.modelBindGroup.bindGroup);
+      pass.DrawIndexed(geo->numIndices);
     }
 
     // Animated
     pass.SetPipeline(ctxPipeline.pipeline);
     pass.SetBindGroup(0, ctxAnimatedPbrBindGroup.frameBindGroup);
     pass.SetBindGroup(3, ctxSkybox.iblBindGroupAnimated.bindGroup);
-    {
-      auto view =
-          wv->view<const AnimatedPbrInstance, const AnimatedPbrSkinBindGroup>();
-
-      for (auto [e, instance, bg] : view.each()) {
-        const auto* geo = instance.geometry;
-        const auto* mat = instance.material;
-
-        pass.SetVertexBuffer(0, geo->vertexBuffer, 0, geo->vertexBufferSize);
-        pass.SetVertexBuffer(1, geo->boneWeightsBuffer, 0,
-                             geo->boneWeightsBufferSize);
-        pass.SetIndexBuffer(geo->indexBuffer, geo->indexFormat, 0,
-                            geo->indexBufferSize);
-        pass.SetBindGroup(1, mat->objBindGroup);
-        pass.SetBindGroup(2, bg.skinBindGroup);
-        pass.DrawIndexed(geo->numIndices);
-      }
+    for (const auto& instance : packet.animatedInstances) {
+      const auto* geo = instance.geometry;
+      const auto* mat = instance.material;
+
+      pass.SetVertexBuffer(0, geo->vertexBuffer, 0, geo->vertexBufferSize);
+      pass.SetVertexBuffer(1, geo->boneWeightsBuffer, 0,
+                           geo->boneWeightsBufferSize);
+      pass.SetIndexBuffer(geo->indexBuffer, geo->indexFormat, 0,
+                          geo->indexBufferSize);
+      pass.SetBindGroup(1, mat->objBindGroup);
+      pass.SetBindGroup(2, instance.skinBindGroup.skinBindGroup);
+      pass.DrawIndexed(geo->numIndices);
     }
 
     pass.End();
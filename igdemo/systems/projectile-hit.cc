@@ -2,11 +2,15 @@
 #include <igdemo/logic/enemy.h>
 #include <igdemo/logic/hero.h>
 #include <igdemo/logic/locomotion.h>
+#include <igdemo/logic/projectile-pool.h>
 #include <igdemo/logic/projectile.h>
 #include <igdemo/logic/spatial-index.h>
 #include <igdemo/systems/destroy-actor.h>
 #include <igdemo/systems/projectile-hit.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace igdemo {
 
 const float kHeroProjectileRadius = 0.7f;
@@ -19,49 +23,86 @@ const igecs::WorldView::Decl& ProjectileHitSystem::decl() {
   static igecs::WorldView::Decl d = igecs::WorldView::Decl()
                                         .merge_in_decl(GridIndex::decl())
                                         .ctx_reads<CtxSpatialIndex>()
-                                        .reads<Projectile>()
-                                        .reads<PositionComponent>()
-                                        .writes<HealthComponent>()
-                                        .evt_writes<EvtDestroyActor>();
+                                        .ctx_writes<CtxProjectilePool>()
+                                        .evt_writes<EvtProjectileDamage>();
 
   return d;
 }
 
-static void projectile_hit(igecs::WorldView* wv, entt::entity enemy,
-                           float hitDamage) {
-  if (!wv->has<HealthComponent>(enemy)) {
-    return;
+void ProjectileHitSystem::run(igecs::WorldView* wv) {
+  const auto& spatial_index = wv->ctx<CtxSpatialIndex>();
+
+  // Partitions only expire projectiles in their own share of the pool
+  auto& pool = wv->mut_ctx<CtxProjectilePool>().pool;
+  const auto range = wv->partition_range(pool.size());
+
+  // Partitions run concurrently - each thread reuses its own hit buffer
+  thread_local std::vector<entt::entity> hits;
+
+  for (std::uint32_t i = range.begin; i < range.end; i++) {
+    const glm::vec2 position = pool.position(i);
+    hits.clear();
+    float damage = 0.f;
+    if (pool.source(i) == ProjectileSource::Hero) {
+      spatial_index.enemyIndex.collisions(wv, position, kHeroProjectileRadius,
+                                          hits);
+      damage = kHeroProjectileDamage;
+    } else if (pool.source(i) == ProjectileSource::Enemy) {
+      spatial_index.heroIndex.collisions(wv, position, kEnemyProjectileRadius,
+                                         hits);
+      damage = kEnemyProjectileDamage;
+    }
+
+    if (hits.empty()) {
+      continue;
+    }
+
+    for (auto target : hits) {
+      wv->enqueue_event(EvtProjectileDamage{target, damage});
+    }
+    pool.expire(i);
   }
+}
 
-  auto& health = wv->write<HealthComponent>(enemy);
-  health.currentHealth -= hitDamage;
+const igecs::WorldView::Decl& ApplyProjectileDamageSystem::decl() {
+  static igecs::WorldView::Decl d = igecs::WorldView::Decl()
+                                        .evt_consumes<EvtProjectileDamage>()
+                                        .ctx_writes<CtxProjectilePool>()
+                                        .writes<HealthComponent>()
+                                        .keyed_evt_writes<EvtDestroyActor>();
+
+  return d;
 }
 
-void ProjectileHitSystem::run(igecs::WorldView* wv) {
-  const auto& spatial_index = wv->ctx<CtxSpatialIndex>();
+void ApplyProjectileDamageSystem::run(igecs::WorldView* wv) {
+  // Projectiles that hit something were expired by ProjectileHitSystem
+  wv->mut_ctx<CtxProjectilePool>().pool.remove_expired();
 
-  auto view = wv->view<const Projectile, const PositionComponent>();
-
-  std::set<entt::entity> projectiles_to_destroy;
-
-  for (auto [e, projectile, position] : view.each()) {
-    if (projectile.type == ProjectileSource::Hero) {
-      for (auto collide_entity : spatial_index.enemyIndex.collisions(
-               wv, position.map_position, kHeroProjectileRadius)) {
-        projectile_hit(wv, collide_entity, kHeroProjectileDamage);
-        projectiles_to_destroy.insert(e);
-      }
-    } else if (projectile.type == ProjectileSource::Enemy) {
-      for (auto collide_entity : spatial_index.heroIndex.collisions(
-               wv, position.map_position, kEnemyProjectileRadius)) {
-        projectile_hit(wv, collide_entity, kEnemyProjectileDamage);
-        projectiles_to_destroy.insert(e);
-      }
+  auto hits = wv->consume_events<EvtProjectileDamage>();
+
+  // Grouped by target, so each health component is looked up once
+  std::sort(hits.begin(), hits.end(),
+            [](const EvtProjectileDamage& a, const EvtProjectileDamage& b) {
+              return entt::to_integral(a.target) <
+                     entt::to_integral(b.target);
+            });
+
+  for (std::size_t i = 0; i < hits.size();) {
+    const entt::entity target = hits[i].target;
+    float damage = 0.f;
+    for (; i < hits.size() && hits[i].target == target; i++) {
+      damage += hits[i].damage;
     }
-  }
 
-  for (auto e : projectiles_to_destroy) {
-    wv->enqueue_event<EvtDestroyActor>(EvtDestroyActor{e});
+    if (!wv->valid(target) || !wv->has<HealthComponent>(target)) {
+      continue;
+    }
+
+    auto& health = wv->write<HealthComponent>(target);
+    health.currentHealth -= damage;
+    if (health.currentHealth < 0.f) {
+      wv->enqueue_event(EvtDestroyActor{target});
+    }
   }
 }
 
@@ -1,6 +1,7 @@
 #include <igdemo/render/bg-skybox.h>
 #include <igdemo/render/camera.h>
 #include <igdemo/render/ctx-components.h>
+#include <igdemo/render/frame-packet.h>
 #include <igdemo/systems/skybox.h>
 
 #include <glm/gtc/matrix_transform.hpp>
@@ -13,11 +14,8 @@ const igecs::WorldView::Decl& SkyboxRenderSystem::decl() {
                                            .ctx_reads<CtxWgpuDevice>()
                                            .ctx_writes<BgSkyboxPipeline>()
                                            .ctx_writes<CtxHdrPassOutput>()
-                                           .ctx_reads<CtxActiveCamera>()
                                            .ctx_reads<CubemapUnitCube>()
-
-                                           // Individual entity reads
-                                           .reads<CameraComponent>();
+                                           .ctx_reads<CtxRenderFramePacket>();
 
   return decl;
 }
@@ -28,8 +26,13 @@ void SkyboxRenderSystem::run(igecs::WorldView* wv) {
   const auto& hdrOutParams = wv->ctx<CtxHdrPassOutput>();
   const auto& unitCubeGeo = wv->ctx<CubemapUnitCube>();
 
-  const auto& mainCameraEntity = wv->ctx<CtxActiveCamera>().activeCameraEntity;
-  const auto& mainCamera = wv->read<CameraComponent>(mainCameraEntity);
+  const auto& packet = wv->ctx<CtxRenderFramePacket>().packet;
+
+  if (!packet.isValid) {
+    return;
+  }
+
+  const auto& mainCamera = packet.camera;
 
   float aspect_ratio = static_cast<float>(hdrOutParams.width) /
                        static_cast<float>(hdrOutParams.height);
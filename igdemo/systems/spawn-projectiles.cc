@@ -3,12 +3,14 @@
 #include <igdemo/logic/framecommon.h>
 #include <igdemo/logic/hero.h>
 #include <igdemo/logic/locomotion.h>
+#include <igdemo/logic/projectile-pool.h>
 #include <igdemo/logic/projectile.h>
 #include <igdemo/systems/spawn-projectiles.h>
 
 namespace igdemo {
 
 const float kProjectileSpeed = 25.f;
+const float kProjectileLifetime = 10.f;
 
 const igecs::WorldView::Decl& SpawnProjectilesSystem::decl() {
   static igecs::WorldView::Decl decl = igecs::WorldView::Decl()
@@ -17,10 +19,8 @@ const igecs::WorldView::Decl& SpawnProjectilesSystem::decl() {
                                            .reads<ProjectileFiringIntent>()
                                            .reads<HeroTag>()
                                            .reads<enemy::EnemyTag>()
-                                           .writes<PositionComponent>()
                                            .writes<ProjectileFireCooldown>()
-                                           .writes<Projectile>()
-                                           .writes<LifetimeComponent>();
+                                           .evt_writes<EvtSpawnProjectile>();
 
   return decl;
 }
@@ -46,23 +46,20 @@ static void spawn_projectile(igecs::WorldView* wv, entt::entity source,
 
   auto dir = glm::normalize(intent.target - pos);
 
-  auto e = wv->create();
-  wv->attach<LifetimeComponent>(e, 10.f);
-  wv->attach<Projectile>(e, Projectile{/* type */
-                                       source_type,
-                                       /* source */
-                                       source,
-                                       /* veocity */
-                                       dir * kProjectileSpeed});
-  wv->attach<PositionComponent>(e, PositionComponent{
-                                       pos + dir * kProjectileSpeed * dt,
-                                   });
+  wv->enqueue_event(EvtSpawnProjectile{
+      /* position */ pos + dir * kProjectileSpeed * dt,
+      /* velocity */ dir * kProjectileSpeed,
+      /* lifetime */ kProjectileLifetime,
+      /* source */ source_type});
 }
 
 void SpawnProjectilesSystem::run(igecs::WorldView* wv) {
   const auto& dt = wv->ctx<CtxFrameTime>().secondsSinceLastFrame;
 
-  auto view = wv->view<const PositionComponent, ProjectileFireCooldown,
+  // Runs partitioned - projectiles are added to the pool by
+  //  MoveProjectileSystem
+  auto view =
+      wv->primary_view<const PositionComponent, ProjectileFireCooldown,
                        const ProjectileFiringIntent>();
 
   for (auto [e, pos, cooldown, intent] : view.each()) {
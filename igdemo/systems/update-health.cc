@@ -11,7 +11,7 @@ const igecs::WorldView::Decl& UpdateHealthSystem::decl() {
   static igecs::WorldView::Decl d = igecs::WorldView::Decl()
                                         .ctx_reads<CtxFrameTime>()
                                         .writes<HealthComponent>()
-                                        .evt_writes<EvtDestroyActor>();
+                                        .keyed_evt_writes<EvtDestroyActor>();
 
   return d;
 }
@@ -136,6 +136,12 @@ EMSCRIPTEN_BINDINGS(IgDemoModule) {
       .field("renderOutput", &igdemo::IgdemoConfig::renderOutput)
       .field("multithreaded", &igdemo::IgdemoConfig::multithreaded)
       .field("threadCountOverride", &igdemo::IgdemoConfig::threadCountOverride)
+      .field("useWorkStealingPool",
+             &igdemo::IgdemoConfig::useWorkStealingPool)
+      .field("inferSystemDependencies",
+             &igdemo::IgdemoConfig::inferSystemDependencies)
+      .field("pipelineFrames", &igdemo::IgdemoConfig::pipelineFrames)
+      .field("simulationTickRate", &igdemo::IgdemoConfig::simulationTickRate)
       .field("assetRootPath", &igdemo::IgdemoConfig::assetRootPath);
 
   class_<igdemo::IgdemoApp>("IgdemoApp")
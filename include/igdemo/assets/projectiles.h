@@ -6,6 +6,7 @@
 #include <igdemo/render/static-pbr.h>
 #include <igecs/world_view.h>
 
+#include <glm/glm.hpp>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,9 @@ struct CtxProjectileRenderResources {
 
   igdemo::StaticPbrMaterial basicEnemyProjectileMaterial;
   igdemo::StaticPbrMaterial basicHeroProjectileMaterial;
+
+  // One per projectile pool slot - grown with the pool, never shrunk
+  std::vector<igdemo::StaticPbrModelBindGroup> modelBindGroups;
 };
 
 std::shared_ptr<igasync::Promise<std::vector<std::string>>>
@@ -27,10 +31,18 @@ load_projectile_resources(
     std::shared_ptr<igasync::ExecutionContext> compute_tasks,
     std::shared_ptr<igasync::Promise<bool>> shaderLoadedPromise);
 
+/**
+ * Pooled projectiles (see ProjectilePool) are drawn straight from the pool -
+ *  slot i of the pool uses model bind group i, so a projectile spawning or
+ *  expiring does not create or destroy any GPU resources.
+ */
 struct ProjectileRenderUtil {
   static igecs::WorldView::Decl decl();
-  static bool has_render_resources(igecs::WorldView* wv, entt::entity e);
-  static void attach_render_resources(igecs::WorldView* wv, entt::entity e);
+
+  /** Make sure there is a model bind group for every slot of the pool */
+  static void reserve_model_bind_groups(igecs::WorldView* wv);
+
+  static glm::mat4 world_transform(glm::vec2 map_position);
 };
 
 }  // namespace igdemo
@@ -4,6 +4,7 @@
 #include <igasync/promise.h>
 #include <igasync/thread_pool.h>
 #include <igecs/scheduler.h>
+#include <igecs/work_stealing_pool.h>
 #include <igecs/world_view.h>
 #include <iggpu/app_base.h>
 
@@ -54,6 +55,35 @@ struct IgdemoConfig {
    */
   int threadCountOverride;
 
+  /**
+   * @brief True to run any-thread ECS work on an igecs work stealing pool
+   *  (with as many workers as the async thread pool) instead of the shared
+   *  async task list. Ignored if not multithreaded.
+   */
+  bool useWorkStealingPool;
+
+  /**
+   * @brief True to derive frame graph dependencies from system decls instead
+   *  of using the hand-written graph (see
+   *  igecs::Scheduler::Builder::infer_dependencies)
+   */
+  bool inferSystemDependencies;
+
+  /**
+   * @brief True to render the previous frame's extracted state while logic for
+   *  the current frame runs, instead of rendering after logic finishes. Adds a
+   *  frame of latency in exchange for overlapping render encoding (main
+   *  thread) with logic (worker threads).
+   */
+  bool pipelineFrames;
+
+  /**
+   * @brief Simulation ticks per second - simulation systems run 0..N times per
+   *  frame to keep up, and rendering interpolates between ticks. 0 to run
+   *  simulation once per frame.
+   */
+  std::uint32_t simulationTickRate;
+
   /**
    * @brief Base path to read resources from
    */
@@ -111,7 +141,8 @@ class IgdemoApp {
             std::unique_ptr<entt::registry> r,
             igecs::Scheduler frame_execution_graph, iggpu::AppBase* app_base,
             std::shared_ptr<igasync::TaskList> main_thread_tasks,
-            std::shared_ptr<igasync::TaskList> async_tasks)
+            std::shared_ptr<igasync::TaskList> async_tasks,
+            std::shared_ptr<igecs::WorkStealingPool> ecs_worker_pool)
       : config_(std::move(config)),
         proc_table_(std::move(proc_table)),
         r_(std::move(r)),
@@ -119,6 +150,7 @@ class IgdemoApp {
         app_base_(app_base),
         main_thread_tasks_(main_thread_tasks),
         async_tasks_(async_tasks),
+        ecs_worker_pool_(ecs_worker_pool),
         frame_id_(0u),
         remaining_profiles_(config.numProfiles) {}
 
@@ -131,6 +163,7 @@ class IgdemoApp {
 
   std::shared_ptr<igasync::TaskList> main_thread_tasks_;
   std::shared_ptr<igasync::TaskList> async_tasks_;
+  std::shared_ptr<igecs::WorkStealingPool> ecs_worker_pool_;
 
   uint32_t frame_id_;
   int remaining_profiles_;
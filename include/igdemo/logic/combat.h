@@ -8,10 +8,6 @@ struct HealthComponent {
   float currentHealth;
 };
 
-struct LifetimeComponent {
-  float timeRemaining;
-};
-
 }  // namespace igdemo
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef IGDEMO_LOGIC_COUNTER_RNG_H
+#define IGDEMO_LOGIC_COUNTER_RNG_H
+
+#include <cmath>
+#include <cstdint>
+
+namespace igdemo {
+
+/**
+ * Stateless counter-based random numbers (Widynski's "Squares" generator) -
+ *  the n-th number of a stream is a pure function of (seed, n), so systems can
+ *  draw numbers for any entity on any thread without sharing or storing
+ *  generator state, and get the same results every run.
+ *
+ * Only integer multiplies, adds and shifts - loops over many counters
+ *  vectorize, and there is no setup cost per draw.
+ */
+class CounterRng {
+ public:
+  /** Squares needs well-mixed keys - seeds are scrambled with splitmix64 */
+  static constexpr CounterRng Of(std::uint32_t seed) {
+    std::uint64_t z = seed + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z = z ^ (z >> 31);
+    return CounterRng(z | 1ull);
+  }
+
+  constexpr std::uint32_t u32(std::uint64_t counter) const {
+    std::uint64_t x = counter * key_;
+    const std::uint64_t y = x;
+    const std::uint64_t z = y + key_;
+    x = x * x + y;
+    x = (x >> 32) | (x << 32);
+    x = x * x + z;
+    x = (x >> 32) | (x << 32);
+    x = x * x + y;
+    x = (x >> 32) | (x << 32);
+    return static_cast<std::uint32_t>((x * x + z) >> 32);
+  }
+
+  /** Uniform float in [min, max) */
+  float uniform(std::uint64_t counter, float min, float max) const {
+    // Top 24 bits - every value is exactly representable as a float
+    const float unit = static_cast<float>(u32(counter) >> 8) * 0x1p-24f;
+
+    // Scaling can still round up to max when the range is narrow compared to
+    //  its magnitude (e.g. [10, 10.5))
+    const float value = min + (max - min) * unit;
+    return value < max ? value : std::nextafter(max, min);
+  }
+
+ private:
+  explicit constexpr CounterRng(std::uint64_t key) : key_(key) {}
+
+  std::uint64_t key_;
+};
+
+}  // namespace igdemo
+
+#endif
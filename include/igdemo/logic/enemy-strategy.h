@@ -11,8 +11,21 @@ enum class EnemyStrategy {
   RespondIfProvoked,
 };
 
+/**
+ * Strategies are tag components, so that each strategy is its own storage and
+ *  runs as its own loop (see enemy-locomotion.h). Every enemy has exactly one,
+ *  attached when it is created (see enemy::create_enemy_entities).
+ */
+template <EnemyStrategy Strategy>
+struct EnemyStrategyTag {};
+
+using WanderStrategyTag =
+    EnemyStrategyTag<EnemyStrategy::WanderLikeAChuckleFuck>;
+using BlitzStrategyTag = EnemyStrategyTag<EnemyStrategy::BlitzNearestHero>;
+using RespondIfProvokedStrategyTag =
+    EnemyStrategyTag<EnemyStrategy::RespondIfProvoked>;
+
 struct EnemyStrategyComponent {
-  EnemyStrategy strategy;
   std::uint32_t rngSeed;
 };
 
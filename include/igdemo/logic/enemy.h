@@ -6,6 +6,8 @@
 #include <igecs/world_view.h>
 
 #include <glm/glm.hpp>
+#include <span>
+#include <vector>
 
 namespace igdemo::enemy {
 
@@ -15,6 +17,22 @@ struct EnemyAggro {
   entt::entity e;
 };
 
+struct EnemySpawn {
+  EnemyStrategy strategy;
+  std::uint32_t rngSeed;
+  glm::vec2 startPos;
+  float startOrientation;
+};
+
+/**
+ * create_enemy_entity for every spawn at once - entities are created, and
+ *  each component is inserted for all of them in one batch (see
+ *  igecs::Prefab). Returns the new entities, in the order of spawns.
+ */
+std::vector<entt::entity> create_enemy_entities(
+    igecs::WorldView* wv, std::span<const EnemySpawn> spawns,
+    ModelType modelType = ModelType::YBOT, float modelScale = 1.f);
+
 entt::entity create_enemy_entity(igecs::WorldView* wv,
                                  EnemyStrategy enemyStrategy,
                                  std::uint32_t rngSeed, glm::vec2 startPos,
@@ -3,10 +3,28 @@
 
 #include <igasync/task_list.h>
 
+#include <cstdint>
+
 namespace igdemo {
 
 struct CtxFrameTime {
+  /**
+   * Time step of the running systems - the fixed tick length for simulation
+   *  (fixed tick) systems, and the frame time for per-frame systems
+   */
   float secondsSinceLastFrame;
+
+  /**
+   * Index of the running simulation tick - for per-frame systems, the number
+   *  of simulation ticks that have run so far
+   */
+  std::uint64_t tickIndex;
+
+  /**
+   * How far (0 to 1) the frame is between the last simulation tick and the
+   *  next one, used to interpolate simulation state for rendering
+   */
+  float interpolationAlpha;
 };
 
 }  // namespace igdemo
@@ -5,6 +5,8 @@
 #include <igecs/world_view.h>
 
 #include <glm/glm.hpp>
+#include <span>
+#include <vector>
 
 namespace igdemo {
 
@@ -20,6 +22,21 @@ struct HeroStrategyComponent {
 
 struct HeroTag {};
 
+struct HeroSpawn {
+  HeroStrategy strategy;
+  std::uint32_t rngSeed;
+  glm::vec2 startPos;
+  float startOrientation;
+};
+
+/**
+ * create_hero_entity for every spawn at once, with batched component inserts
+ *  (see igecs::Prefab). Returns the new entities, in the order of spawns.
+ */
+std::vector<entt::entity> create_hero_entities(
+    igecs::WorldView* wv, std::span<const HeroSpawn> spawns,
+    ModelType modelType, float modelScale = 1.f);
+
 entt::entity create_hero_entity(igecs::WorldView* wv, HeroStrategy heroStrategy,
                                 std::uint32_t rngSeed, glm::vec2 startPos,
                                 float startOrientation, ModelType modelType,
@@ -0,0 +1,41 @@
+#ifndef IGDEMO_LOGIC_LOCOMOTION_KERNEL_H
+#define IGDEMO_LOGIC_LOCOMOTION_KERNEL_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace igdemo {
+
+/**
+ * Locomotion state of a batch of entities, structure-of-arrays - gathered
+ *  from the (packed) locomotion group, so that world transforms can be built
+ *  several entities at a time.
+ */
+struct LocomotionBatch {
+  std::vector<float> x;
+  std::vector<float> z;
+  std::vector<float> angle;
+  std::vector<float> scale;
+
+  void clear();
+  void push(glm::vec2 map_position, float rad_angle, float uniform_scale);
+  std::size_t size() const { return x.size(); }
+};
+
+/**
+ * Writes the world transform of every entity of the batch to out (which must
+ *  fit batch.size() transforms) - the same translate * rotate-Y * scale
+ *  transform as building and multiplying the three glm matrices, without the
+ *  matrix products.
+ *
+ * Runs four entities at a time with SSE2 or WASM SIMD128 when available. The
+ *  scalar fallback uses the same sin/cos approximation, so every path stays
+ *  within ~1e-6 of glm::rotate.
+ */
+void compute_world_transforms(const LocomotionBatch& batch, glm::mat4* out);
+
+}  // namespace igdemo
+
+#endif
@@ -9,6 +9,14 @@ struct PositionComponent {
   glm::vec2 map_position;
 };
 
+/**
+ * Position as of the start of the last simulation tick - attach along with
+ *  PositionComponent (start it at the same position)
+ */
+struct PreviousPositionComponent {
+  glm::vec2 map_position;
+};
+
 struct OrientationComponent {
   float radAngle;
 };
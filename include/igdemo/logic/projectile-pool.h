@@ -0,0 +1,78 @@
+#ifndef IGDEMO_LOGIC_PROJECTILE_POOL_H
+#define IGDEMO_LOGIC_PROJECTILE_POOL_H
+
+#include <igdemo/logic/projectile.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace igdemo {
+
+// Projectiles are spawned by partitioned systems - spawns are queued as
+//  events, and added to the pool by MoveProjectileSystem
+struct EvtSpawnProjectile {
+  glm::vec2 position;
+  glm::vec2 velocity;
+  float lifetime;
+  ProjectileSource source;
+};
+
+/**
+ * Every live projectile, structure-of-arrays. Projectiles are short lived and
+ *  numerous, so they are kept out of the registry - spawning one is a push to
+ *  each array, and an expired projectile is swap-removed (the last projectile
+ *  takes its place). Indices are only stable until the next remove_expired.
+ *
+ * Render resources are per slot, see ProjectileRenderUtil.
+ */
+class ProjectilePool {
+ public:
+  void spawn(const EvtSpawnProjectile& spawn);
+
+  /**
+   * Move every projectile along its velocity, and age it by dt - positions
+   *  before the move are kept for interpolated_position
+   */
+  void integrate(float dt);
+
+  /**
+   * Mark a projectile to be removed by the next remove_expired - safe to call
+   *  concurrently for distinct indices (e.g. from partitions of one system)
+   */
+  void expire(std::uint32_t i) { lifetime_[i] = 0.f; }
+
+  /** Swap-remove every projectile out of lifetime */
+  void remove_expired();
+
+  std::uint32_t size() const { return static_cast<std::uint32_t>(x_.size()); }
+  glm::vec2 position(std::uint32_t i) const { return {x_[i], z_[i]}; }
+
+  /**
+   * Position blended between the last two integrate calls, alpha 0 being the
+   *  position before the last one (see CtxFrameTime::interpolationAlpha).
+   *  Projectiles spawned since start out where they were spawned.
+   */
+  glm::vec2 interpolated_position(std::uint32_t i, float alpha) const {
+    return glm::mix(glm::vec2(prev_x_[i], prev_z_[i]), position(i), alpha);
+  }
+  ProjectileSource source(std::uint32_t i) const { return source_[i]; }
+
+ private:
+  std::vector<float> x_;
+  std::vector<float> z_;
+  std::vector<float> prev_x_;
+  std::vector<float> prev_z_;
+  std::vector<float> vx_;
+  std::vector<float> vz_;
+  std::vector<float> lifetime_;
+  std::vector<ProjectileSource> source_;
+};
+
+struct CtxProjectilePool {
+  ProjectilePool pool;
+};
+
+}  // namespace igdemo
+
+#endif
@@ -30,12 +30,6 @@ struct ProjectileFireCooldown {
   float secondaryCdRemaining;
 };
 
-struct Projectile {
-  ProjectileSource type;
-  entt::entity source;
-  glm::vec2 velocity;
-};
-
 }  // namespace igdemo
 
 #endif
@@ -0,0 +1,135 @@
+#ifndef IGDEMO_LOGIC_SIMD4_H
+#define IGDEMO_LOGIC_SIMD4_H
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define IGDEMO_SIMD4_SIMD128
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IGDEMO_SIMD4_SSE2
+#endif
+
+/**
+ * Four-lane float ops for batch kernels - each backend (WASM SIMD128, SSE2,
+ *  or plain scalar code) maps them onto its own intrinsics. F4 is four floats,
+ *  I4 four int32s, and M4 a per-lane mask. Loads and stores are unaligned.
+ */
+namespace igdemo::simd4 {
+
+#if defined(IGDEMO_SIMD4_SIMD128)
+using F4 = v128_t;
+using I4 = v128_t;
+using M4 = v128_t;
+
+inline F4 load(const float* p) { return wasm_v128_load(p); }
+inline void store(float* p, F4 v) { wasm_v128_store(p, v); }
+inline F4 splat(float f) { return wasm_f32x4_splat(f); }
+inline F4 add(F4 a, F4 b) { return wasm_f32x4_add(a, b); }
+inline F4 sub(F4 a, F4 b) { return wasm_f32x4_sub(a, b); }
+inline F4 mul(F4 a, F4 b) { return wasm_f32x4_mul(a, b); }
+inline I4 round_to_int(F4 v) {
+  return wasm_i32x4_trunc_sat_f32x4(wasm_f32x4_nearest(v));
+}
+inline F4 to_float(I4 v) { return wasm_f32x4_convert_i32x4(v); }
+inline I4 increment(I4 v) { return wasm_i32x4_add(v, wasm_i32x4_splat(1)); }
+inline M4 bit_set(I4 v, std::int32_t bit) {
+  const v128_t b = wasm_i32x4_splat(bit);
+  return wasm_i32x4_eq(wasm_v128_and(v, b), b);
+}
+inline F4 select(M4 mask, F4 a, F4 b) {
+  return wasm_v128_bitselect(a, b, mask);
+}
+inline F4 negate_if(M4 mask, F4 v) {
+  return wasm_v128_xor(v, wasm_v128_and(mask, wasm_f32x4_splat(-0.f)));
+}
+#elif defined(IGDEMO_SIMD4_SSE2)
+using F4 = __m128;
+using I4 = __m128i;
+using M4 = __m128;
+
+inline F4 load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, F4 v) { _mm_storeu_ps(p, v); }
+inline F4 splat(float f) { return _mm_set1_ps(f); }
+inline F4 add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+inline F4 sub(F4 a, F4 b) { return _mm_sub_ps(a, b); }
+inline F4 mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+// Default MXCSR rounding is round-to-nearest
+inline I4 round_to_int(F4 v) { return _mm_cvtps_epi32(v); }
+inline F4 to_float(I4 v) { return _mm_cvtepi32_ps(v); }
+inline I4 increment(I4 v) { return _mm_add_epi32(v, _mm_set1_epi32(1)); }
+inline M4 bit_set(I4 v, std::int32_t bit) {
+  const __m128i b = _mm_set1_epi32(bit);
+  return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(v, b), b));
+}
+inline F4 select(M4 mask, F4 a, F4 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+inline F4 negate_if(M4 mask, F4 v) {
+  return _mm_xor_ps(v, _mm_and_ps(mask, _mm_set1_ps(-0.f)));
+}
+#else
+struct F4 {
+  float v[4];
+};
+struct I4 {
+  std::int32_t v[4];
+};
+struct M4 {
+  bool v[4];
+};
+
+inline F4 load(const float* p) { return F4{{p[0], p[1], p[2], p[3]}}; }
+inline void store(float* p, F4 v) {
+  for (int i = 0; i < 4; i++) p[i] = v.v[i];
+}
+inline F4 splat(float f) { return F4{{f, f, f, f}}; }
+inline F4 add(F4 a, F4 b) {
+  for (int i = 0; i < 4; i++) a.v[i] += b.v[i];
+  return a;
+}
+inline F4 sub(F4 a, F4 b) {
+  for (int i = 0; i < 4; i++) a.v[i] -= b.v[i];
+  return a;
+}
+inline F4 mul(F4 a, F4 b) {
+  for (int i = 0; i < 4; i++) a.v[i] *= b.v[i];
+  return a;
+}
+inline I4 round_to_int(F4 v) {
+  I4 rsl;
+  for (int i = 0; i < 4; i++) {
+    rsl.v[i] = static_cast<std::int32_t>(std::nearbyint(v.v[i]));
+  }
+  return rsl;
+}
+inline F4 to_float(I4 v) {
+  F4 rsl;
+  for (int i = 0; i < 4; i++) rsl.v[i] = static_cast<float>(v.v[i]);
+  return rsl;
+}
+inline I4 increment(I4 v) {
+  for (int i = 0; i < 4; i++) v.v[i]++;
+  return v;
+}
+inline M4 bit_set(I4 v, std::int32_t bit) {
+  M4 rsl;
+  for (int i = 0; i < 4; i++) rsl.v[i] = (v.v[i] & bit) != 0;
+  return rsl;
+}
+inline F4 select(M4 mask, F4 a, F4 b) {
+  for (int i = 0; i < 4; i++) a.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+  return a;
+}
+inline F4 negate_if(M4 mask, F4 v) {
+  for (int i = 0; i < 4; i++) v.v[i] = mask.v[i] ? -v.v[i] : v.v[i];
+  return v;
+}
+#endif
+
+}  // namespace igdemo::simd4
+
+#endif
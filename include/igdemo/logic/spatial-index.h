@@ -27,6 +27,10 @@ class GridIndex {
   std::vector<entt::entity> collisions(igecs::WorldView* wv, glm::vec2 pos,
                                        float radius) const;
 
+  /** Appends colliding entities to out - for callers that reuse a buffer */
+  void collisions(igecs::WorldView* wv, glm::vec2 pos, float radius,
+                  std::vector<entt::entity>& out) const;
+
   GridIndex() = delete;
   ~GridIndex() = default;
   GridIndex(const GridIndex&) = delete;
@@ -0,0 +1,69 @@
+#ifndef IGDEMO_RENDER_FRAME_PACKET_H
+#define IGDEMO_RENDER_FRAME_PACKET_H
+
+#include <igdemo/render/animated-pbr.h>
+#include <igdemo/render/camera.h>
+#include <igdemo/render/static-pbr.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace igdemo {
+
+/**
+ * @brief Snapshot of everything the render systems need to draw a frame.
+ *
+ * Render systems only read from a frame packet (never from logic components),
+ *  so rendering one frame can overlap with logic for the next one. GPU handles
+ *  are copied (and so kept alive) with the packet, since the entities that own
+ *  them may be destroyed while the packet is still being rendered.
+ */
+struct FramePacket {
+  struct AnimatedInstance {
+    const AnimatedPbrMaterial* material;
+    const AnimatedPbrGeometry* geometry;
+    AnimatedPbrSkinBindGroup skinBindGroup;
+    std::vector<glm::mat4> skin;
+    glm::mat4 worldTransform;
+  };
+
+  struct StaticInstance {
+    const StaticPbrMaterial* material;
+    const StaticPbrGeometry* geometry;
+    StaticPbrModelBindGroup modelBindGroup;
+    glm::mat4 worldTransform;
+  };
+
+  /** Model buffer of a static instance whose transform has changed */
+  struct StaticUpload {
+    StaticPbrModelBindGroup modelBindGroup;
+    glm::mat4 worldTransform;
+  };
+
+  /** False until the first extract - render systems skip invalid packets */
+  bool isValid = false;
+
+  CameraComponent camera{};
+  std::vector<AnimatedInstance> animatedInstances;
+  std::vector<StaticInstance> staticInstances;
+  std::vector<StaticUpload> staticUploads;
+};
+
+/** Packet being filled in by the extract stage of the current frame */
+struct CtxExtractedFramePacket {
+  FramePacket packet;
+
+  // WorldView version of the last extract - static uploads are only made for
+  //  transforms written since
+  std::uint64_t lastExtractVersion = 0u;
+};
+
+/** Packet being read by render systems in the current frame */
+struct CtxRenderFramePacket {
+  FramePacket packet;
+};
+
+}  // namespace igdemo
+
+#endif
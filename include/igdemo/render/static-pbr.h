@@ -58,6 +58,9 @@ struct StaticPbrFrameBindGroup {
 };
 
 struct StaticPbrModelBindGroup {
+  // Tracked - a new bind group needs its transform uploaded
+  static constexpr bool kTrackChanges = true;
+
   wgpu::BindGroup bindGroup;
 
   wgpu::Buffer worldTransformBuffer;
@@ -9,7 +9,10 @@
 
 namespace igdemo {
 
+// Tracked - the frame packet only re-uploads transforms that changed
 struct WorldTransformComponent {
+  static constexpr bool kTrackChanges = true;
+
   glm::mat4 worldTransform;
 };
 
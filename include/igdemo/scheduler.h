@@ -6,7 +6,9 @@
 namespace igdemo {
 
 igecs::Scheduler build_update_and_render_scheduler(
-    const std::vector<std::thread::id>& worker_thread_ids);
+    const std::vector<std::thread::id>& worker_thread_ids,
+    bool infer_dependencies, bool pipeline_frames,
+    std::uint32_t simulation_tick_rate);
 
 }  // namespace igdemo
 
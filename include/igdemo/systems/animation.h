@@ -15,23 +15,21 @@ class AdvanceAnimationTimeSystem {
 
 class SampleOzzAnimationSystem {
  public:
-  static void set_entities_per_task(igecs::WorldView* wv,
-                                    std::uint32_t chunk_size);
   static const igecs::WorldView::Decl& decl();
   static std::shared_ptr<igasync::Promise<void>> run(
-      igecs::WorldView* wv, std::shared_ptr<igasync::TaskList> main_thread,
-      std::shared_ptr<igasync::TaskList> any_thread,
+      igecs::WorldView* wv,
+      std::shared_ptr<igasync::ExecutionContext> main_thread,
+      std::shared_ptr<igasync::ExecutionContext> any_thread,
       std::function<void(igasync::TaskProfile profile)> profile_cb);
 };
 
 class TransformOzzAnimationToModelSpaceSystem {
  public:
-  static void set_entities_per_task(igecs::WorldView* wv,
-                                    std::uint32_t chunk_size);
   static const igecs::WorldView::Decl& decl();
   static std::shared_ptr<igasync::Promise<void>> run(
-      igecs::WorldView* wv, std::shared_ptr<igasync::TaskList> main_thread,
-      std::shared_ptr<igasync::TaskList> any_thread,
+      igecs::WorldView* wv,
+      std::shared_ptr<igasync::ExecutionContext> main_thread,
+      std::shared_ptr<igasync::ExecutionContext> any_thread,
       std::function<void(igasync::TaskProfile profile)> profile_cb);
 };
 
@@ -5,8 +5,12 @@
 
 namespace igdemo {
 
+// Keyed - an actor can be reported destroyed by several systems in a frame,
+//  DestroyActorSystem sees it once
 struct EvtDestroyActor {
   entt::entity e;
+
+  entt::entity key() const { return e; }
 };
 
 struct DestroyActorSystem {
@@ -5,9 +5,27 @@
 
 namespace igdemo {
 
-struct UpdateEnemiesSystem {
+/** Creates the groups of the enemy update systems - call at world setup */
+void init_enemy_locomotion_systems(igecs::WorldView* wv);
+
+//
+// One system per enemy strategy - each iterates the group of its strategy tag
+//  (see EnemyStrategyTag), so there is no per-entity dispatch on strategy
+//
+
+struct UpdateProvokedEnemiesSystem {
+  static const igecs::WorldView::Decl& decl();
+  static void run(igecs::WorldView* wv);
+};
+
+struct UpdateBlitzingEnemiesSystem {
+  static const igecs::WorldView::Decl& decl();
+  static void run(igecs::WorldView* wv);
+};
+
+struct UpdateWanderingEnemiesSystem {
   static const igecs::WorldView::Decl& decl();
-  static void run(igecs::WorldView* wv);  // TODO (sessamekesh): make async
+  static void run(igecs::WorldView* wv);
 };
 
 }  // namespace igdemo
@@ -0,0 +1,33 @@
+#ifndef IGDEMO_SYSTEMS_FRAME_PACKET_H
+#define IGDEMO_SYSTEMS_FRAME_PACKET_H
+
+#include <igecs/world_view.h>
+
+namespace igdemo {
+
+void init_frame_packet_systems(igecs::WorldView* wv);
+
+/**
+ * @brief Copies render-relevant state (camera, world transforms, skin matrices
+ *  and GPU handles) out of logic components into CtxExtractedFramePacket
+ */
+struct ExtractFramePacketSystem {
+  static const igecs::WorldView::Decl& decl();
+  static void run(igecs::WorldView* wv);
+};
+
+/**
+ * @brief Hands the most recently extracted frame packet to render systems.
+ *
+ * Scheduled after extract for same-frame rendering, or before extract (and
+ *  ahead of the frame's logic) for pipelined rendering, where render systems
+ *  draw the previous frame's packet while logic for this frame runs.
+ */
+struct PresentFramePacketSystem {
+  static const igecs::WorldView::Decl& decl();
+  static void run(igecs::WorldView* wv);
+};
+
+}  // namespace igdemo
+
+#endif
@@ -5,6 +5,23 @@
 
 namespace igdemo {
 
+/** Creates the owning group LocomotionSystem iterates - call at world setup */
+void init_locomotion_systems(igecs::WorldView* wv);
+
+/**
+ * @brief Records positions at the start of a simulation tick, so that per-frame
+ *  systems can interpolate between the last two ticks
+ */
+struct SnapshotPositionsSystem {
+  static const igecs::WorldView::Decl& decl();
+  static void run(igecs::WorldView* wv);
+};
+
+/**
+ * @brief Computes world transforms from logical position/orientation/scale,
+ *  interpolating positions between the last two simulation ticks. Transforms
+ *  are built in batches (see compute_world_transforms).
+ */
 struct LocomotionSystem {
   static const igecs::WorldView::Decl& decl();
   static void run(igecs::WorldView* wv);
@@ -5,11 +5,33 @@
 
 namespace igdemo {
 
+// One per projectile hit - summed per target by ApplyProjectileDamageSystem
+struct EvtProjectileDamage {
+  entt::entity target;
+  float damage;
+};
+
+/**
+ * @brief Tests pooled projectiles against the spatial index. Runs partitioned
+ *  over the projectile pool - hits are reported as EvtProjectileDamage events
+ *  instead of written to health, so partitions never touch the same target.
+ *  Projectiles that hit are expired in the pool.
+ */
 struct ProjectileHitSystem {
   static const igecs::WorldView::Decl& decl();
   static void run(igecs::WorldView* wv);
 };
 
+/**
+ * @brief Reduction step of ProjectileHitSystem - applies the damage of every
+ *  hit this tick, reports actors it kills as destroyed, and removes spent
+ *  projectiles from the pool
+ */
+struct ApplyProjectileDamageSystem {
+  static const igecs::WorldView::Decl& decl();
+  static void run(igecs::WorldView* wv);
+};
+
 }  // namespace igdemo
 
 #endif
@@ -0,0 +1,217 @@
+/**
+ * Event throughput benchmark - many producers, one consumer per frame.
+ *
+ * Every frame, a partitioned producer system (one partition per thread)
+ *  enqueues one event per entity, and a consumer system drains and sums all
+ *  of them. The same graph is run against:
+ *
+ * - queue: a moodycamel::ConcurrentQueue used like CtxEventQueue used to be -
+ *    enqueue without producer tokens, dequeue in batches of 16 into a fresh
+ *    std::vector
+ * - channel: igecs::EventChannel (WorldView::enqueue_event/consume_events)
+ *
+ * for 1 to 16 threads (the main thread counts as one of the threads), on an
+ *  igecs::WorkStealingPool.
+ *
+ * Usage: igecs-event-channel-bench [events_per_frame] [frames]
+ */
+
+#include <concurrentqueue.h>
+#include <igecs/scheduler.h>
+#include <igecs/work_stealing_pool.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct BenchEvent {
+  entt::entity e;
+  std::uint32_t payload;
+};
+
+struct BenchSource {
+  std::uint32_t payload;
+};
+
+struct CtxLegacyQueue {
+  mutable moodycamel::ConcurrentQueue<BenchEvent> queue;
+};
+
+struct CtxEventSum {
+  std::uint64_t sum;
+};
+
+struct QueueProduceSystem {
+  static const igecs::WorldView::Decl& decl() {
+    static igecs::WorldView::Decl decl = igecs::WorldView::Decl()
+                                             .ctx_reads<CtxLegacyQueue>()
+                                             .reads<BenchSource>();
+    return decl;
+  }
+
+  static void run(igecs::WorldView* wv) {
+    const auto& ctx_queue = wv->ctx<CtxLegacyQueue>();
+    for (auto [e, source] : wv->primary_view<const BenchSource>().each()) {
+      ctx_queue.queue.enqueue(BenchEvent{e, source.payload});
+    }
+  }
+};
+
+struct QueueConsumeSystem {
+  static const igecs::WorldView::Decl& decl() {
+    static igecs::WorldView::Decl decl = igecs::WorldView::Decl()
+                                             .ctx_reads<CtxLegacyQueue>()
+                                             .ctx_writes<CtxEventSum>();
+    return decl;
+  }
+
+  static void run(igecs::WorldView* wv) {
+    const auto& ctx_queue = wv->ctx<CtxLegacyQueue>();
+    BenchEvent bulk_events[16]{};
+    size_t num_evts = 0;
+    std::vector<BenchEvent> evts;
+    while ((num_evts = ctx_queue.queue.try_dequeue_bulk(bulk_events, 16)) !=
+           0) {
+      for (size_t i = 0; i < num_evts; i++) {
+        evts.push_back(bulk_events[i]);
+      }
+    }
+
+    auto& sum = wv->mut_ctx<CtxEventSum>();
+    for (const auto& evt : evts) {
+      sum.sum += evt.payload;
+    }
+  }
+};
+
+struct ChannelProduceSystem {
+  static const igecs::WorldView::Decl& decl() {
+    static igecs::WorldView::Decl decl = igecs::WorldView::Decl()
+                                             .evt_writes<BenchEvent>()
+                                             .reads<BenchSource>();
+    return decl;
+  }
+
+  static void run(igecs::WorldView* wv) {
+    for (auto [e, source] : wv->primary_view<const BenchSource>().each()) {
+      wv->enqueue_event(BenchEvent{e, source.payload});
+    }
+  }
+};
+
+struct ChannelConsumeSystem {
+  static const igecs::WorldView::Decl& decl() {
+    static igecs::WorldView::Decl decl = igecs::WorldView::Decl()
+                                             .evt_consumes<BenchEvent>()
+                                             .ctx_writes<CtxEventSum>();
+    return decl;
+  }
+
+  static void run(igecs::WorldView* wv) {
+    auto& sum = wv->mut_ctx<CtxEventSum>();
+    for (const auto& evt : wv->consume_events<BenchEvent>()) {
+      sum.sum += evt.payload;
+    }
+  }
+};
+
+std::unique_ptr<entt::registry> make_world(std::uint32_t event_count) {
+  auto world = std::make_unique<entt::registry>();
+  world->ctx().emplace<CtxLegacyQueue>();
+  world->ctx().emplace<CtxEventSum>(CtxEventSum{0u});
+  world->ctx().emplace<igecs::CtxEventQueue<BenchEvent>>();
+
+  for (std::uint32_t i = 0; i < event_count; i++) {
+    world->emplace<BenchSource>(world->create(), BenchSource{i % 7u});
+  }
+
+  return world;
+}
+
+template <typename ProduceT, typename ConsumeT>
+igecs::Scheduler make_scheduler(
+    const std::vector<std::thread::id>& worker_thread_ids) {
+  auto builder = igecs::Scheduler::Builder("Event channel bench");
+  builder.main_thread_id(std::this_thread::get_id());
+  builder.max_spin_time(std::chrono::seconds(10));
+  for (const auto& id : worker_thread_ids) {
+    builder.worker_thread_id(id);
+  }
+
+  const auto thread_count =
+      static_cast<std::uint32_t>(worker_thread_ids.size()) + 1u;
+  auto produce =
+      builder.add_node().partitioned(thread_count).build<ProduceT>();
+  auto consume = builder.add_node().depends_on(produce).build<ConsumeT>();
+  return builder.build();
+}
+
+template <typename ExecFnT>
+double time_frames(std::uint32_t frame_count, ExecFnT&& exec_frame) {
+  // Warmup - let threads spin up, and arenas grow to fit
+  for (std::uint32_t i = 0; i < 5; i++) {
+    exec_frame();
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (std::uint32_t i = 0; i < frame_count; i++) {
+    exec_frame();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         frame_count;
+}
+
+template <typename ProduceT, typename ConsumeT>
+double run_case(std::uint32_t thread_count, std::uint32_t event_count,
+                std::uint32_t frame_count) {
+  auto pool = igecs::WorkStealingPool::Create(thread_count - 1u);
+  auto world = make_world(event_count);
+  auto scheduler = make_scheduler<ProduceT, ConsumeT>(pool->thread_ids());
+  double ms = time_frames(frame_count,
+                          [&] { scheduler.execute(pool, world.get()); });
+
+  // Every event of every frame (warmup included) has to be seen exactly once
+  std::uint64_t expected = 0u;
+  for (std::uint32_t i = 0; i < event_count; i++) {
+    expected += i % 7u;
+  }
+  expected *= frame_count + 5u;
+  if (world->ctx().get<CtxEventSum>().sum != expected) {
+    std::cerr << "Event sum mismatch - events were lost or duplicated\n";
+  }
+
+  return ms;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::uint32_t event_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+  std::uint32_t frame_count = argc > 2 ? std::atoi(argv[2]) : 100;
+
+  std::cout << "Event throughput: " << event_count << " events per frame, "
+            << frame_count << " frames (hardware_concurrency="
+            << std::thread::hardware_concurrency() << ")\n\n";
+  std::cout << std::setw(8) << "threads" << std::setw(12) << "queue_ms"
+            << std::setw(14) << "channel_ms" << std::setw(12) << "speedup"
+            << "\n";
+
+  for (std::uint32_t thread_count : {1u, 2u, 4u, 8u, 16u}) {
+    double queue_ms = run_case<QueueProduceSystem, QueueConsumeSystem>(
+        thread_count, event_count, frame_count);
+    double channel_ms = run_case<ChannelProduceSystem, ChannelConsumeSystem>(
+        thread_count, event_count, frame_count);
+
+    std::cout << std::fixed << std::setprecision(3) << std::setw(8)
+              << thread_count << std::setw(12) << queue_ms << std::setw(14)
+              << channel_ms << std::setw(12) << queue_ms / channel_ms << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * Batched spawn benchmark - creates N entities with eight components (the
+ *  shape of an igdemo enemy), with a per-entity position and seed.
+ *
+ * - attach: create() and one attach per component per entity, as
+ *    create_enemy_entity used to
+ * - prefab: igecs::Prefab::spawn - one batched create, and one range insert
+ *    per component storage
+ *
+ * Every run starts from an empty registry.
+ *
+ * Usage: igecs-prefab-bench [repetitions]
+ */
+
+#include <igecs/prefab.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct Position {
+  float x, z;
+};
+
+struct Orientation {
+  float rad_angle;
+};
+
+struct Health {
+  float max_health;
+  float current_health;
+};
+
+struct Renderable {
+  int model;
+  int material;
+  int animation;
+};
+
+struct Scale {
+  float scale;
+};
+
+struct Strategy {
+  std::uint32_t rng_seed;
+};
+
+struct Cooldown {
+  int max_allowed;
+  int current_stored;
+  float main_cd;
+  float secondary_cd;
+};
+
+struct Tag {};
+
+using EnemyPrefab = igecs::Prefab<Position, Orientation, Health, Renderable,
+                                  Scale, Tag, Strategy, Cooldown>;
+
+EnemyPrefab make_prefab() {
+  return EnemyPrefab(Position{}, Orientation{}, Health{100.f, 100.f},
+                     Renderable{0, 1, 0}, Scale{0.01f}, Tag{}, Strategy{},
+                     Cooldown{12, 12, 2.5f, 0.85f});
+}
+
+void spawn_attach(entt::registry* registry, std::uint32_t entity_count) {
+  auto wv = igecs::WorldView::Thin(registry);
+  for (std::uint32_t i = 0; i < entity_count; i++) {
+    auto e = wv.create();
+    wv.attach<Position>(e, Position{static_cast<float>(i), 0.f});
+    wv.attach<Orientation>(e, Orientation{0.f});
+    wv.attach<Health>(e, Health{100.f, 100.f});
+    wv.attach<Renderable>(e, Renderable{0, 1, 0});
+    wv.attach<Scale>(e, Scale{0.01f});
+    wv.attach<Tag>(e);
+    wv.attach<Strategy>(e, Strategy{i});
+    wv.attach<Cooldown>(e, Cooldown{12, 12, 2.5f, 0.85f});
+  }
+}
+
+void spawn_prefab(entt::registry* registry, std::uint32_t entity_count) {
+  auto prefab = make_prefab();
+  auto wv = igecs::WorldView::Thin(registry);
+  std::vector<entt::entity> entities(entity_count);
+  prefab.spawn(&wv, entities, [](std::size_t i, auto& instance) {
+    std::get<Position>(instance).x = static_cast<float>(i);
+    std::get<Strategy>(instance).rng_seed = static_cast<std::uint32_t>(i);
+  });
+}
+
+template <typename SpawnFnT>
+double time_spawns(std::uint32_t repetitions, std::uint32_t entity_count,
+                   SpawnFnT&& spawn) {
+  double total_ms = 0.;
+  for (std::uint32_t i = 0; i < repetitions; i++) {
+    entt::registry registry;
+    auto start = std::chrono::high_resolution_clock::now();
+    spawn(&registry, entity_count);
+    auto end = std::chrono::high_resolution_clock::now();
+    total_ms += std::chrono::duration<double, std::milli>(end - start).count();
+  }
+  return total_ms / repetitions;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::uint32_t repetitions = argc > 1 ? std::atoi(argv[1]) : 10;
+
+  std::cout << "Batched spawn: " << repetitions << " repetitions\n\n";
+  std::cout << std::setw(10) << "entities" << std::setw(12) << "attach_ms"
+            << std::setw(12) << "prefab_ms" << std::setw(12) << "speedup"
+            << "\n";
+
+  for (std::uint32_t entity_count : {1000u, 10000u, 100000u}) {
+    double attach_ms = time_spawns(repetitions, entity_count, spawn_attach);
+    double prefab_ms = time_spawns(repetitions, entity_count, spawn_prefab);
+
+    std::cout << std::fixed << std::setprecision(3) << std::setw(10)
+              << entity_count << std::setw(12) << attach_ms << std::setw(12)
+              << prefab_ms << std::setw(12) << attach_ms / prefab_ms << "\n";
+  }
+
+  return 0;
+}
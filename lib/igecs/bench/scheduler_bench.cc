@@ -0,0 +1,394 @@
+/**
+ * Scheduler overhead benchmark on synthetic frame graphs.
+ *
+ * Generates graphs of a given shape and size, where every node is a
+ *  synchronous system with either an empty body or a body that spins for a
+ *  fixed amount of time, and measures Scheduler::execute for 1 to N threads:
+ *
+ * - frame time (mean and best over all measured frames)
+ * - scheduling overhead: frame time past the ideal frame time for the graph,
+ *    max(critical path work, total work / threads), per node
+ * - critical path efficiency: critical path work / frame time
+ * - thread scaling: frame time at the first thread count / frame time
+ *
+ * Shapes:
+ * - chain: every node depends on the one before it
+ * - fan_out: one root node, every other node depends on it
+ * - diamond: a stack of diamonds, each a fork into 8 nodes and a join
+ * - random: every node depends on ~2 random earlier nodes
+ * - inferred: nodes read and write random components, and dependencies are
+ *    inferred from those decls (see Scheduler::Builder::infer_dependencies)
+ *
+ * Nodes in the explicit shapes read --reads_per_node random components, which
+ *  never conflict but make world views (and validation) more expensive.
+ *
+ * Results are written as JSON to stdout, and as a table to stderr.
+ *
+ * Usage: igecs-scheduler-bench [--shapes=chain,fan_out,diamond,random,inferred]
+ *   [--sizes=10,100,1000] [--threads=1,2,4,8] [--executors=pool,task_list]
+ *   [--body_us=0] [--reads_per_node=0] [--frames=200] [--seed=1]
+ */
+
+#include <igasync/thread_pool.h>
+#include <igecs/scheduler.h>
+#include <igecs/work_stealing_pool.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+const std::uint32_t kComponentTypeCount = 16u;
+const std::uint32_t kDiamondWidth = 8u;
+const std::uint32_t kWarmupFrames = 20u;
+
+template <int N>
+struct BenchComponent {
+  float value;
+};
+
+struct BenchNode {};
+
+// Decl builders for every component type, so that access can be picked at
+//  runtime
+using DeclFn = void (*)(igecs::WorldView::Decl& decl);
+
+template <std::size_t... N>
+std::array<DeclFn, kComponentTypeCount> make_read_fns(
+    std::index_sequence<N...>) {
+  return {[](igecs::WorldView::Decl& decl) {
+    decl.reads<BenchComponent<N>>();
+  }...};
+}
+
+template <std::size_t... N>
+std::array<DeclFn, kComponentTypeCount> make_write_fns(
+    std::index_sequence<N...>) {
+  return {[](igecs::WorldView::Decl& decl) {
+    decl.writes<BenchComponent<N>>();
+  }...};
+}
+
+const auto kReadFns =
+    make_read_fns(std::make_index_sequence<kComponentTypeCount>());
+const auto kWriteFns =
+    make_write_fns(std::make_index_sequence<kComponentTypeCount>());
+
+struct Options {
+  std::vector<std::string> shapes = {"chain", "fan_out", "diamond", "random",
+                                     "inferred"};
+  std::vector<std::uint32_t> sizes = {10u, 100u, 1000u};
+  std::vector<std::uint32_t> threads = {1u, 2u, 4u, 8u};
+  std::vector<std::string> executors = {"pool", "task_list"};
+  std::uint32_t body_us = 0u;
+  std::uint32_t reads_per_node = 0u;
+  std::uint32_t frames = 200u;
+  std::uint32_t seed = 1u;
+};
+
+std::vector<std::string> split(const std::string& list) {
+  std::vector<std::string> out;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) out.push_back(item);
+  }
+  return out;
+}
+
+std::vector<std::uint32_t> split_uints(const std::string& list) {
+  std::vector<std::uint32_t> out;
+  for (const auto& item : split(list)) {
+    out.push_back(static_cast<std::uint32_t>(std::atoi(item.c_str())));
+  }
+  return out;
+}
+
+bool parse_options(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto eq = arg.find('=');
+    if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+      std::cerr << "Unrecognized argument: " << arg << std::endl;
+      return false;
+    }
+
+    std::string key = arg.substr(2, eq - 2);
+    std::string value = arg.substr(eq + 1);
+    if (key == "shapes") {
+      o.shapes = split(value);
+    } else if (key == "sizes") {
+      o.sizes = split_uints(value);
+    } else if (key == "threads") {
+      o.threads = split_uints(value);
+    } else if (key == "executors") {
+      o.executors = split(value);
+    } else if (key == "body_us") {
+      o.body_us = std::atoi(value.c_str());
+    } else if (key == "reads_per_node") {
+      o.reads_per_node = std::atoi(value.c_str());
+    } else if (key == "frames") {
+      o.frames = std::atoi(value.c_str());
+    } else if (key == "seed") {
+      o.seed = std::atoi(value.c_str());
+    } else {
+      std::cerr << "Unrecognized argument: " << arg << std::endl;
+      return false;
+    }
+  }
+
+  for (const auto& shape : o.shapes) {
+    if (shape != "chain" && shape != "fan_out" && shape != "diamond" &&
+        shape != "random" && shape != "inferred") {
+      std::cerr << "Unrecognized shape: " << shape << std::endl;
+      return false;
+    }
+  }
+  for (const auto& executor : o.executors) {
+    if (executor != "pool" && executor != "task_list") {
+      std::cerr << "Unrecognized executor: " << executor << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/** preds[i] lists the nodes that node i depends on (all less than i) */
+std::vector<std::vector<std::uint32_t>> make_shape(const std::string& shape,
+                                                   std::uint32_t size,
+                                                   std::mt19937& rng) {
+  std::vector<std::vector<std::uint32_t>> preds(size);
+
+  if (shape == "chain") {
+    for (std::uint32_t i = 1; i < size; i++) {
+      preds[i].push_back(i - 1);
+    }
+  } else if (shape == "fan_out") {
+    for (std::uint32_t i = 1; i < size; i++) {
+      preds[i].push_back(0u);
+    }
+  } else if (shape == "diamond") {
+    // Node 0 forks, every kDiamondWidth + 1 nodes after that are a layer of
+    //  forked nodes followed by the join (which forks the next diamond)
+    std::uint32_t fork = 0u;
+    for (std::uint32_t i = 1; i < size; i++) {
+      std::uint32_t pos = (i - 1) % (kDiamondWidth + 1);
+      if (pos < kDiamondWidth) {
+        preds[i].push_back(fork);
+        continue;
+      }
+      for (std::uint32_t j = i - kDiamondWidth; j < i; j++) {
+        preds[i].push_back(j);
+      }
+      fork = i;
+    }
+  } else if (shape == "random") {
+    for (std::uint32_t i = 1; i < size; i++) {
+      std::uniform_real_distribution<double> dist(0., 1.);
+      const double p = std::min(1., 2. / i);
+      for (std::uint32_t j = 0; j < i; j++) {
+        if (dist(rng) < p) preds[i].push_back(j);
+      }
+    }
+  }
+
+  return preds;
+}
+
+void run_body(std::uint32_t body_us) {
+  if (body_us == 0u) return;
+
+  auto end = Clock::now() + std::chrono::microseconds(body_us);
+  while (Clock::now() < end) {
+  }
+}
+
+igecs::Scheduler make_scheduler(
+    const Options& o, const std::string& shape, std::uint32_t size,
+    const std::vector<std::thread::id>& worker_thread_ids) {
+  std::mt19937 rng(o.seed);
+  std::uniform_int_distribution<std::uint32_t> component_dist(
+      0u, kComponentTypeCount - 1u);
+
+  auto builder = igecs::Scheduler::Builder("Scheduler bench");
+  builder.main_thread_id(std::this_thread::get_id());
+  builder.max_spin_time(std::chrono::seconds(10));
+  for (const auto& id : worker_thread_ids) {
+    builder.worker_thread_id(id);
+  }
+
+  const bool inferred = shape == "inferred";
+  builder.infer_dependencies(inferred);
+
+  auto preds = make_shape(shape, size, rng);
+  const std::uint32_t body_us = o.body_us;
+  std::vector<igecs::Scheduler::Node> nodes;
+  nodes.reserve(size);
+  for (std::uint32_t i = 0; i < size; i++) {
+    igecs::WorldView::Decl decl;
+    if (inferred) {
+      kReadFns[component_dist(rng)](decl);
+      kReadFns[component_dist(rng)](decl);
+      kWriteFns[component_dist(rng)](decl);
+    } else {
+      for (std::uint32_t r = 0; r < o.reads_per_node; r++) {
+        kReadFns[component_dist(rng)](decl);
+      }
+    }
+
+    auto node_builder = builder.add_node();
+    node_builder.with_decl(decl);
+    for (std::uint32_t pred : preds[i]) {
+      node_builder.depends_on(nodes[pred]);
+    }
+    nodes.push_back(node_builder.build(
+        [body_us](igecs::WorldView*) { run_body(body_us); },
+        igecs::CttiTypeId::of<BenchNode>(), "node_" + std::to_string(i)));
+  }
+
+  return builder.build();
+}
+
+struct FrameTimes {
+  double mean_us;
+  double min_us;
+};
+
+template <typename ExecFnT>
+FrameTimes time_frames(std::uint32_t frame_count, ExecFnT&& exec_frame) {
+  for (std::uint32_t i = 0; i < kWarmupFrames; i++) {
+    exec_frame();
+  }
+
+  FrameTimes times{0., 0.};
+  for (std::uint32_t i = 0; i < frame_count; i++) {
+    auto start = Clock::now();
+    exec_frame();
+    double us =
+        std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    times.mean_us += us;
+    times.min_us = i == 0 ? us : std::min(times.min_us, us);
+  }
+  times.mean_us /= std::max(frame_count, 1u);
+
+  return times;
+}
+
+FrameTimes run_case(const Options& o, const std::string& shape,
+                    std::uint32_t size, const std::string& executor,
+                    std::uint32_t thread_count,
+                    igecs::Scheduler::GraphStats& stats) {
+  // The main thread counts as one of the threads
+  const std::uint32_t worker_count = thread_count - 1u;
+  entt::registry world;
+
+  if (executor == "task_list") {
+    igasync::ThreadPool::Desc desc{};
+    desc.UseHardwareConcurrency = false;
+    desc.AdditionalThreads = static_cast<int>(worker_count);
+    auto thread_pool = igasync::ThreadPool::Create(desc);
+    auto any_thread = igasync::TaskList::Create();
+    thread_pool->add_task_list(any_thread);
+
+    auto scheduler = make_scheduler(o, shape, size, thread_pool->thread_ids());
+    stats = scheduler.graph_stats();
+    return time_frames(o.frames, [&] {
+      scheduler.execute(thread_count > 1u ? any_thread : nullptr, &world);
+    });
+  }
+
+  auto pool = igecs::WorkStealingPool::Create(worker_count);
+  auto scheduler = make_scheduler(o, shape, size, pool->thread_ids());
+  stats = scheduler.graph_stats();
+  return time_frames(o.frames, [&] { scheduler.execute(pool, &world); });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  if (!parse_options(argc, argv, o)) {
+    return 1;
+  }
+
+  nlohmann::json results = nlohmann::json::array();
+
+  std::cerr << std::setw(10) << "shape" << std::setw(7) << "nodes"
+            << std::setw(11) << "executor" << std::setw(9) << "threads"
+            << std::setw(12) << "frame_us" << std::setw(14) << "overhead_us"
+            << std::setw(12) << "cp_eff" << std::setw(10) << "scaling"
+            << "\n";
+
+  for (const auto& shape : o.shapes) {
+    for (std::uint32_t size : o.sizes) {
+      for (const auto& executor : o.executors) {
+        double baseline_us = 0.;
+        for (std::uint32_t thread_count : o.threads) {
+          if (thread_count == 0u) continue;
+
+          igecs::Scheduler::GraphStats stats{};
+          FrameTimes times =
+              run_case(o, shape, size, executor, thread_count, stats);
+
+          const double work_us = static_cast<double>(size) * o.body_us;
+          const double critical_path_us =
+              static_cast<double>(stats.critical_path_length) * o.body_us;
+          const double ideal_us =
+              std::max(critical_path_us, work_us / thread_count);
+          const double overhead_us = times.mean_us - ideal_us;
+          const double cp_efficiency =
+              times.mean_us > 0. ? critical_path_us / times.mean_us : 0.;
+          if (baseline_us == 0.) {
+            baseline_us = times.mean_us;
+          }
+          const double scaling =
+              times.mean_us > 0. ? baseline_us / times.mean_us : 0.;
+
+          nlohmann::json r;
+          r["shape"] = shape;
+          r["node_count"] = stats.node_count;
+          r["edge_count"] = stats.edge_count;
+          r["critical_path_length"] = stats.critical_path_length;
+          r["max_width"] = stats.max_width;
+          r["executor"] = executor;
+          r["threads"] = thread_count;
+          r["body_us"] = o.body_us;
+          r["reads_per_node"] = o.reads_per_node;
+          r["frames"] = o.frames;
+          r["frame_us_mean"] = times.mean_us;
+          r["frame_us_min"] = times.min_us;
+          r["ideal_frame_us"] = ideal_us;
+          r["overhead_us"] = overhead_us;
+          r["overhead_us_per_node"] = overhead_us / std::max(size, 1u);
+          r["critical_path_efficiency"] = cp_efficiency;
+          r["thread_scaling"] = scaling;
+          results.push_back(r);
+
+          std::cerr << std::fixed << std::setprecision(2) << std::setw(10)
+                    << shape << std::setw(7) << size << std::setw(11)
+                    << executor << std::setw(9) << thread_count
+                    << std::setw(12) << times.mean_us << std::setw(14)
+                    << overhead_us << std::setw(12) << cp_efficiency
+                    << std::setw(10) << scaling << "\n";
+        }
+      }
+    }
+  }
+
+  std::cout << results.dump(2) << std::endl;
+
+  return 0;
+}
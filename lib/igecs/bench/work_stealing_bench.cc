@@ -0,0 +1,273 @@
+/**
+ * Thread scaling benchmark for chunked, animation-shaped any-thread work.
+ *
+ * A single asynchronous system splits all entities into fixed-size chunks
+ *  (the same pattern used by the ozz animation systems in igdemo) and schedules
+ *  every chunk as its own task. Each entity walks a joint hierarchy and
+ *  computes model-space matrices from local matrices, which has a similar
+ *  memory/compute profile to ozz::animation::LocalToModelJob.
+ *
+ * The same frame graph is executed with a shared igasync::TaskList serviced by
+ *  an igasync::ThreadPool, and with an igecs::WorkStealingPool, for 1 to 32
+ *  threads (the main thread counts as one of the threads in both cases).
+ *
+ * A second table measures the cost of scheduling itself: every worker pushes
+ *  no-op jobs onto its own deque and drains them again, while the rest of the
+ *  pool does the same - the time per push (and run) should stay flat as
+ *  threads are added, since nothing shared is written along the way.
+ *
+ * Usage: igecs-work-stealing-bench [entity_count] [chunk_size] [frames]
+ */
+
+#include <igasync/promise_combiner.h>
+#include <igasync/thread_pool.h>
+#include <igecs/scheduler.h>
+#include <igecs/work_stealing_pool.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const std::uint32_t kJointCount = 64;
+
+struct Mat4 {
+  std::array<float, 16> m;
+};
+
+Mat4 mul(const Mat4& a, const Mat4& b) {
+  Mat4 r{};
+  for (int col = 0; col < 4; col++) {
+    for (int row = 0; row < 4; row++) {
+      float sum = 0.f;
+      for (int k = 0; k < 4; k++) {
+        sum += a.m[k * 4 + row] * b.m[col * 4 + k];
+      }
+      r.m[col * 4 + row] = sum;
+    }
+  }
+  return r;
+}
+
+struct BenchSkeleton {
+  std::array<Mat4, kJointCount> locals;
+  std::array<Mat4, kJointCount> models;
+  float sample_time;
+};
+
+struct CtxBenchParams {
+  std::uint32_t chunk_size;
+};
+
+void animate_entity(BenchSkeleton& skeleton) {
+  // Joint 0 is the root, every other joint is parented to the joint before it
+  //  - the real skeletons are wider, but the amount of work is comparable.
+  skeleton.sample_time += 0.016f;
+  for (std::uint32_t j = 0; j < kJointCount; j++) {
+    skeleton.locals[j].m[12] = skeleton.sample_time * 0.01f * j;
+    skeleton.models[j] = j == 0 ? skeleton.locals[0]
+                                : mul(skeleton.models[j - 1],
+                                      skeleton.locals[j]);
+  }
+}
+
+struct AnimateSkeletonsSystem {
+  static const igecs::WorldView::Decl& decl() {
+    static igecs::WorldView::Decl decl = igecs::WorldView::Decl()
+                                             .ctx_reads<CtxBenchParams>()
+                                             .writes<BenchSkeleton>();
+    return decl;
+  }
+
+  static std::shared_ptr<igasync::Promise<void>> run(
+      igecs::WorldView* wv,
+      std::shared_ptr<igasync::ExecutionContext> main_thread,
+      std::shared_ptr<igasync::ExecutionContext> any_thread,
+      std::function<void(igasync::TaskProfile profile)> profile_cb) {
+    auto process_list = std::make_shared<std::vector<entt::entity>>();
+    for (auto [e, skeleton] : wv->view<BenchSkeleton>().each()) {
+      process_list->push_back(e);
+    }
+
+    const std::uint32_t chunk_size = wv->ctx<CtxBenchParams>().chunk_size;
+    auto combiner = igasync::PromiseCombiner::Create();
+    for (std::uint32_t start = 0; start < process_list->size();
+         start += chunk_size) {
+      std::uint32_t ct = std::min(
+          chunk_size, static_cast<std::uint32_t>(process_list->size()) - start);
+
+      auto chunk_done = igasync::Promise<void>::Create();
+      any_thread->schedule(
+          igasync::Task::Of([wv, process_list, start, ct, chunk_done]() {
+            for (std::uint32_t i = start; i < start + ct; i++) {
+              animate_entity(wv->write<BenchSkeleton>((*process_list)[i]));
+            }
+            chunk_done->resolve();
+          }));
+      combiner->add(chunk_done, any_thread);
+    }
+
+    return combiner->combine([](auto) {}, any_thread);
+  }
+};
+
+std::unique_ptr<entt::registry> make_world(std::uint32_t entity_count,
+                                           std::uint32_t chunk_size) {
+  auto world = std::make_unique<entt::registry>();
+  world->ctx().emplace<CtxBenchParams>(CtxBenchParams{chunk_size});
+
+  Mat4 identity{};
+  for (int i = 0; i < 4; i++) identity.m[i * 4 + i] = 1.f;
+
+  for (std::uint32_t i = 0; i < entity_count; i++) {
+    auto e = world->create();
+    auto& skeleton = world->emplace<BenchSkeleton>(e);
+    skeleton.locals.fill(identity);
+    skeleton.sample_time = 0.f;
+  }
+
+  return world;
+}
+
+igecs::Scheduler make_scheduler(
+    const std::vector<std::thread::id>& worker_thread_ids) {
+  auto builder = igecs::Scheduler::Builder("Work stealing bench");
+  builder.main_thread_id(std::this_thread::get_id());
+  builder.max_spin_time(std::chrono::seconds(10));
+  for (const auto& id : worker_thread_ids) {
+    builder.worker_thread_id(id);
+  }
+  auto n = builder.add_node().build<AnimateSkeletonsSystem>();
+  return builder.build();
+}
+
+template <typename ExecFnT>
+double time_frames(std::uint32_t frame_count, ExecFnT&& exec_frame) {
+  // Warmup - let threads spin up and caches settle
+  for (std::uint32_t i = 0; i < 5; i++) {
+    exec_frame();
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (std::uint32_t i = 0; i < frame_count; i++) {
+    exec_frame();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - start).count() /
+         frame_count;
+}
+
+const std::uint32_t kPushesPerWorker = 200000;
+
+void noop_job(igecs::WorkStealingPool::Job*) {}
+
+struct PushRound {
+  igecs::WorkStealingPool* pool;
+  igecs::WorkStealingPool::Job noop;
+  std::atomic_uint32_t remaining_workers;
+};
+
+// Nanoseconds per push (and run) of a job on a worker's own deque, with every
+//  worker of the pool doing the same at once
+double time_own_deque_pushes(std::uint32_t worker_count) {
+  auto pool = igecs::WorkStealingPool::Create(worker_count);
+  PushRound round{pool.get(), {&noop_job}, {worker_count}};
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (std::uint32_t i = 0; i < worker_count; i++) {
+    pool->schedule(igasync::Task::Of([&round]() {
+      for (std::uint32_t p = 0; p < kPushesPerWorker; p++) {
+        round.pool->schedule(&round.noop);
+        if (p % 64u == 63u) {
+          while (round.pool->execute_next()) {
+          }
+        }
+      }
+      while (round.pool->execute_next()) {
+      }
+      round.remaining_workers.fetch_sub(1u, std::memory_order_acq_rel);
+    }));
+  }
+  while (round.remaining_workers.load(std::memory_order_acquire) > 0u) {
+    std::this_thread::yield();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         (static_cast<double>(worker_count) * kPushesPerWorker);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::uint32_t entity_count = argc > 1 ? std::atoi(argv[1]) : 4000;
+  std::uint32_t chunk_size = argc > 2 ? std::atoi(argv[2]) : 20;
+  std::uint32_t frame_count = argc > 3 ? std::atoi(argv[3]) : 100;
+
+  std::cout << "Chunked animation workload: " << entity_count
+            << " entities, chunk size " << chunk_size << ", " << frame_count
+            << " frames (hardware_concurrency="
+            << std::thread::hardware_concurrency() << ")\n\n";
+  std::cout << std::setw(8) << "threads" << std::setw(16) << "task_list_ms"
+            << std::setw(12) << "speedup" << std::setw(16) << "stealing_ms"
+            << std::setw(12) << "speedup" << "\n";
+
+  double task_list_baseline = 0.0;
+  double stealing_baseline = 0.0;
+  for (std::uint32_t thread_count : {1u, 2u, 4u, 8u, 16u, 32u}) {
+    const std::uint32_t worker_count = thread_count - 1;
+
+    double task_list_ms = 0.0;
+    {
+      igasync::ThreadPool::Desc desc{};
+      desc.UseHardwareConcurrency = false;
+      desc.AdditionalThreads = static_cast<int>(worker_count);
+      auto thread_pool = igasync::ThreadPool::Create(desc);
+      auto any_thread = igasync::TaskList::Create();
+      thread_pool->add_task_list(any_thread);
+
+      auto world = make_world(entity_count, chunk_size);
+      auto scheduler = make_scheduler(thread_pool->thread_ids());
+      task_list_ms = time_frames(
+          frame_count, [&] { scheduler.execute(any_thread, world.get()); });
+    }
+
+    double stealing_ms = 0.0;
+    {
+      auto pool = igecs::WorkStealingPool::Create(worker_count);
+
+      auto world = make_world(entity_count, chunk_size);
+      auto scheduler = make_scheduler(pool->thread_ids());
+      stealing_ms = time_frames(frame_count,
+                                [&] { scheduler.execute(pool, world.get()); });
+    }
+
+    if (thread_count == 1u) {
+      task_list_baseline = task_list_ms;
+      stealing_baseline = stealing_ms;
+    }
+
+    std::cout << std::fixed << std::setprecision(3) << std::setw(8)
+              << thread_count << std::setw(16) << task_list_ms << std::setw(12)
+              << task_list_baseline / task_list_ms << std::setw(16)
+              << stealing_ms << std::setw(12)
+              << stealing_baseline / stealing_ms << "\n";
+  }
+
+  std::cout << "\nOwn deque push + run: " << kPushesPerWorker
+            << " jobs per worker\n\n";
+  std::cout << std::setw(8) << "workers" << std::setw(12) << "push_ns"
+            << "\n";
+  for (std::uint32_t worker_count : {1u, 2u, 4u, 8u, 16u, 32u}) {
+    std::cout << std::fixed << std::setprecision(3) << std::setw(8)
+              << worker_count << std::setw(12)
+              << time_own_deque_pushes(worker_count) << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,282 @@
+#ifndef IGECS_CHANGE_TRACKER_H
+#define IGECS_CHANGE_TRACKER_H
+
+#include <igecs/ctti_type_id.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+namespace igecs {
+
+/**
+ * Component types opt in to change tracking by declaring
+ *  static constexpr bool kTrackChanges = true;
+ *
+ * Writes to tracked components through a WorldView (write, attach, mutable
+ *  views, deferred attaches) stamp the entity with the change clock, and
+ *  WorldView::changed_view visits only entities stamped since a version.
+ *  Tracking also has to be set up for each registry, see track_changes.
+ */
+template <typename T>
+concept TrackedComponent = T::kTrackChanges;
+
+/**
+ * Monotonic clock for change tracking. Every WorldView takes a new version
+ *  when it is created or reset (i.e. every time a node runs), and writes are
+ *  stamped with the clock as it reads at the time of the write - so a change
+ *  stamped at or after a version happened after the view that took that
+ *  version started.
+ */
+class ChangeClock {
+ public:
+  static std::uint64_t now();
+  static std::uint64_t tick();
+};
+
+/**
+ * Change stamps of one component type, by entity index. Stamps of distinct
+ *  entities may be written concurrently - entity indices beyond kMaxEntities
+ *  are not tracked, and always read as changed.
+ */
+class ComponentVersions {
+ public:
+  static constexpr std::uint32_t kPageSize = 4096u;
+  static constexpr std::uint32_t kMaxEntities = 1u << 20;
+
+  ComponentVersions();
+  ~ComponentVersions();
+  ComponentVersions(const ComponentVersions&) = delete;
+  ComponentVersions& operator=(const ComponentVersions&) = delete;
+
+  void stamp(entt::entity e, std::uint64_t version);
+
+  /** Mark every entity as changed - used for mutable views */
+  void stamp_all(std::uint64_t version);
+
+  [[nodiscard]] bool changed_since(entt::entity e, std::uint64_t since) const;
+
+ private:
+  static constexpr std::uint32_t kPageCount = kMaxEntities / kPageSize;
+
+  // Pages are allocated on first write, and installed with a CAS so that
+  //  writers on several threads never need a lock
+  std::array<std::atomic<std::uint64_t*>, kPageCount> pages_;
+  std::atomic_uint64_t all_version_;
+};
+
+/**
+ * Registry context entry holding the ComponentVersions of every tracked
+ *  component type, by CttiTypeId index. WorldView looks this up once when it
+ *  is created or reset, so stamping a write is an index instead of a context
+ *  lookup.
+ */
+class CtxChangeTracking {
+ public:
+  /** Start tracking the type with that CttiTypeId index (if not already) */
+  void track(std::uint32_t type_index);
+
+  /** nullptr if the type is not tracked */
+  ComponentVersions* find(std::uint32_t type_index) const {
+    return type_index < versions_.size() ? versions_[type_index].get()
+                                         : nullptr;
+  }
+
+ private:
+  std::vector<std::unique_ptr<ComponentVersions>> versions_;
+};
+
+[[noreturn]] void change_tracking_missing(const std::string& type_name);
+
+/**
+ * Set up change tracking of component type T for a registry - call before
+ *  any system writes T, along with the rest of the world setup
+ */
+template <TrackedComponent T>
+void track_changes(entt::registry& registry) {
+  if (!registry.ctx().contains<CtxChangeTracking>()) {
+    registry.ctx().emplace<CtxChangeTracking>();
+  }
+  registry.ctx().get<CtxChangeTracking>().track(
+      CttiTypeId::index_of<std::remove_const_t<T>>());
+}
+
+/**
+ * Versions of tracked component type T - fails loudly if track_changes<T> was
+ *  not called for the registry tracking belongs to
+ */
+template <TrackedComponent T>
+ComponentVersions& tracked_versions(const CtxChangeTracking* tracking) {
+  using ComponentT = std::remove_const_t<T>;
+  ComponentVersions* versions =
+      tracking != nullptr
+          ? tracking->find(CttiTypeId::index_of<ComponentT>())
+          : nullptr;
+  if (versions == nullptr) [[unlikely]] {
+    change_tracking_missing(CttiTypeId::GetName<ComponentT>());
+  }
+  return *versions;
+}
+
+/** Stamp a write to a tracked component (no-op for untracked types) */
+template <typename T>
+void mark_changed(const CtxChangeTracking* tracking, entt::entity e) {
+  if constexpr (TrackedComponent<T>) {
+    tracked_versions<T>(tracking).stamp(e, ChangeClock::now());
+  }
+}
+
+template <typename T>
+void mark_changed(entt::registry& registry, entt::entity e) {
+  if constexpr (TrackedComponent<T>) {
+    mark_changed<T>(registry.ctx().find<CtxChangeTracking>(), e);
+  }
+}
+
+/** Stamp every entity of a tracked component (no-op for untracked types) */
+template <typename T>
+void mark_all_changed(const CtxChangeTracking* tracking) {
+  if constexpr (TrackedComponent<T>) {
+    tracked_versions<T>(tracking).stamp_all(ChangeClock::now());
+  }
+}
+
+/**
+ * Wrapper around an entt view that only visits entities with at least one
+ *  tracked component changed since a version (see WorldView::changed_view).
+ *  Iterates like the view it wraps - range-for gives entities, each() gives
+ *  (entity, components...) tuples.
+ */
+template <typename ViewT, std::size_t N>
+class ChangedView {
+ public:
+  using Versions = std::array<const ComponentVersions*, N>;
+
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = entt::entity;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const entt::entity*;
+    using reference = entt::entity;
+
+    iterator() : cv_(nullptr), pos_(0u), end_(0u) {}
+    iterator(const ChangedView* cv, std::uint32_t pos, std::uint32_t end)
+        : cv_(cv), pos_(pos), end_(end) {
+      skip_unchanged();
+    }
+
+    entt::entity operator*() const {
+      return cv_->view_.handle()->data()[pos_];
+    }
+
+    iterator& operator++() {
+      pos_++;
+      skip_unchanged();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator orig = *this;
+      ++(*this);
+      return orig;
+    }
+
+    bool operator==(const iterator& o) const { return pos_ == o.pos_; }
+    bool operator!=(const iterator& o) const { return pos_ != o.pos_; }
+
+   private:
+    void skip_unchanged() {
+      while (pos_ < end_ && !cv_->contains(**this)) {
+        pos_++;
+      }
+    }
+
+    const ChangedView* cv_;
+    std::uint32_t pos_;
+    std::uint32_t end_;
+  };
+
+  class each_iterable {
+   public:
+    class each_iterator {
+     public:
+      each_iterator(iterator it, const ViewT* view) : it_(it), view_(view) {}
+
+      auto operator*() const {
+        entt::entity e = *it_;
+        return std::tuple_cat(std::make_tuple(e), view_->get(e));
+      }
+
+      each_iterator& operator++() {
+        ++it_;
+        return *this;
+      }
+
+      bool operator==(const each_iterator& o) const { return it_ == o.it_; }
+      bool operator!=(const each_iterator& o) const { return it_ != o.it_; }
+
+     private:
+      iterator it_;
+      const ViewT* view_;
+    };
+
+    each_iterable(const ChangedView* cv) : cv_(cv) {}
+
+    each_iterator begin() const { return {cv_->begin(), &cv_->view_}; }
+    each_iterator end() const { return {cv_->end(), &cv_->view_}; }
+
+   private:
+    const ChangedView* cv_;
+  };
+
+  ChangedView(ViewT view, Versions versions, std::uint64_t since)
+      : view_(view), versions_(versions), since_(since) {}
+
+  iterator begin() const { return iterator(this, 0u, size()); }
+  iterator end() const { return iterator(this, size(), size()); }
+
+  each_iterable each() const { return each_iterable(this); }
+
+  template <typename... Component>
+  decltype(auto) get(entt::entity e) const {
+    return view_.template get<Component...>(e);
+  }
+
+  /** True if the entity is in the view, and changed since the version */
+  bool contains(entt::entity e) const {
+    if (!view_.contains(e)) {
+      return false;
+    }
+    for (const ComponentVersions* versions : versions_) {
+      if (versions->changed_since(e, since_)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const ViewT& view() const { return view_; }
+
+ private:
+  std::uint32_t size() const {
+    return static_cast<std::uint32_t>(view_.handle()->size());
+  }
+
+  ViewT view_;
+  Versions versions_;
+  std::uint64_t since_;
+};
+
+}  // namespace igecs
+
+#endif
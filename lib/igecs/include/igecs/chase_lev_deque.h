@@ -0,0 +1,152 @@
+#ifndef IGECS_CHASE_LEV_DEQUE_H
+#define IGECS_CHASE_LEV_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace igecs {
+
+/**
+ * Chase-Lev work stealing deque (Le, Pop, Cohen, Nardelli - "Correct and
+ *  Efficient Work-Stealing for Weak Memory Models", PPoPP 2013)
+ *
+ * Exactly one thread (the owner) may push() and pop(), which operate on the
+ *  bottom of the deque in LIFO order. Any number of other threads may steal(),
+ *  which takes from the top of the deque in FIFO order.
+ *
+ * T must be trivially copyable (in practice, a pointer). Buffers grow on
+ *  demand; retired buffers are kept alive until the deque is destroyed, since a
+ *  concurrent thief may still be reading from them.
+ */
+template <typename T>
+class ChaseLevDeque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "ChaseLevDeque elements must be trivially copyable");
+
+  struct Buffer {
+    explicit Buffer(std::int64_t log_capacity)
+        : capacity(std::int64_t{1} << log_capacity),
+          mask(capacity - 1),
+          data(new std::atomic<T>[capacity]) {}
+
+    T get(std::int64_t i) const {
+      return data[i & mask].load(std::memory_order_relaxed);
+    }
+    void put(std::int64_t i, T v) {
+      data[i & mask].store(v, std::memory_order_relaxed);
+    }
+
+    std::int64_t capacity;
+    std::int64_t mask;
+    std::unique_ptr<std::atomic<T>[]> data;
+  };
+
+ public:
+  explicit ChaseLevDeque(std::int64_t log_initial_capacity = 8)
+      : top_(0), bottom_(0) {
+    buffers_.push_back(std::make_unique<Buffer>(log_initial_capacity));
+    buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+  }
+
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  /** Owner only - push an element onto the bottom of the deque */
+  void push(T v) {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+      a = grow(a, t, b);
+    }
+    a->put(b, v);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /** Owner only - take the most recently pushed element, if there is one */
+  bool pop(T& out) {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      // Empty deque
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    out = a->get(b);
+    if (t == b) {
+      // Last element - race against thieves for it
+      bool won = top_.compare_exchange_strong(t, t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  /** Any thread - take the oldest element, if there is one */
+  bool steal(T& out) {
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t b = bottom_.load(std::memory_order_acquire);
+
+    if (t >= b) {
+      return false;
+    }
+
+    Buffer* a = buffer_.load(std::memory_order_acquire);
+    T v = a->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      // Lost the race to another thief (or the owner)
+      return false;
+    }
+    out = v;
+    return true;
+  }
+
+  /** Approximate number of elements - exact only when called by the owner */
+  std::int64_t size_approx() const {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+    return b > t ? b - t : 0;
+  }
+
+ private:
+  Buffer* grow(Buffer* a, std::int64_t t, std::int64_t b) {
+    std::int64_t log_capacity = 0;
+    while ((std::int64_t{1} << log_capacity) < a->capacity * 2) {
+      log_capacity++;
+    }
+
+    auto next = std::make_unique<Buffer>(log_capacity);
+    for (std::int64_t i = t; i < b; i++) {
+      next->put(i, a->get(i));
+    }
+
+    Buffer* rsl = next.get();
+    buffers_.push_back(std::move(next));
+    buffer_.store(rsl, std::memory_order_release);
+    return rsl;
+  }
+
+  alignas(64) std::atomic<std::int64_t> top_;
+  alignas(64) std::atomic<std::int64_t> bottom_;
+  alignas(64) std::atomic<Buffer*> buffer_;
+
+  // Owned by the owner thread - only ever appended to in grow()
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+}  // namespace igecs
+
+#endif
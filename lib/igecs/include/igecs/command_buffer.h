@@ -0,0 +1,163 @@
+#ifndef IGECS_COMMAND_BUFFER_H
+#define IGECS_COMMAND_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "change_tracker.h"
+
+namespace igecs {
+
+/**
+ * Structural changes to a registry (creating and destroying entities, adding
+ *  and removing components), recorded to be applied later by a single thread.
+ *  entt does not allow structural changes from several threads at once, so
+ *  systems that run on several threads (e.g. partitioned nodes) record them
+ *  here instead - see WorldView::defer_create and friends.
+ *
+ * Commands are applied in the order they were recorded. Recording is not
+ *  thread safe, every WorldView has its own buffer. Memory for commands and
+ *  component payloads is kept between play backs, so a warmed up buffer
+ *  records without allocating.
+ */
+class CommandBuffer {
+ public:
+  /** Entity created by a recorded create command that has not run yet */
+  struct DeferredEntity {
+    std::uint32_t index;
+  };
+
+  /** Either an existing entity, or one created by an earlier command */
+  struct Target {
+    Target(entt::entity e) : entity(e), created_index(0u) {}
+    Target(DeferredEntity e) : entity(entt::null), created_index(e.index) {}
+
+    entt::entity entity;
+    std::uint32_t created_index;
+  };
+
+  CommandBuffer();
+  ~CommandBuffer();
+  CommandBuffer(const CommandBuffer&) = delete;
+  CommandBuffer& operator=(const CommandBuffer&) = delete;
+  CommandBuffer(CommandBuffer&&) = default;
+
+  DeferredEntity create();
+  void destroy(entt::entity e);
+
+  template <typename ComponentT, typename... Args>
+  void attach(Target e, Args&&... args) {
+    record<ComponentT>(e, &CommandBuffer::emplace_fn<ComponentT>,
+                       std::forward<Args>(args)...);
+  }
+
+  template <typename ComponentT, typename... Args>
+  void attach_or_replace(Target e, Args&&... args) {
+    record<ComponentT>(e, &CommandBuffer::emplace_or_replace_fn<ComponentT>,
+                       std::forward<Args>(args)...);
+  }
+
+  template <typename ComponentT>
+  void remove(Target e) {
+    commands_.push_back(Command{&CommandBuffer::remove_fn<ComponentT>, nullptr,
+                                nullptr, e.entity, e.created_index});
+  }
+
+  [[nodiscard]] bool empty() const { return commands_.empty(); }
+  [[nodiscard]] std::size_t size() const { return commands_.size(); }
+
+  /**
+   * Apply every recorded command to the registry, and clear the buffer.
+   *  Commands on entities that are no longer valid by the time they run (e.g.
+   *  destroyed by an earlier command, or by another system) are skipped.
+   */
+  void play_back(entt::registry& registry);
+
+  /** Drop every recorded command without applying it */
+  void clear();
+
+ private:
+  // Payloads are placed in fixed size blocks that never move, so components
+  //  do not have to be trivially relocatable
+  static constexpr std::size_t kBlockSize = 4096u;
+
+  using ApplyFn = void (*)(entt::registry&, entt::entity, void* payload);
+  using DropFn = void (*)(void* payload);
+
+  // apply == nullptr marks a create command
+  struct Command {
+    ApplyFn apply;
+    DropFn drop;
+    void* payload;
+    entt::entity entity;
+    std::uint32_t created_index;
+  };
+
+  template <typename ComponentT, typename... Args>
+  void record(Target e, ApplyFn apply, Args&&... args) {
+    static_assert(sizeof(ComponentT) <= kBlockSize &&
+                      alignof(ComponentT) <= alignof(std::max_align_t),
+                  "Component too large to record in a CommandBuffer");
+
+    void* payload = allocate(sizeof(ComponentT), alignof(ComponentT));
+    if constexpr (std::is_aggregate_v<ComponentT>) {
+      new (payload) ComponentT{std::forward<Args>(args)...};
+    } else {
+      new (payload) ComponentT(std::forward<Args>(args)...);
+    }
+
+    DropFn drop = nullptr;
+    if constexpr (!std::is_trivially_destructible_v<ComponentT>) {
+      drop = &CommandBuffer::drop_fn<ComponentT>;
+    }
+    commands_.push_back(
+        Command{apply, drop, payload, e.entity, e.created_index});
+  }
+
+  template <typename ComponentT>
+  static void emplace_fn(entt::registry& r, entt::entity e, void* payload) {
+    r.emplace<ComponentT>(e, std::move(*static_cast<ComponentT*>(payload)));
+    mark_changed<ComponentT>(r, e);
+  }
+
+  template <typename ComponentT>
+  static void emplace_or_replace_fn(entt::registry& r, entt::entity e,
+                                    void* payload) {
+    r.emplace_or_replace<ComponentT>(
+        e, std::move(*static_cast<ComponentT*>(payload)));
+    mark_changed<ComponentT>(r, e);
+  }
+
+  template <typename ComponentT>
+  static void remove_fn(entt::registry& r, entt::entity e, void*) {
+    r.remove<ComponentT>(e);
+  }
+
+  template <typename ComponentT>
+  static void drop_fn(void* payload) {
+    static_cast<ComponentT*>(payload)->~ComponentT();
+  }
+
+  static void destroy_fn(entt::registry& r, entt::entity e, void*);
+
+  void* allocate(std::size_t size, std::size_t align);
+
+  std::vector<Command> commands_;
+  std::uint32_t create_count_;
+  std::vector<entt::entity> created_;
+
+  std::vector<std::unique_ptr<std::byte[]>> blocks_;
+  std::size_t used_blocks_;
+  std::size_t block_offset_;
+};
+
+}  // namespace igecs
+
+#endif
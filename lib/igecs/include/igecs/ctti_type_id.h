@@ -61,6 +61,16 @@ struct CttiTypeId {
     return CttiTypeId{CttiTypeId::tid<T>(), name};
   }
 
+  /**
+   * Same value as of<T>().id, without looking up the type name. Ids are handed
+   *  out densely starting from 0, so they can index into a bitset (see
+   *  CttiTypeSet).
+   */
+  template <typename T>
+  static uint32_t index_of() {
+    return CttiTypeId::tid<T>();
+  }
+
   template <typename T>
   static std::string GetName() {
 #ifdef _MSC_VER
@@ -0,0 +1,137 @@
+#ifndef IGECS_CTTI_TYPE_SET_H
+#define IGECS_CTTI_TYPE_SET_H
+
+#include <igecs/ctti_type_id.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace igecs {
+
+/**
+ * Called when a type id does not fit in a CttiTypeSet - aborts in every build,
+ *  since the bitsets of Decls (and the scheduler's conflict checks) are built
+ *  in release builds too
+ */
+[[noreturn]] inline void ctti_type_set_overflow(const char* set_name,
+                                                std::uint32_t id,
+                                                std::uint32_t capacity) {
+  std::fprintf(stderr,
+               "[IgECS::%s] Type id %u out of range (capacity %u) - too many "
+               "types, raise CttiTypeSet::kCapacity\n",
+               set_name, id, capacity);
+  std::abort();
+}
+
+/**
+ * Fixed-size bitset of CttiTypeIds, indexed by CttiTypeId::id (ids are handed
+ *  out densely from 0, see CttiTypeId::index_of). Membership tests, unions and
+ *  intersection tests are a handful of word-wide operations - used by
+ *  WorldView::Decl so that access checks and scheduler conflict tests do not
+ *  have to search lists of types.
+ */
+class CttiTypeSet {
+ public:
+  /** Upper bound on the number of distinct types (components, ctx types,
+   *  events, systems) that may be given a CttiTypeId */
+  static constexpr std::uint32_t kCapacity = 512u;
+
+  CttiTypeSet() : words_{} {}
+
+  void insert(std::uint32_t id) {
+    if (id >= kCapacity) [[unlikely]] {
+      ctti_type_set_overflow("CttiTypeSet", id, kCapacity);
+    }
+    words_[id / 64u] |= 1ull << (id % 64u);
+  }
+
+  void insert(const CttiTypeId& id) { insert(id.id); }
+
+  [[nodiscard]] bool contains(std::uint32_t id) const {
+    return id < kCapacity && ((words_[id / 64u] >> (id % 64u)) & 1ull);
+  }
+
+  [[nodiscard]] bool contains(const CttiTypeId& id) const {
+    return contains(id.id);
+  }
+
+  [[nodiscard]] bool intersects(const CttiTypeSet& o) const {
+    for (std::uint32_t i = 0; i < kWords; i++) {
+      if (words_[i] & o.words_[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  [[nodiscard]] bool empty() const {
+    for (std::uint32_t i = 0; i < kWords; i++) {
+      if (words_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  CttiTypeSet& operator|=(const CttiTypeSet& o) {
+    for (std::uint32_t i = 0; i < kWords; i++) {
+      words_[i] |= o.words_[i];
+    }
+    return *this;
+  }
+
+  bool operator==(const CttiTypeSet& o) const { return words_ == o.words_; }
+  bool operator!=(const CttiTypeSet& o) const { return words_ != o.words_; }
+
+ private:
+  static constexpr std::uint32_t kWords = kCapacity / 64u;
+
+  std::array<std::uint64_t, kWords> words_;
+};
+
+/**
+ * CttiTypeSet that may be inserted into from several threads at once without
+ *  locking. An insert only writes if the bit is not set yet, so once a type
+ *  has been recorded, recording it again is a single relaxed load of a cache
+ *  line every thread keeps shared.
+ */
+class AtomicCttiTypeSet {
+ public:
+  AtomicCttiTypeSet() : words_{} {}
+  AtomicCttiTypeSet(const AtomicCttiTypeSet&) = delete;
+  AtomicCttiTypeSet& operator=(const AtomicCttiTypeSet&) = delete;
+
+  void insert(std::uint32_t id) {
+    if (id >= CttiTypeSet::kCapacity) [[unlikely]] {
+      ctti_type_set_overflow("AtomicCttiTypeSet", id, CttiTypeSet::kCapacity);
+    }
+    const std::uint64_t bit = 1ull << (id % 64u);
+    std::atomic_uint64_t& word = words_[id / 64u];
+    if ((word.load(std::memory_order_relaxed) & bit) == 0ull) {
+      word.fetch_or(bit, std::memory_order_relaxed);
+    }
+  }
+
+  [[nodiscard]] bool contains(std::uint32_t id) const {
+    return id < CttiTypeSet::kCapacity &&
+           ((words_[id / 64u].load(std::memory_order_relaxed) >> (id % 64u)) &
+            1ull);
+  }
+
+  /** Not safe to call while other threads insert */
+  void clear() {
+    for (auto& word : words_) {
+      word.store(0ull, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  std::array<std::atomic_uint64_t, CttiTypeSet::kCapacity / 64u> words_;
+};
+
+}  // namespace igecs
+
+#endif
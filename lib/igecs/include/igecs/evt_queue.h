@@ -1,15 +1,310 @@
 #ifndef IGECS_EVT_QUEUE_H
 #define IGECS_EVT_QUEUE_H
 
-#include <concurrentqueue.h>
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
 
 namespace igecs {
 
+/**
+ * Multi-producer, single-consumer event channel, drained once per frame (or
+ *  tick) by the system that consumes the event type.
+ *
+ * Events are written into a frame arena: producer threads each reserve blocks
+ *  of kBlockSize slots in a shared array (one atomic operation per block, see
+ *  ProducerToken) and fill them without contention. consume() closes the
+ *  holes left by partly filled blocks and hands out the events as one
+ *  contiguous span - only events moved into holes are copied, at most one
+ *  partial block per producer thread.
+ *
+ * The arena is sized by the consumer to fit the traffic of earlier frames.
+ *  Events that do not fit go to a locked overflow list, which is only used
+ *  until the arena has grown to fit.
+ */
+template <typename T>
+class EventChannel {
+ public:
+  static_assert(std::is_default_constructible_v<T> &&
+                    std::is_move_assignable_v<T>,
+                "Events must be default constructible and move assignable");
+
+  static constexpr std::uint32_t kBlockSize = 64u;
+
+  EventChannel()
+      : generation_(next_generation()), block_count_(0u), next_block_(0u) {}
+  EventChannel(const EventChannel&) = delete;
+  EventChannel& operator=(const EventChannel&) = delete;
+
+  /** Thread safe against other producers - not against consume() */
+  void enqueue(T evt) {
+    ProducerToken& token = producer_token();
+    if (token.next == token.end && !reserve_block(token)) {
+      std::lock_guard<std::mutex> l(overflow_lock_);
+      overflow_.push_back(std::move(evt));
+      return;
+    }
+
+    arena_[token.next++] = std::move(evt);
+    block_counts_[token.block].count++;
+  }
+
+  /** Enqueue several events at once - copies a block at a time */
+  void enqueue_bulk(std::span<const T> events) {
+    ProducerToken& token = producer_token();
+    while (!events.empty()) {
+      if (token.next == token.end && !reserve_block(token)) {
+        std::lock_guard<std::mutex> l(overflow_lock_);
+        overflow_.insert(overflow_.end(), events.begin(), events.end());
+        return;
+      }
+
+      const std::size_t count =
+          std::min<std::size_t>(events.size(), token.end - token.next);
+      std::copy_n(events.begin(), count, arena_.begin() + token.next);
+      token.next += static_cast<std::uint32_t>(count);
+      block_counts_[token.block].count += static_cast<std::uint32_t>(count);
+      events = events.subspan(count);
+    }
+  }
+
+  /**
+   * Every event enqueued since the last consume, in no particular order. The
+   *  span stays valid until events are enqueued again - consumers never run
+   *  alongside producers of the same event type, so that is at least until the
+   *  consuming system is done.
+   */
+  std::span<T> consume() {
+    const std::uint32_t used_blocks =
+        std::min(next_block_.load(std::memory_order_acquire), block_count_);
+
+    // Fill holes at the end of partly filled blocks with events from the back
+    std::uint32_t lo = 0u;
+    std::uint32_t hi = used_blocks * kBlockSize;
+    while (true) {
+      while (lo < hi && is_filled(lo)) lo++;
+      while (hi > lo && !is_filled(hi - 1u)) hi--;
+      if (lo >= hi) break;
+      arena_[lo++] = std::move(arena_[--hi]);
+    }
+    std::uint32_t event_count = lo;
+
+    for (std::uint32_t b = 0u; b < used_blocks; b++) {
+      block_counts_[b].count = 0u;
+    }
+
+    // Grow the arena to fit this frame's traffic twice over - the next frame
+    //  should not need the overflow list
+    const std::size_t overflow_count = overflow_.size();
+    const std::size_t total = event_count + overflow_count;
+    if (overflow_count > 0u) {
+      std::size_t capacity = std::max<std::size_t>(total * 2u, kBlockSize);
+      capacity = (capacity + kBlockSize - 1u) / kBlockSize * kBlockSize;
+      if (capacity > arena_.size()) {
+        arena_.resize(capacity);
+        block_counts_.resize(capacity / kBlockSize);
+        block_count_ = static_cast<std::uint32_t>(block_counts_.size());
+      }
+
+      std::move(overflow_.begin(), overflow_.end(),
+                arena_.begin() + event_count);
+      overflow_.clear();
+    }
+
+    // Outstanding producer tokens point into the old blocks
+    next_block_.store(0u, std::memory_order_relaxed);
+    generation_ = next_generation();
+
+    return std::span<T>(arena_.data(), total);
+  }
+
+ private:
+  // Blocks reserved by one thread, for the channel generation it was made for
+  struct ProducerToken {
+    std::uint64_t generation;
+    std::uint32_t block;
+    std::uint32_t next;
+    std::uint32_t end;
+  };
+
+  // Each block count is only written by the thread that reserved the block
+  struct alignas(64) BlockCount {
+    std::uint32_t count;
+  };
+
+  // Generations are unique across channels of the same type, so a token is
+  //  never mistaken for a token of another channel
+  static std::uint64_t next_generation() {
+    static std::atomic_uint64_t generation = 1u;
+    return generation.fetch_add(1u, std::memory_order_relaxed);
+  }
+
+  ProducerToken& producer_token() {
+    thread_local ProducerToken token{0u, 0u, 0u, 0u};
+    if (token.generation != generation_) {
+      token = ProducerToken{generation_, 0u, 0u, 0u};
+    }
+    return token;
+  }
+
+  bool reserve_block(ProducerToken& token) {
+    // Keeps producers from hammering the counter once the arena is full
+    if (next_block_.load(std::memory_order_relaxed) >= block_count_) {
+      return false;
+    }
+
+    const std::uint32_t block =
+        next_block_.fetch_add(1u, std::memory_order_relaxed);
+    if (block >= block_count_) {
+      return false;
+    }
+
+    token.block = block;
+    token.next = block * kBlockSize;
+    token.end = token.next + kBlockSize;
+    return true;
+  }
+
+  bool is_filled(std::uint32_t slot) const {
+    return slot % kBlockSize < block_counts_[slot / kBlockSize].count;
+  }
+
+  // Written by the consumer, read by producers - consumers and producers of
+  //  an event type never run at the same time
+  std::uint64_t generation_;
+  std::vector<T> arena_;
+  std::vector<BlockCount> block_counts_;
+  std::uint32_t block_count_;
+
+  std::atomic_uint32_t next_block_;
+
+  std::mutex overflow_lock_;
+  std::vector<T> overflow_;
+};
+
+/**
+ * Event type with set semantics - at most one event per entity key is kept
+ *  between consumes, e.g. requests to destroy an entity. Keyed event types
+ *  are declared with WorldView::Decl::keyed_evt_writes.
+ */
+template <typename T>
+concept KeyedEvent = requires(const T& evt) {
+  { evt.key() } -> std::convertible_to<entt::entity>;
+};
+
+/**
+ * EventChannel that drops events for entities that already have an event
+ *  queued (the first event enqueued wins). Keys are tracked in a lock-free
+ *  bitset over entity indices - one atomic fetch_or per event.
+ *
+ * Keys compare by entity index only. Entity indices are not recycled before
+ *  the destroyed entity's events are consumed, so this is not a problem for
+ *  the destroy requests keyed events are meant for.
+ */
+template <KeyedEvent T>
+class KeyedEventChannel {
+ public:
+  KeyedEventChannel() : word_count_(0u) {}
+  KeyedEventChannel(const KeyedEventChannel&) = delete;
+  KeyedEventChannel& operator=(const KeyedEventChannel&) = delete;
+
+  /** False if an event with the same key was already queued */
+  bool enqueue(T evt) {
+    if (!mark(index_of(evt))) {
+      return false;
+    }
+
+    events_.enqueue(std::move(evt));
+    return true;
+  }
+
+  void enqueue_bulk(std::span<const T> events) {
+    for (const T& evt : events) {
+      enqueue(evt);
+    }
+  }
+
+  /**
+   * Every event enqueued since the last consume, one per key, sorted by
+   *  entity index so that consumers walk component storages in order
+   */
+  std::span<T> consume() {
+    std::span<T> evts = events_.consume();
+    std::sort(evts.begin(), evts.end(), [](const T& a, const T& b) {
+      return index_of(a) < index_of(b);
+    });
+
+    // Every set bit belongs to one of these events - whole words can go
+    std::uint32_t overflow_words = 0u;
+    for (const T& evt : evts) {
+      const std::uint32_t word = index_of(evt) / 64u;
+      if (word < word_count_) {
+        bits_[word].store(0u, std::memory_order_relaxed);
+      } else {
+        overflow_words = std::max(overflow_words, word + 1u);
+      }
+    }
+
+    // Grow the bitset past every key seen - keys that do not fit are tracked
+    //  under a lock until then
+    if (overflow_words > 0u) {
+      const std::uint32_t word_count = overflow_words * 2u;
+      bits_ = std::make_unique<std::atomic_uint64_t[]>(word_count);
+      word_count_ = word_count;
+    }
+    overflow_keys_.clear();
+
+    return evts;
+  }
+
+ private:
+  static std::uint32_t index_of(const T& evt) {
+    return static_cast<std::uint32_t>(entt::to_entity(evt.key()));
+  }
+
+  bool mark(std::uint32_t index) {
+    const std::uint32_t word = index / 64u;
+    if (word < word_count_) {
+      const std::uint64_t mask = std::uint64_t{1u} << (index % 64u);
+      return (bits_[word].fetch_or(mask, std::memory_order_relaxed) & mask) ==
+             0u;
+    }
+
+    std::lock_guard<std::mutex> l(overflow_lock_);
+    return overflow_keys_.insert(index).second;
+  }
+
+  EventChannel<T> events_;
+
+  // Resized by the consumer only, read by producers
+  std::unique_ptr<std::atomic_uint64_t[]> bits_;
+  std::uint32_t word_count_;
+
+  std::mutex overflow_lock_;
+  std::unordered_set<std::uint32_t> overflow_keys_;
+};
+
 template <typename T>
 struct CtxEventQueue {
-  moodycamel::ConcurrentQueue<T> queue;
+  EventChannel<T> channel;
+};
+
+template <KeyedEvent T>
+struct CtxEventQueue<T> {
+  KeyedEventChannel<T> channel;
 };
 
 }  // namespace igecs
 
-#endif
\ No newline at end of file
+#endif
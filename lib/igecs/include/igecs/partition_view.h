@@ -0,0 +1,160 @@
+#ifndef IGECS_PARTITION_VIEW_H
+#define IGECS_PARTITION_VIEW_H
+
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+
+#include <entt/entt.hpp>
+
+namespace igecs {
+
+/**
+ * Entity range [begin, end) of one of count partitions of a storage of
+ *  entity_count entities - partitions are contiguous, disjoint, and cover
+ *  every entity between them
+ */
+struct PartitionRange {
+  std::uint32_t begin;
+  std::uint32_t end;
+
+  static PartitionRange Of(std::uint32_t entity_count, std::uint32_t index,
+                           std::uint32_t count) {
+    auto bound = [entity_count, count](std::uint32_t i) {
+      return static_cast<std::uint32_t>(
+          static_cast<std::uint64_t>(entity_count) * i / count);
+    };
+    return PartitionRange{bound(index), bound(index + 1u)};
+  }
+
+  bool contains(std::uint32_t index) const {
+    return index >= begin && index < end;
+  }
+};
+
+/**
+ * Wrapper around an entt view (or group) that only visits entities at a range
+ *  of positions in a leading storage - the view's handle, or the first owned
+ *  storage of a group (see WorldView::primary_view, primary_group). Iterates
+ *  like the view it wraps - range-for gives entities, each() gives (entity,
+ *  components...) tuples.
+ */
+template <typename ViewT>
+class PartitionView {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = entt::entity;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const entt::entity*;
+    using reference = entt::entity;
+
+    iterator() : view_(nullptr), leading_(nullptr), pos_(0u), end_(0u) {}
+    iterator(const ViewT* view, const entt::sparse_set* leading,
+             std::uint32_t pos, std::uint32_t end)
+        : view_(view), leading_(leading), pos_(pos), end_(end) {
+      skip_missing();
+    }
+
+    entt::entity operator*() const { return leading_->data()[pos_]; }
+
+    iterator& operator++() {
+      pos_++;
+      skip_missing();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator orig = *this;
+      ++(*this);
+      return orig;
+    }
+
+    bool operator==(const iterator& o) const { return pos_ == o.pos_; }
+    bool operator!=(const iterator& o) const { return pos_ != o.pos_; }
+
+   private:
+    // The leading storage may hold entities that are missing other components
+    //  of the view
+    void skip_missing() {
+      while (pos_ < end_ && !view_->contains(leading_->data()[pos_])) {
+        pos_++;
+      }
+    }
+
+    const ViewT* view_;
+    const entt::sparse_set* leading_;
+    std::uint32_t pos_;
+    std::uint32_t end_;
+  };
+
+  class each_iterable {
+   public:
+    class each_iterator {
+     public:
+      each_iterator(iterator it, const ViewT* view) : it_(it), view_(view) {}
+
+      auto operator*() const {
+        entt::entity e = *it_;
+        return std::tuple_cat(std::make_tuple(e), view_->get(e));
+      }
+
+      each_iterator& operator++() {
+        ++it_;
+        return *this;
+      }
+
+      bool operator==(const each_iterator& o) const { return it_ == o.it_; }
+      bool operator!=(const each_iterator& o) const { return it_ != o.it_; }
+
+     private:
+      iterator it_;
+      const ViewT* view_;
+    };
+
+    each_iterable(const PartitionView* pv) : pv_(pv) {}
+
+    each_iterator begin() const { return {pv_->begin(), &pv_->view_}; }
+    each_iterator end() const { return {pv_->end(), &pv_->view_}; }
+
+   private:
+    const PartitionView* pv_;
+  };
+
+  PartitionView(ViewT view, const entt::sparse_set* leading,
+                PartitionRange range)
+      : view_(view), leading_(leading), range_(range) {}
+
+  iterator begin() const {
+    return iterator(&view_, leading_, range_.begin, range_.end);
+  }
+  iterator end() const {
+    return iterator(&view_, leading_, range_.end, range_.end);
+  }
+
+  each_iterable each() const { return each_iterable(this); }
+
+  template <typename... Component>
+  decltype(auto) get(entt::entity e) const {
+    return view_.template get<Component...>(e);
+  }
+
+  /** True if the entity is in the view, and in this partition of it */
+  bool contains(entt::entity e) const {
+    return view_.contains(e) &&
+           range_.contains(static_cast<std::uint32_t>(leading_->index(e)));
+  }
+
+  const ViewT& view() const { return view_; }
+  const PartitionRange& range() const { return range_; }
+
+ private:
+  ViewT view_;
+  const entt::sparse_set* leading_;
+  PartitionRange range_;
+};
+
+}  // namespace igecs
+
+#endif
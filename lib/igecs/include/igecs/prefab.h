@@ -0,0 +1,102 @@
+#ifndef IGECS_PREFAB_H
+#define IGECS_PREFAB_H
+
+#include <igecs/world_view.h>
+
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+namespace igecs {
+
+/**
+ * Template for spawning many entities with the same set of components.
+ *
+ * spawn creates all of the entities in one WorldView::create(first, last),
+ *  and fills each component storage with one range WorldView::insert - one
+ *  batch per storage, instead of one sparse set insert per entity per
+ *  component.
+ *
+ * Every entity starts with a copy of the template components. The override
+ *  callback of spawn is called once per entity (in order) with the index of
+ *  the entity and a copy of the template, and can change any component
+ *  before it is inserted:
+ *
+ *    prefab.spawn(wv, entities, [&](std::size_t i, auto& instance) {
+ *      std::get<Position>(instance).pos = positions[i];
+ *    });
+ */
+template <typename... Components>
+class Prefab {
+ public:
+  using Instance = std::tuple<Components...>;
+
+  explicit Prefab(Components... components)
+      : template_(std::move(components)...) {}
+
+  /** Accesses needed to spawn - merge into the decl of spawning systems */
+  static WorldView::Decl decl() {
+    WorldView::Decl d;
+    d.creates_entities();
+    (d.writes<Components>(), ...);
+    return d;
+  }
+
+  const Instance& instance() const { return template_; }
+  Instance& instance() { return template_; }
+
+  /** Fill out with new entities, each a copy of the template */
+  void spawn(WorldView* wv, std::span<entt::entity> out) const {
+    wv->create(out.begin(), out.end());
+    (wv->insert<Components>(out.begin(), out.end(),
+                            std::get<Components>(template_)),
+     ...);
+  }
+
+  /**
+   * Fill out with new entities, each a copy of the template after
+   *  override_fn(std::size_t index, Instance& instance) has run on it
+   */
+  template <typename OverrideFnT>
+  void spawn(WorldView* wv, std::span<entt::entity> out,
+             OverrideFnT&& override_fn) const {
+    std::tuple<std::vector<Components>...> columns;
+    (std::get<std::vector<Components>>(columns).reserve(out.size()), ...);
+
+    for (std::size_t i = 0u; i < out.size(); i++) {
+      Instance instance = template_;
+      override_fn(i, instance);
+      (std::get<std::vector<Components>>(columns).push_back(
+           std::move(std::get<Components>(instance))),
+       ...);
+    }
+
+    wv->create(out.begin(), out.end());
+    (insert_column<Components>(wv, out,
+                               std::get<std::vector<Components>>(columns)),
+     ...);
+  }
+
+ private:
+  template <typename ComponentT>
+  static void insert_column(WorldView* wv, std::span<entt::entity> out,
+                            const std::vector<ComponentT>& column) {
+    if constexpr (std::is_empty_v<ComponentT>) {
+      // Tags have nothing to override
+      wv->insert<ComponentT>(out.begin(), out.end());
+    } else {
+      wv->insert<ComponentT>(out.begin(), out.end(), column.begin());
+    }
+  }
+
+  Instance template_;
+};
+
+}  // namespace igecs
+
+#endif
@@ -3,9 +3,11 @@
 
 #include <igecs/world_view.h>
 
+#include <atomic>
 #include <chrono>
 #include <vector>
 #include <map>
+#include <memory>
 
 namespace igecs::profile {
 
@@ -33,8 +35,41 @@ class FrameProfiler {
                     std::chrono::high_resolution_clock::time_point start_time,
                     std::chrono::high_resolution_clock::time_point end_time,
                     std::uint32_t entities_accessed, std::thread::id thread_id);
+  /** Time a thread spent waiting for work, either spinning or parked */
+  void AddIdle(std::thread::id thread_id,
+               std::chrono::high_resolution_clock::time_point start_time,
+               std::chrono::high_resolution_clock::time_point end_time,
+               bool parked);
   std::string JsonSerializeFrame(bool pretty);
 
+  //
+  // Cost history (used to size WorldView::parallel_each chunks)
+  //
+
+  /** Thread safe - may be called from any thread while a frame executes */
+  void AddEntityCostSample(
+      std::uint32_t system_id, std::uint32_t entity_count,
+      std::chrono::high_resolution_clock::duration duration);
+
+  /**
+   * Moving average of nanoseconds spent per entity by a system, over previous
+   *  frames. 0 if the system has not reported any samples yet.
+   */
+  double EntityCostEstimate(std::uint32_t system_id) const;
+
+  //
+  // Duration history (used to prioritize nodes on the critical path)
+  //
+
+  /**
+   * Moving average of the time (in nanoseconds) a system spends running per
+   *  frame, over previous frames. 0 if the system has not run yet.
+   */
+  double DurationEstimate(std::uint32_t system_id) const;
+
+  /** Main thread plus worker threads */
+  std::uint32_t ThreadCount() const;
+
  private:
   enum class ComponentAccessMode {
     CtxRead,
@@ -42,7 +77,9 @@ class FrameProfiler {
     ComponentRead,
     ComponentWrite,
     ListWrite,
-    ListConsume
+    ListConsume,
+    // Owned by an entt group the system iterates (see Decl::owning_group)
+    GroupOwn
   };
   struct ComponentAccess {
     ComponentAccessMode access_mode;
@@ -59,6 +96,28 @@ class FrameProfiler {
     std::uint32_t component_id;
     std::string component_name;
   };
+  struct EntityCostHistory {
+    // Accumulated over the current frame
+    std::atomic_uint64_t frame_ns;
+    std::atomic_uint64_t frame_entities;
+
+    // Folded in at the end of every frame
+    double ns_per_entity;
+  };
+  struct DurationHistory {
+    // Accumulated over the current frame (executions are added on the main
+    //  thread, so this does not need to be atomic)
+    std::uint64_t frame_ns;
+
+    // Folded in at the end of every frame
+    double ns_per_frame;
+  };
+  struct IdleSpan {
+    std::thread::id thread_id;
+    std::chrono::high_resolution_clock::time_point start_frame_time;
+    std::chrono::high_resolution_clock::time_point end_frame_time;
+    bool parked;
+  };
   struct SystemRun {
     std::uint32_t system_id;
     std::thread::id thread_id;
@@ -74,11 +133,14 @@ class FrameProfiler {
   std::vector<std::thread::id> worker_thread_ids_;
   std::vector<RegisteredSystem> systems_;
   std::map<std::uint32_t, RegisteredComponent> components_;
+  std::map<std::uint32_t, std::unique_ptr<EntityCostHistory>> entity_costs_;
+  std::map<std::uint32_t, DurationHistory> durations_;
 
   // Frame data
   std::chrono::high_resolution_clock::time_point frame_start_;
   std::chrono::high_resolution_clock::time_point frame_end_;
   std::vector<SystemRun> executions_;
+  std::vector<IdleSpan> idle_spans_;
 };
 
 }  // namespace igecs::profile
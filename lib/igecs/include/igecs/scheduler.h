@@ -4,9 +4,16 @@
 #include <igasync/promise.h>
 #include <igasync/task_list.h>
 #include <igecs/profile/frame_profiler.h>
+#include <igecs/work_stealing_pool.h>
 #include <igecs/world_view.h>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <vector>
 
@@ -27,8 +34,9 @@ concept HasSynchronousRunMethod = requires(T&& t, igecs::WorldView* wv) {
 
 template <typename T>
 concept HasAsynchronousRunMethod = requires(
-    T&& t, igecs::WorldView* wv, std::shared_ptr<igasync::TaskList> main_thread,
-    std::shared_ptr<igasync::TaskList> any_thread,
+    T&& t, igecs::WorldView* wv,
+    std::shared_ptr<igasync::ExecutionContext> main_thread,
+    std::shared_ptr<igasync::ExecutionContext> any_thread,
     std::function<void(igasync::TaskProfile profile)> profile_cb) {
   {
     T::run(wv, main_thread, any_thread, profile_cb)
@@ -41,11 +49,58 @@ concept HasAsynchronousRunMethod = requires(
 /**
  * ECS scheduler class - used to create a schedule graph and perform execution
  *  of ECS systems concurrently.
+ *
+ * Everything the scheduler itself needs to run a frame (node jobs, world
+ *  views, profile records) persists across frames. Once warmed up, executing
+ *  synchronous nodes on a WorkStealingPool (or on the calling thread) does not
+ *  allocate - async nodes (promises) and igasync::TaskList executors do.
+ *
+ * Nodes that become ready at the same time do not run in the order they were
+ *  released: any-thread nodes wait in a ready heap, ordered by the estimated
+ *  time left on the longest path from the node to the end of the frame (from
+ *  the durations of previous frames), and each free thread takes the node
+ *  with the longest remaining path.
  */
 class Scheduler {
  public:
   class Builder;
 
+  /** Summary of the shape of a dependency graph */
+  struct GraphStats {
+    std::uint32_t node_count;
+    std::uint32_t edge_count;
+
+    /** Number of nodes on the longest dependency chain */
+    std::uint32_t critical_path_length;
+
+    /** Largest number of nodes that share the same depth in the graph */
+    std::uint32_t max_width;
+
+    /** Nodes per step of the critical path (1.0 for a fully serial graph) */
+    float average_parallelism() const;
+  };
+
+  /** Timing of the nodes about to run, passed to Builder::on_tick callbacks */
+  struct TickInfo {
+    /** True before a run of fixed tick nodes, false before per-frame nodes */
+    bool is_fixed_tick;
+
+    /**
+     * Index of the fixed tick about to run - for per-frame nodes, the number
+     *  of fixed ticks that have run so far
+     */
+    std::uint64_t tick_index;
+
+    /** Time step of the nodes about to run (tick length, or frame time) */
+    float dt_seconds;
+
+    /**
+     * How far (in ticks, 0 to 1) the frame is past the last fixed tick, for
+     *  interpolating between tick states. Always 1 without a fixed tick rate.
+     */
+    float interpolation_alpha;
+  };
+
   /** Individual node on the scheduler object */
   class Node {
    public:
@@ -70,18 +125,38 @@ class Scheduler {
       Builder& with_decl(WorldView::Decl decl);
       Builder& depends_on(const Node& node);
 
+      /**
+       * Run this node in the fixed tick subgraph (see
+       *  Scheduler::Builder::fixed_tick) - it may only depend on other fixed
+       *  tick nodes. Without a fixed tick rate, runs once per frame as usual.
+       */
+      Builder& fixed_tick();
+
+      /**
+       * Run partition_count instances of this node side by side, each over a
+       *  disjoint range of the entities of its primary view (see
+       *  WorldView::primary_view). Instances share dependencies and the
+       *  profiler entry of the node. Only synchronous nodes may be partitioned,
+       *  and partitioned nodes may only make structural changes to the world
+       *  through deferred commands (see WorldView::defer_create).
+       */
+      Builder& partitioned(std::uint32_t partition_count);
+
       /** Callback consumes a WorldView, and returns an EmptyPromiseRsl */
       [[nodiscard]] Node build(
           std::function<std::shared_ptr<igasync::Promise<void>>(
               WorldView* wv,
-              std::shared_ptr<igasync::TaskList> main_thread_task_list,
-              std::shared_ptr<igasync::TaskList> any_thread_task_list,
+              std::shared_ptr<igasync::ExecutionContext> main_thread,
+              std::shared_ptr<igasync::ExecutionContext> any_thread,
               std::function<void(igasync::TaskProfile profile)> profile_cb)>
               cb,
           igecs::CttiTypeId system_id, std::string system_name);
 
-      /** Shorthand for use with synchronous systems */
-      [[nodiscard]] Node build(void (*cb)(WorldView* wv),
+      /**
+       * Shorthand for use with synchronous systems - the callback is invoked
+       *  directly on the executing thread, no promise is created for it
+       */
+      [[nodiscard]] Node build(std::function<void(WorldView* wv)> cb,
                                igecs::CttiTypeId system_id,
                                std::string system_name);
 
@@ -115,6 +190,8 @@ class Scheduler {
       bool is_built_;
       NodeId node_id_;
       bool is_main_thread_only_;
+      bool is_fixed_tick_;
+      std::uint32_t partition_count_;
       WorldView::Decl world_view_decl_;
       std::vector<NodeId> dependency_ids_;
 
@@ -123,31 +200,36 @@ class Scheduler {
       Scheduler::Builder& b_;
     };
 
-    std::shared_ptr<igasync::Promise<void>> schedule(
-        entt::registry* world, std::shared_ptr<igasync::TaskList> main_thread,
-        std::shared_ptr<igasync::TaskList> any_thread,
-        profile::FrameProfiler* profiler);
-
    private:
     Node(WorldView::Decl wv_decl, bool main_thread_only, NodeId id,
          std::vector<NodeId> dependency_ids,
          std::function<std::shared_ptr<igasync::Promise<void>>(
              WorldView* wv,
-             std::shared_ptr<igasync::TaskList> main_thread_task_list,
-             std::shared_ptr<igasync::TaskList> any_thread_task_list,
+             std::shared_ptr<igasync::ExecutionContext> main_thread,
+             std::shared_ptr<igasync::ExecutionContext> any_thread,
              std::function<void(igasync::TaskProfile profile)> profile_cb)>
              cb,
+         std::function<void(WorldView* wv)> sync_cb,
          igecs::CttiTypeId system_id, std::string system_name,
          std::vector<igecs::CttiTypeId> dependency_cttis);
 
     NodeId id_;
     bool main_thread_only_;
+    bool fixed_tick_;
+
+    // Partitioned nodes are compiled into one node per partition, which all
+    //  share the id of the node that was built
+    std::uint32_t partition_count_;
+    std::uint32_t partition_index_;
+
     WorldView::Decl wv_decl_;
     std::function<std::shared_ptr<igasync::Promise<void>>(
-        WorldView* wv, std::shared_ptr<igasync::TaskList> main_thread_task_list,
-        std::shared_ptr<igasync::TaskList> any_thread_task_list,
+        WorldView* wv,
+        std::shared_ptr<igasync::ExecutionContext> main_thread,
+        std::shared_ptr<igasync::ExecutionContext> any_thread,
         std::function<void(igasync::TaskProfile profile)> profile_cb)>
         cb_;
+    std::function<void(WorldView* wv)> sync_cb_;
     std::vector<NodeId> dependency_ids_;
 
     igecs::CttiTypeId system_id_;
@@ -165,9 +247,53 @@ class Scheduler {
 
     /** What is the longest time spinning is allowed before crashing the app? */
     Builder& max_spin_time(std::chrono::high_resolution_clock::duration dt);
+
+    /**
+     * How long does the main thread spin looking for work before parking until
+     *  a worker thread wakes it up?
+     */
+    Builder& idle_spin_time(std::chrono::high_resolution_clock::duration dt);
     Builder& main_thread_id(std::thread::id id);
     Builder& worker_thread_id(std::thread::id id);
 
+    /**
+     * Derive ordering edges from node decls instead of depends_on() calls:
+     *  each node depends on every earlier-added node its decl conflicts with
+     *  (see WorldView::Decl::conflicts_with), reduced to the minimal set of
+     *  edges that gives the same ordering. Nodes must be added in the order
+     *  they should run relative to conflicting nodes.
+     *
+     * Explicit depends_on() edges are not scheduled in this mode, they are kept
+     *  as the hand-written graph reported by hand_written_graph_stats().
+     */
+    Builder& infer_dependencies(bool infer = true);
+
+    /**
+     * Run fixed tick nodes once per tick_length of time passed to
+     *  Scheduler::advance_time - each execute runs every tick that has come
+     *  due (at most max_ticks_per_frame, time past that is dropped) before
+     *  running the per-frame nodes once. Some per-frame nodes may overlap the
+     *  ticks, see on_tick.
+     */
+    Builder& fixed_tick(
+        std::chrono::high_resolution_clock::duration tick_length,
+        std::uint32_t max_ticks_per_frame = 4u);
+
+    /**
+     * Called on the main thread before every run of the fixed tick nodes and
+     *  before the per-frame nodes - use this to publish tick timing to systems
+     *  (e.g. into a context component). decl lists what the callback touches.
+     *
+     * Per-frame nodes that depend on no fixed tick node, and whose decls
+     *  conflict with neither decl nor any fixed tick node, start along with
+     *  the first tick instead of after the last one (e.g. rendering the state
+     *  of the previous frame). The callback may run while they do - with the
+     *  default Thin decl, every per-frame node waits for the ticks.
+     */
+    Builder& on_tick(
+        std::function<void(entt::registry* world, const TickInfo& tick)> cb,
+        WorldView::Decl decl = WorldView::Decl::Thin());
+
     [[nodiscard]] Node::Builder add_node();
     [[nodiscard]] Scheduler build();
 
@@ -177,28 +303,271 @@ class Scheduler {
     std::vector<std::thread::id> worker_thread_ids_;
     std::vector<Node> nodes_;
     std::chrono::high_resolution_clock::duration max_spin_time_;
+    std::chrono::high_resolution_clock::duration idle_spin_time_;
+    std::chrono::high_resolution_clock::duration tick_length_;
+    std::uint32_t max_ticks_per_frame_;
+    std::function<void(entt::registry*, const TickInfo&)> on_tick_;
+    WorldView::Decl on_tick_decl_;
     uint32_t next_node_id_;
+    bool infer_dependencies_;
   };
 
+  /**
+   * Pass time to the fixed tick clock - ticks that come due run on the next
+   *  execute. The last dt passed in is also the per-frame time step.
+   */
+  void advance_time(std::chrono::high_resolution_clock::duration dt);
+
   void execute(std::shared_ptr<igasync::TaskList> any_thread_task_list,
                entt::registry* world);
 
+  /**
+   * Execute using a work stealing pool for any-thread nodes (and any chunk
+   *  tasks they schedule) instead of a shared task list
+   */
+  void execute(std::shared_ptr<WorkStealingPool> any_thread_pool,
+               entt::registry* world);
+
+  /** Execute every node on the calling thread */
+  void execute(std::nullptr_t, entt::registry* world);
+
   std::string dump_profile(bool pretty = true);
 
+  /** Shape of the graph that is actually executed */
+  const GraphStats& graph_stats() const { return graph_stats_; }
+
+  /**
+   * Shape of the graph formed by explicit depends_on() edges - identical to
+   *  graph_stats() unless the builder inferred dependencies
+   */
+  const GraphStats& hand_written_graph_stats() const {
+    return hand_written_graph_stats_;
+  }
+
  private:
   Scheduler(Builder b);
 
-  /** Return true if and only if a eventually depends on b */
-  static bool has_strict_dep(const std::vector<Node>& nodes, Node::NodeId a,
-                             Node::NodeId b);
+  /**
+   * Minimal set of dependencies (by index into nodes) for each node, such that
+   *  every pair of conflicting nodes runs in the order they were added. Nodes
+   *  in different subgraphs (fixed tick vs. per-frame) are already ordered.
+   *  decls[i] is the access of nodes[i] (see Decl::with_group_writes).
+   */
+  static std::vector<std::vector<std::uint32_t>> infer_dependency_indices(
+      const std::vector<Node>& nodes, const std::vector<WorldView::Decl>& decls,
+      const std::vector<bool>& is_tick_node);
+
+  /** preds[i] lists dependencies of node i - all must be less than i */
+  static GraphStats compute_graph_stats(
+      const std::vector<std::vector<std::uint32_t>>& preds);
+
+  /**
+   * Execution context handed to systems as their main thread context - tasks
+   *  go to the main thread task list, and wake up the main thread if it is
+   *  parked waiting for work.
+   */
+  class MainThreadContext : public igasync::ExecutionContext {
+   public:
+    MainThreadContext(std::shared_ptr<igasync::TaskList> task_list);
+
+    void schedule(std::unique_ptr<igasync::Task> task) override;
+
+    /** Queue a job for the main thread - does not allocate once warmed up */
+    void schedule(WorkStealingPool::Job* job);
+
+    /** Run one queued job or task (main thread only), false if none were */
+    bool execute_next();
+
+    /** Wake up the main thread if it is parked (callable from any thread) */
+    void wake();
+
+    /** Read before looking for work, and pass to park() if none was found */
+    std::uint32_t wake_seq() const;
+
+    /**
+     * Block until wake() is called after wake_seq was read, or until deadline
+     *  - returns immediately if that has already happened.
+     */
+    void park(std::uint32_t wake_seq,
+              std::chrono::high_resolution_clock::time_point deadline);
+
+   private:
+    std::shared_ptr<igasync::TaskList> task_list_;
+
+    // Jobs run in FIFO order - the vector keeps its capacity between frames
+    std::mutex jobs_lock_;
+    std::vector<WorkStealingPool::Job*> jobs_;
+    std::size_t next_job_;
+    std::atomic_uint32_t queued_jobs_;
+
+    std::atomic_uint32_t wake_seq_;
+    std::atomic_bool is_parked_;
+    std::mutex park_lock_;
+    std::condition_variable park_cv_;
+  };
+
+  struct FrameState;
+
+  /** Persistent job that runs one node, scheduled whenever the node is ready */
+  struct NodeJob : WorkStealingPool::Job {
+    FrameState* fs;
+    std::uint32_t node_idx;
+  };
+
+  /** Timing of the latest run of a node, reported once its subgraph is done */
+  struct NodeRun {
+    bool ran;
+    std::chrono::high_resolution_clock::time_point start;
+    std::chrono::high_resolution_clock::time_point end;
+    std::thread::id thread_id;
+  };
+
+  /**
+   * Per-frame execution state of the compiled graph. Atomics are not movable,
+   *  so this lives behind a pointer to keep the Scheduler itself movable.
+   */
+  struct FrameState {
+    // Scheduler that last executed a frame - node jobs find it through here
+    Scheduler* scheduler;
+
+    std::unique_ptr<std::atomic_uint32_t[]> pending_deps;
+    // Per partitioned node - partitions that have not finished yet
+    std::unique_ptr<std::atomic_uint32_t[]> pending_partitions;
+    // Fixed tick and per-frame nodes are counted apart - per-frame nodes may
+    //  still be running when a tick finishes
+    std::atomic_uint32_t remaining_tick_nodes;
+    std::atomic_uint32_t remaining_frame_nodes;
+    std::atomic_bool is_tick_done;
+    std::atomic_bool is_frame_done;
+
+    std::shared_ptr<igasync::TaskList> main_thread_task_list;
+    std::shared_ptr<MainThreadContext> main_thread;
+
+    // Exactly one of these is set while a frame executes - any_thread is
+    //  whichever of the two is in use
+    std::shared_ptr<igasync::TaskList> any_thread_task_list;
+    std::shared_ptr<WorkStealingPool> any_thread_pool;
+    std::shared_ptr<igasync::ExecutionContext> any_thread;
+
+    entt::registry* world;
+
+    // Any-thread nodes that are ready to run, as a max-heap by priority. Every
+    //  entry has one ready job scheduled for it, which runs whichever node is
+    //  at the top of the heap by the time the job gets to run.
+    std::mutex ready_lock;
+    std::vector<std::uint32_t> ready_heap;
+
+    // Scratch list of after_tick_nodes_ that are ready once the ticks are done
+    std::vector<std::uint32_t> released_nodes;
+
+    // Per node (by index) - reused by every run of the node
+    std::unique_ptr<NodeJob[]> node_jobs;
+    std::unique_ptr<NodeJob[]> ready_jobs;
+    std::unique_ptr<NodeRun[]> node_runs;
+    std::vector<std::unique_ptr<WorldView>> world_views;
+    std::vector<std::function<void(igasync::TaskProfile)>> profile_cbs;
+  };
+
+  void execute_frame(entt::registry* world);
+
+  /**
+   * Reset the dependency counters of a subgraph (fixed tick or per-frame
+   *  nodes) before a pass over it - counters of the other subgraph are left
+   *  alone, its nodes may be running
+   */
+  void reset_subgraph(bool fixed_tick);
+
+  /** Schedule nodes that have no dependencies left, most important first */
+  void start_nodes(const std::vector<std::uint32_t>& ready_nodes);
+
+  /** Run main thread work (and help out with any-thread work) until done */
+  void wait_until(const std::atomic_bool& is_done);
+
+  /**
+   * Recompute node priorities from the latest duration estimates - the
+   *  priority of a node is the estimated time left on the longest path from
+   *  the start of the node to the end of its subgraph
+   */
+  void update_priorities();
+
+  /** Ready heap ordering - true if node a should run after node b */
+  bool runs_after(std::uint32_t a, std::uint32_t b) const;
+
+  /** True if the node runs on the main thread this frame */
+  bool runs_on_main_thread(std::uint32_t node_idx) const;
+
+  /** Schedule a node whose dependencies have all finished this frame */
+  void dispatch_node(std::uint32_t node_idx);
+  /** Add an any-thread node to the ready heap (does not schedule it) */
+  void push_ready(std::uint32_t node_idx);
+  /** Schedule the ready job paired with a node pushed to the ready heap */
+  void schedule_ready_job(std::uint32_t node_idx);
+  static void run_node_job(WorkStealingPool::Job* job);
+  static void run_ready_job(WorkStealingPool::Job* job);
+  void run_node(std::uint32_t node_idx);
+  /**
+   * Sync point of a node - applies commands deferred by the node's world
+   *  view, or by every partition of the node once the last one is done
+   */
+  void play_back_commands(std::uint32_t node_idx);
+  /** Release successors of a finished node, and finish the frame if needed */
+  void finish_node(std::uint32_t node_idx);
+  /**
+   * Pass timings of nodes of one subgraph that ran since the last call to the
+   *  profiler
+   */
+  void report_node_runs(bool fixed_tick);
 
   profile::FrameProfiler frame_profiler_;
   std::chrono::high_resolution_clock::duration max_spin_time_;
+  std::chrono::high_resolution_clock::duration idle_spin_time_;
+
+  // Nodes in topological order - all indices below refer to this list
   std::vector<Node> nodes_;
 
-  // TODO (sessamekesh): Store nodes in a DAG for convenience in scheduling
+  // Compiled graph: successors of node i are
+  //  successors_[successor_offsets_[i] .. successor_offsets_[i + 1]]
+  std::vector<std::uint32_t> successor_offsets_;
+  std::vector<std::uint32_t> successors_;
+  std::vector<std::uint32_t> dependency_counts_;
+  std::vector<bool> is_tick_node_;
+
+  // Per-frame nodes that start along with the first tick (see
+  //  Builder::on_tick)
+  std::vector<std::uint32_t> root_nodes_;
+
+  // Per-frame nodes that wait for the ticks, and no other per-frame node that
+  //  waits for them - the ticks count as one more dependency of each
+  std::vector<std::uint32_t> after_tick_nodes_;
+
+  // Nodes of partitioned node g (by partition) are partitions_[g], and
+  //  partition_groups_[i] is g for each of them
+  std::vector<std::uint32_t> partition_groups_;
+  std::vector<std::vector<std::uint32_t>> partitions_;
+
+  // Priority of each node for the current frame (see update_priorities)
+  std::vector<double> priorities_;
+
+  // Fixed tick subgraph - edges between the subgraphs are not part of the
+  //  compiled graph (every tick runs before after_tick_nodes_ are released)
+  std::vector<std::uint32_t> tick_root_nodes_;
+  std::uint32_t tick_node_count_;
+  std::chrono::high_resolution_clock::duration tick_length_;
+  std::uint32_t max_ticks_per_frame_;
+  std::function<void(entt::registry*, const TickInfo&)> on_tick_;
+  WorldView::Decl on_tick_decl_;
+  std::chrono::high_resolution_clock::duration tick_accumulator_;
+  std::chrono::high_resolution_clock::duration frame_time_;
+  std::uint64_t next_tick_index_;
+
+  GraphStats graph_stats_;
+  GraphStats hand_written_graph_stats_;
+
+  std::unique_ptr<FrameState> frame_state_;
 };
 
+std::ostream& operator<<(std::ostream& o, const Scheduler::GraphStats& s);
+
 }  // namespace igecs
 
 #endif
@@ -0,0 +1,105 @@
+#ifndef IGECS_WORK_STEALING_POOL_H
+#define IGECS_WORK_STEALING_POOL_H
+
+#include <concurrentqueue.h>
+#include <igasync/task_list.h>
+#include <igecs/chase_lev_deque.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace igecs {
+
+/**
+ * Worker thread pool for any-thread ECS work, used in place of a shared
+ *  igasync::TaskList.
+ *
+ * Every worker owns a Chase-Lev deque. Tasks scheduled from a worker thread go
+ *  to the bottom of that worker's own deque, so chunk tasks spawned by a system
+ *  tend to run on the thread that spawned them. Workers that run out of work
+ *  steal from the top of other workers' deques. Tasks scheduled from outside of
+ *  the pool (e.g. the main thread) go through a shared injection queue.
+ *
+ * Idle workers sleep on a condition variable, and are woken up when new work
+ *  is scheduled. Scheduling onto a worker's own deque only reads the count of
+ *  sleeping workers (which changes only when a worker goes to sleep or wakes
+ *  up), and thieves pick victims with a per-thread random seed - so workers
+ *  busy with their own deques do not contend on any shared cache line.
+ *
+ * Besides igasync tasks, the pool runs intrusive Jobs owned by the caller -
+ *  scheduling a job does not allocate once the queues have grown to fit the
+ *  steady-state amount of work.
+ */
+class WorkStealingPool : public igasync::ExecutionContext {
+ public:
+  /**
+   * Unit of work that is not owned by the pool. The job must stay alive until
+   *  run is called, and may be scheduled again from inside of run.
+   */
+  struct Job {
+    void (*run)(Job* job);
+  };
+
+  static std::shared_ptr<WorkStealingPool> Create(std::uint32_t worker_count);
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+  ~WorkStealingPool();
+
+  void schedule(std::unique_ptr<igasync::Task> task) override;
+  void schedule(Job* job);
+
+  /**
+   * Run one pending task on the calling thread - used by threads outside of the
+   *  pool (the main thread) to help out while waiting on pool work.
+   *
+   * @return false if no task could be found
+   */
+  bool execute_next();
+
+  std::vector<std::thread::id> thread_ids() const;
+  std::uint32_t worker_count() const;
+
+ private:
+  // Either an igasync::Task* or a Job*, told apart by the lowest bit (set for
+  //  jobs) - both types are aligned well past 2 bytes
+  using WorkItem = std::uintptr_t;
+
+  struct Worker {
+    ChaseLevDeque<WorkItem> deque;
+    std::thread thread;
+  };
+
+  WorkStealingPool(std::uint32_t worker_count);
+
+  void worker_loop(std::uint32_t worker_idx);
+
+  void schedule_item(WorkItem item);
+
+  /** Find runnable work, worker_idx is negative for non-worker threads */
+  bool find_task(std::int32_t worker_idx, WorkItem& out);
+  void run_task(WorkItem item);
+
+  /** True if any queue looks non-empty - checked by workers going to sleep */
+  bool has_visible_work() const;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  moodycamel::ConcurrentQueue<WorkItem> injection_queue_;
+
+  // Own cache lines - read on every schedule and every idle round, written
+  //  rarely
+  alignas(64) std::atomic_uint32_t sleeping_workers_;
+  alignas(64) std::atomic_bool is_stopping_;
+
+  std::mutex sleep_lock_;
+  std::condition_variable sleep_cv_;
+};
+
+}  // namespace igecs
+
+#endif
@@ -1,17 +1,28 @@
 #ifndef IGECS_WORLD_VIEW_H
 #define IGECS_WORLD_VIEW_H
 
+#include <igasync/promise.h>
+#include <igasync/task_list.h>
 #include <igecs/config.h>
 #include <igecs/ctti_type_id.h>
+#include <igecs/ctti_type_set.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <tuple>
 #include <type_traits>
 
+#include "change_tracker.h"
+#include "command_buffer.h"
 #include "evt_queue.h"
+#include "partition_view.h"
 
 #ifdef IG_ENABLE_ECS_VALIDATION
 #include <iostream>
-#include <set>
-#include <shared_mutex>
 #endif
 
 #include <entt/entt.hpp>
@@ -51,6 +62,11 @@ void assert_and_print(bool condition, const char* method) {
 }  // namespace
 
 namespace igecs {
+
+namespace profile {
+class FrameProfiler;
+}
+
 class WorldView {
  public:
   class Decl {
@@ -67,47 +83,107 @@ class WorldView {
 
     template <typename T>
     Decl& reads() {
-      reads_.push_back(CttiTypeId::of<std::remove_const_t<T>>());
+      add_type<T>(reads_, read_set_);
       return *this;
     }
 
     template <typename T>
     Decl& writes() {
-      writes_.push_back(CttiTypeId::of<std::remove_const_t<T>>());
-      reads_.push_back(CttiTypeId::of<std::remove_const_t<T>>());
+      add_type<T>(writes_, write_set_);
+      add_type<T>(reads_, read_set_);
       return *this;
     }
 
     template <typename T>
     Decl& ctx_reads() {
-      ctx_reads_.push_back(CttiTypeId::of<std::remove_const_t<T>>());
+      add_type<T>(ctx_reads_, ctx_read_set_);
       return *this;
     }
 
     template <typename T>
     Decl& ctx_writes() {
-      ctx_reads_.push_back(CttiTypeId::of<std::remove_const_t<T>>());
-      ctx_writes_.push_back(CttiTypeId::of<std::remove_const_t<T>>());
+      add_type<T>(ctx_reads_, ctx_read_set_);
+      add_type<T>(ctx_writes_, ctx_write_set_);
       return *this;
     }
 
     template <typename T>
     Decl& evt_writes() {
-      evt_writes_.push_back(CttiTypeId::of<std::remove_const_t<T>>());
+      static_assert(!KeyedEvent<T>,
+                    "Keyed events are declared with keyed_evt_writes");
+      add_type<T>(evt_writes_, evt_write_set_);
+      return *this;
+    }
+
+    /**
+     * Like evt_writes, for event types with set semantics (see KeyedEvent) -
+     *  an event is dropped if another with the same key is already queued
+     */
+    template <KeyedEvent T>
+    Decl& keyed_evt_writes() {
+      add_type<T>(evt_writes_, evt_write_set_);
       return *this;
     }
 
     template <typename T>
     Decl& evt_consumes() {
-      evt_consumes_.push_back(CttiTypeId::of<std::remove_const_t<T>>());
+      add_type<T>(evt_consumes_, evt_consume_set_);
       return *this;
     }
 
+    /**
+     * Systems that iterate an entt group (WorldView::group) must declare it,
+     *  with the same template arguments. Const components are read, others
+     *  written, excluded components are read.
+     *
+     * Owned components are kept packed in the same order. Adding or removing
+     *  any component of the group moves entities around in every owned
+     *  storage - the scheduler treats any write to a member of a group
+     *  declared by any of its systems as a write to all owned components
+     *  of that group (see with_group_writes).
+     */
+    template <typename... Owned, typename... Get, typename... Exclude>
+    Decl& owning_group(entt::get_t<Get...> = entt::get_t{},
+                       entt::exclude_t<Exclude...> = entt::exclude_t{}) {
+      (add_access<Owned>(), ...);
+      (add_access<Get>(), ...);
+      (reads<Exclude>(), ...);
+      (add_type<Owned>(owns_, own_set_), ...);
+
+      Group group;
+      (group.owned.insert(CttiTypeId::of<std::remove_const_t<Owned>>()), ...);
+      (group.members.insert(CttiTypeId::of<std::remove_const_t<Owned>>()),
+       ...);
+      (group.members.insert(CttiTypeId::of<std::remove_const_t<Get>>()), ...);
+      (group.members.insert(CttiTypeId::of<std::remove_const_t<Exclude>>()),
+       ...);
+      add_group(group);
+      return *this;
+    }
+
+    /** Systems that create entities (WorldView::create) must declare so */
+    Decl& creates_entities();
+
+    /**
+     * Systems that destroy entities (WorldView::destroy) must declare so -
+     *  destroying an entity touches every component storage
+     */
+    Decl& destroys_entities();
+
+    /**
+     * True if systems with these two decls may not safely run concurrently
+     *  (one writes something the other reads/writes, both consume the same
+     *  event type, one consumes events the other enqueues, or one destroys
+     *  entities while the other touches entities at all)
+     */
+    [[nodiscard]] bool conflicts_with(const Decl& o) const;
+
     template <typename T>
     [[nodiscard]] bool can_read() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
       return allow_all_ ||
-             ::vec_contains(reads_, CttiTypeId::of<std::remove_const_t<T>>());
+             read_set_.contains(
+                 CttiTypeId::index_of<std::remove_const_t<T>>());
 #else
       return true;
 #endif
@@ -117,7 +193,8 @@ class WorldView {
     [[nodiscard]] bool can_write() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
       return allow_all_ ||
-             ::vec_contains(writes_, CttiTypeId::of<std::remove_const_t<T>>());
+             write_set_.contains(
+                 CttiTypeId::index_of<std::remove_const_t<T>>());
 #else
       return true;
 #endif
@@ -127,8 +204,8 @@ class WorldView {
     [[nodiscard]] bool can_ctx_read() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
       return allow_all_ ||
-             ::vec_contains(ctx_reads_,
-                            CttiTypeId::of<std::remove_const_t<T>>());
+             ctx_read_set_.contains(
+                 CttiTypeId::index_of<std::remove_const_t<T>>());
 #else
       return true;
 #endif
@@ -138,8 +215,8 @@ class WorldView {
     [[nodiscard]] bool can_ctx_write() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
       return allow_all_ ||
-             ::vec_contains(ctx_writes_,
-                            CttiTypeId::of<std::remove_const_t<T>>());
+             ctx_write_set_.contains(
+                 CttiTypeId::index_of<std::remove_const_t<T>>());
 #else
       return true;
 #endif
@@ -149,8 +226,8 @@ class WorldView {
     [[nodiscard]] bool can_evt_write() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
       return allow_all_ ||
-             ::vec_contains(evt_writes_,
-                            CttiTypeId::of<std::remove_const_t<T>>());
+             evt_write_set_.contains(
+                 CttiTypeId::index_of<std::remove_const_t<T>>());
 #else
       return true;
 #endif
@@ -160,14 +237,46 @@ class WorldView {
     [[nodiscard]] bool can_evt_consume() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
       return allow_all_ ||
-             ::vec_contains(evt_consumes_,
-                            CttiTypeId::of<std::remove_const_t<T>>());
+             evt_consume_set_.contains(
+                 CttiTypeId::index_of<std::remove_const_t<T>>());
 #else
       return true;
 #endif
     }
 
-    WorldView create(entt::registry* registry) const;
+    template <typename T>
+    [[nodiscard]] bool can_own() const {
+#ifdef IG_ENABLE_ECS_VALIDATION
+      return allow_all_ ||
+             own_set_.contains(CttiTypeId::index_of<std::remove_const_t<T>>());
+#else
+      return true;
+#endif
+    }
+
+    [[nodiscard]] bool can_create_entities() const {
+#ifdef IG_ENABLE_ECS_VALIDATION
+      return allow_all_ || creates_entities_;
+#else
+      return true;
+#endif
+    }
+
+    [[nodiscard]] bool can_destroy_entities() const {
+#ifdef IG_ENABLE_ECS_VALIDATION
+      return allow_all_ || destroys_entities_;
+#else
+      return true;
+#endif
+    }
+
+    /**
+     * If a profiler is given, parallel_each records per-entity cost samples
+     *  against system_id and uses them to size chunks on later calls
+     */
+    WorldView create(entt::registry* registry,
+                     profile::FrameProfiler* profiler = nullptr,
+                     std::uint32_t system_id = 0u) const;
 
     // Keeping this on for ECS profiling
     // #ifdef IG_ENABLE_ECS_VALIDATION
@@ -183,20 +292,82 @@ class WorldView {
     const std::vector<CttiTypeId>& list_evt_consumes() const {
       return evt_consumes_;
     }
+    const std::vector<CttiTypeId>& list_owns() const { return owns_; }
     // #endif
 
+    /** Components of an owning group, by type id */
+    struct Group {
+      CttiTypeSet owned;
+      // Owned, observed and excluded components
+      CttiTypeSet members;
+
+      bool operator==(const Group& o) const {
+        return owned == o.owned && members == o.members;
+      }
+    };
+
+    const std::vector<Group>& list_groups() const { return groups_; }
+
+    /**
+     * Copy of this decl where writing any member of one of the groups counts
+     *  as writing every owned component of that group - used by the scheduler
+     *  to order systems around the groups declared anywhere in the schedule
+     */
+    [[nodiscard]] Decl with_group_writes(
+        const std::vector<Group>& groups) const;
+
+    // Same types as the lists above, as bitsets for cheap access checks
+    const CttiTypeSet& read_set() const { return read_set_; }
+    const CttiTypeSet& write_set() const { return write_set_; }
+    const CttiTypeSet& ctx_read_set() const { return ctx_read_set_; }
+    const CttiTypeSet& ctx_write_set() const { return ctx_write_set_; }
+    const CttiTypeSet& evt_write_set() const { return evt_write_set_; }
+    const CttiTypeSet& evt_consume_set() const { return evt_consume_set_; }
+
    private:
     Decl(bool allow_all);
 
+    template <typename T>
+    static void add_type(std::vector<CttiTypeId>& list, CttiTypeSet& set) {
+      add_type(list, set, CttiTypeId::of<std::remove_const_t<T>>());
+    }
+
+    static void add_type(std::vector<CttiTypeId>& list, CttiTypeSet& set,
+                         const CttiTypeId& id);
+
+    template <typename T>
+    void add_access() {
+      if constexpr (std::is_const_v<T>) {
+        reads<T>();
+      } else {
+        writes<T>();
+      }
+    }
+
+    void add_group(const Group& group);
+
     bool allow_all_;
-    // #ifdef IG_ENABLE_ECS_VALIDATION
+    bool creates_entities_;
+    bool destroys_entities_;
+
+    // Lists keep types in declaration order (and their names) for the
+    //  profiler, sets are what access checks and conflict tests look at
     std::vector<CttiTypeId> reads_;
     std::vector<CttiTypeId> writes_;
     std::vector<CttiTypeId> ctx_reads_;
     std::vector<CttiTypeId> ctx_writes_;
     std::vector<CttiTypeId> evt_writes_;
     std::vector<CttiTypeId> evt_consumes_;
-    // #endif
+    std::vector<CttiTypeId> owns_;
+    std::vector<Group> groups_;
+
+    CttiTypeSet read_set_;
+    CttiTypeSet write_set_;
+    CttiTypeSet ctx_read_set_;
+    CttiTypeSet ctx_write_set_;
+    CttiTypeSet evt_write_set_;
+    CttiTypeSet evt_consume_set_;
+    CttiTypeSet own_set_;
   };
 
  private:
@@ -211,18 +382,12 @@ class WorldView {
       typename std::enable_if<std::is_const<T>::value, int>::type* = nullptr>
   bool view_test() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::shared_lock l(m_reads_);
-      if (!decl_.can_read<T>()) {
-        std::cerr << "[WorldView] MUTABLE view_test failed for type "
-                  << CttiTypeId::GetName<T>() << std::endl;
-        return false;
-      }
-    }
-    {
-      std::lock_guard l(m_reads_);
-      read_types_.insert(CttiTypeId::of<T>());
+    if (!decl_.can_read<T>()) {
+      std::cerr << "[WorldView] MUTABLE view_test failed for type "
+                << CttiTypeId::GetName<T>() << std::endl;
+      return false;
     }
+    record_access<T>(read_types_);
     return view_test<Others...>();
 #endif
     return true;
@@ -233,27 +398,54 @@ class WorldView {
       typename std::enable_if<!std::is_const<T>::value, int>::type* = nullptr>
   bool view_test() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::shared_lock l(m_writes_);
-      if (!decl_.can_write<T>()) {
-        std::cerr << "[WorldView] IMMUTABLE view_test failed for type "
-                  << CttiTypeId::GetName<T>() << std::endl;
-        return false;
-      }
-    }
-    {
-      std::lock_guard l(m_writes_);
-      write_types_.insert(CttiTypeId::of<T>());
+    if (!decl_.can_write<T>()) {
+      std::cerr << "[WorldView] IMMUTABLE view_test failed for type "
+                << CttiTypeId::GetName<T>() << std::endl;
+      return false;
     }
+    record_access<T>(write_types_);
     return view_test<Others...>();
 #endif
     return true;
   }
 
  public:
-  WorldView(entt::registry* registry, Decl decl);
+  WorldView(entt::registry* registry, Decl decl,
+            profile::FrameProfiler* profiler = nullptr,
+            std::uint32_t system_id = 0u);
   static WorldView Thin(entt::registry* registry);
 
+  /**
+   * Point this view at a registry and forget any access tracked so far - lets
+   *  the scheduler reuse one view per node across frames instead of building
+   *  (and allocating) a new one every time the node runs.
+   */
+  void reset(entt::registry* registry);
+
+  /**
+   * Change version taken when this view was created or last reset - pass it
+   *  to changed_view the next time the system runs to visit only entities
+   *  written since (see TrackedComponent)
+   */
+  std::uint64_t version() const { return version_; }
+
+  /**
+   * Restrict primary_view() to partition index of count - used by the
+   *  scheduler to run Node::Builder::partitioned nodes as several instances
+   *  that each see a disjoint share of the same entities. Partitioned views may
+   *  not make structural changes (attach, remove, create, destroy) directly,
+   *  only through the defer_* methods.
+   */
+  void set_partition(std::uint32_t index, std::uint32_t count);
+
+  /**
+   * This view's share of item_count items (all of them without a partition) -
+   *  for partitioned systems that iterate data kept outside of the registry
+   */
+  PartitionRange partition_range(std::uint32_t item_count) const {
+    return PartitionRange::Of(item_count, partition_index_, partition_count_);
+  }
+
 #ifdef IG_ENABLE_ECS_VALIDATION
   template <typename T>
   bool can_read() {
@@ -286,61 +478,57 @@ class WorldView {
   }
 
  private:
-  mutable std::shared_mutex m_reads_;
-  mutable std::shared_mutex m_writes_;
-  mutable std::shared_mutex m_ctx_reads_;
-  mutable std::shared_mutex m_ctx_writes_;
-  mutable std::shared_mutex m_evt_writes_;
-  mutable std::shared_mutex m_evt_consumes_;
-
-  mutable std::set<CttiTypeId> read_types_;
-  mutable std::set<CttiTypeId> write_types_;
-  mutable std::set<CttiTypeId> ctx_read_types_;
-  mutable std::set<CttiTypeId> ctx_write_types_;
-  mutable std::set<CttiTypeId> evt_queue_types_;
-  mutable std::set<CttiTypeId> evt_consume_types_;
+  // Accesses are recorded from whichever threads the owning system runs on
+  //  (including parallel_each chunks), without taking any locks
+  template <typename T>
+  static void record_access(AtomicCttiTypeSet& set) {
+    set.insert(CttiTypeId::index_of<std::remove_const_t<T>>());
+  }
+
+  template <typename T>
+  static bool has_access(const AtomicCttiTypeSet& set) {
+    return set.contains(CttiTypeId::index_of<std::remove_const_t<T>>());
+  }
+
+  mutable AtomicCttiTypeSet read_types_;
+  mutable AtomicCttiTypeSet write_types_;
+  mutable AtomicCttiTypeSet ctx_read_types_;
+  mutable AtomicCttiTypeSet ctx_write_types_;
+  mutable AtomicCttiTypeSet evt_queue_types_;
+  mutable AtomicCttiTypeSet evt_consume_types_;
 
  public:
   template <typename T>
   bool has_read() const {
-    std::shared_lock l(m_reads_);
-    return read_types_.count(CttiTypeId::of<T>()) > 0;
+    return has_access<T>(read_types_);
   }
   template <typename T>
   bool has_written() const {
-    std::shared_lock l(m_writes_);
-    return write_types_.count(CttiTypeId::of<T>()) > 0;
+    return has_access<T>(write_types_);
   }
   template <typename T>
   bool has_ctx_read() const {
-    std::shared_lock l(m_ctx_reads_);
-    return ctx_read_types_.count(CttiTypeId::of<T>()) > 0;
+    return has_access<T>(ctx_read_types_);
   }
   template <typename T>
   bool has_ctx_written() const {
-    std::shared_lock l(m_ctx_writes_);
-    return ctx_write_types_.count(CttiTypeId::of<T>()) > 0;
+    return has_access<T>(ctx_write_types_);
   }
   template <typename T>
   bool has_evt_enqueued() const {
-    std::shared_lock l(m_evt_writes_);
-    return evt_queue_types_.count(CttiTypeId::of<T>()) > 0;
+    return has_access<T>(evt_queue_types_);
   }
   template <typename T>
   bool has_evt_consumed() const {
-    std::shared_lock l(m_evt_consumes_);
-    return evt_consume_types_.count(CttiTypeId::of<T>()) > 0;
+    return has_access<T>(evt_consume_types_);
   }
 #endif
 
   template <typename T>
   T& mut_ctx() {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_ctx_writes_);
-      ::assert_and_print<T>(decl_.can_ctx_write<T>(), "mut_ctx");
-      ctx_write_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_ctx_write<T>(), "mut_ctx");
+    record_access<T>(ctx_write_types_);
 #endif
     return registry_->ctx().get<T>();
   }
@@ -348,11 +536,8 @@ class WorldView {
   template <typename T>
   const T& ctx() {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_ctx_reads_);
-      ::assert_and_print<T>(decl_.can_ctx_read<T>(), "ctx");
-      ctx_read_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_ctx_read<T>(), "ctx");
+    record_access<T>(ctx_read_types_);
 #endif
     return registry_->ctx().get<T>();
   }
@@ -360,11 +545,8 @@ class WorldView {
   template <typename T, typename... Args>
   T& mut_ctx_or_set(Args&&... args) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_ctx_writes_);
-      ::assert_and_print<T>(decl_.can_ctx_write<T>(), "mut_ctx_or_set");
-      ctx_write_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_ctx_write<T>(), "mut_ctx_or_set");
+    record_access<T>(ctx_write_types_);
 #endif
     return registry_->ctx().insert_or_assign<T, Args...>(
         std::forward<Args>(args)...);
@@ -373,11 +555,9 @@ class WorldView {
   template <typename T>
   bool has(entt::entity e) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_reads_);
-      ::assert_and_print<T>(decl_.can_read<T>(), "has");
-      read_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_read<T>(), "has");
+    assert_partition_owns<T>(e, "has", false);
+    record_access<T>(read_types_);
 #endif
     return registry_->storage<T>().contains(e);
   }
@@ -385,11 +565,8 @@ class WorldView {
   template <typename T>
   bool ctx_has() const {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_reads_);
-      ::assert_and_print<T>(decl_.can_ctx_read<T>(), "ctx_has");
-      ctx_read_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_ctx_read<T>(), "ctx_has");
+    record_access<T>(ctx_read_types_);
 #endif
     return registry_->ctx().contains<T>();
   }
@@ -397,24 +574,23 @@ class WorldView {
   template <typename T>
   T& write(entt::entity e) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_writes_);
-      ::assert_and_print<T>(decl_.can_write<T>(), "write");
-      write_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_write<T>(), "write");
+    assert_partition_owns<T>(e, "write", true);
+    record_access<T>(write_types_);
 #endif
+    mark_changed<T>(change_tracking_, e);
     return registry_->get<T>(e);
   }
 
   template <typename ComponentT, typename... Args>
   decltype(auto) attach(entt::entity e, Args&&... args) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_writes_);
-      ::assert_and_print<ComponentT>(decl_.can_write<ComponentT>(), "attach");
-      write_types_.insert(CttiTypeId::of<ComponentT>());
-    }
+    ::assert_and_print<ComponentT>(decl_.can_write<ComponentT>(), "attach");
+    ::assert_and_print<ComponentT>(partition_count_ <= 1u,
+                                   "attach (structural change in partition)");
+    record_access<ComponentT>(write_types_);
 #endif
+    mark_changed<ComponentT>(change_tracking_, e);
     return registry_->emplace<ComponentT, Args...>(e,
                                                    std::forward<Args>(args)...);
   }
@@ -422,25 +598,58 @@ class WorldView {
   template <typename ComponentT, typename... Args>
   ComponentT& attach_or_replace(entt::entity e, Args&&... args) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_writes_);
-      ::assert_and_print<ComponentT>(decl_.can_write<ComponentT>(), "attach");
-      write_types_.insert(CttiTypeId::of<ComponentT>());
-    }
+    ::assert_and_print<ComponentT>(decl_.can_write<ComponentT>(), "attach");
+    ::assert_and_print<ComponentT>(partition_count_ <= 1u,
+                                   "attach (structural change in partition)");
+    record_access<ComponentT>(write_types_);
 #endif
+    mark_changed<ComponentT>(change_tracking_, e);
     return registry_->emplace_or_replace<ComponentT, Args...>(
         e, std::forward<Args>(args)...);
   }
 
+  /**
+   * attach a copy of value to every entity in [first, last) - one range
+   *  insert into the component storage instead of one insert per entity
+   *  (see Prefab)
+   */
+  template <typename ComponentT, typename It>
+  void insert(It first, It last, const ComponentT& value = {}) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    ::assert_and_print<ComponentT>(decl_.can_write<ComponentT>(), "insert");
+    ::assert_and_print<ComponentT>(partition_count_ <= 1u,
+                                   "insert (structural change in partition)");
+    record_access<ComponentT>(write_types_);
+#endif
+    for (It it = first; it != last; ++it) {
+      mark_changed<ComponentT>(change_tracking_, *it);
+    }
+    registry_->insert<ComponentT>(first, last, value);
+  }
+
+  /** insert, attaching *from++ to each entity in [first, last) */
+  template <typename ComponentT, typename It, typename CIt>
+    requires std::is_same_v<typename std::iterator_traits<CIt>::value_type,
+                            ComponentT>
+  void insert(It first, It last, CIt from) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    ::assert_and_print<ComponentT>(decl_.can_write<ComponentT>(), "insert");
+    ::assert_and_print<ComponentT>(partition_count_ <= 1u,
+                                   "insert (structural change in partition)");
+    record_access<ComponentT>(write_types_);
+#endif
+    for (It it = first; it != last; ++it) {
+      mark_changed<ComponentT>(change_tracking_, *it);
+    }
+    registry_->insert<ComponentT>(first, last, from);
+  }
+
   template <typename ComponentT, typename... Args>
   ComponentT& attach_ctx(Args&&... args) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_ctx_writes_);
-      ::assert_and_print<ComponentT>(decl_.can_ctx_write<ComponentT>(),
-                                     "attach_ctx");
-      ctx_write_types_.insert(CttiTypeId::of<ComponentT>());
-    }
+    ::assert_and_print<ComponentT>(decl_.can_ctx_write<ComponentT>(),
+                                   "attach_ctx");
+    record_access<ComponentT>(ctx_write_types_);
 #endif
     return registry_->ctx().emplace<ComponentT, Args...>(
         std::forward<Args>(args)...);
@@ -449,11 +658,9 @@ class WorldView {
   template <typename T>
   const T& read(entt::entity e) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_reads_);
-      ::assert_and_print<T>(decl_.can_read<T>(), "read");
-      read_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_read<T>(), "read");
+    assert_partition_owns<T>(e, "read", false);
+    record_access<T>(read_types_);
 #endif
     return registry_->get<T>(e);
   }
@@ -461,11 +668,10 @@ class WorldView {
   template <typename T>
   size_t remove(entt::entity e) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_writes_);
-      ::assert_and_print<T>(decl_.can_write<T>(), "remove");
-      write_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_write<T>(), "remove");
+    ::assert_and_print<T>(partition_count_ <= 1u,
+                          "remove (structural change in partition)");
+    record_access<T>(write_types_);
 #endif
     return registry_->remove<T>(e);
   }
@@ -473,11 +679,8 @@ class WorldView {
   template <typename T>
   void remove_ctx() {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_ctx_writes_);
-      ::assert_and_print<T>(decl_.can_ctx_write<T>(), "remove_ctx");
-      ctx_write_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_ctx_write<T>(), "remove_ctx");
+    record_access<T>(ctx_write_types_);
 #endif
     registry_->ctx().erase<T>();
   }
@@ -488,55 +691,407 @@ class WorldView {
     bool rsl = view_test<Component, Other...>();
     assert(rsl);
 #endif
+    (mark_view_write<Component>(), ..., mark_view_write<Other>());
     return registry_->view<Component, Other..., Exclude...>(e);
   }
 
+  /**
+   * view<Component, Other...>(), restricted to entities where at least one of
+   *  the tracked components (see TrackedComponent) was written at or after
+   *  since_version - typically the version() of an earlier run of the same
+   *  system. Components should be const, a mutable view marks every entity of
+   *  its mutable components as changed.
+   */
+  template <typename Component, typename... Other>
+  auto changed_view(std::uint64_t since_version) {
+    constexpr std::size_t kTrackedCount =
+        (std::size_t{TrackedComponent<Component>} + ... +
+         std::size_t{TrackedComponent<Other>});
+    static_assert(kTrackedCount > 0u,
+                  "changed_view needs at least one tracked component");
+
+    auto v = view<Component, Other...>();
+    typename ChangedView<decltype(v), kTrackedCount>::Versions versions{};
+    std::size_t i = 0u;
+    (add_versions<Component>(versions, i), ...,
+     add_versions<Other>(versions, i));
+    return ChangedView<decltype(v), kTrackedCount>(v, versions, since_version);
+  }
+
+  /**
+   * view<Component, Other...>(), restricted to the partition of this view (see
+   *  set_partition) - every entity of the view without a partition. The
+   *  partition is a contiguous range of positions in the view's leading
+   *  storage, so the partitions of one view never overlap.
+   *
+   * A partitioned system should iterate one primary view, and only write to
+   *  (or read components it writes from) entities in it.
+   */
+  template <typename Component, typename... Other, typename... Exclude>
+  auto primary_view(entt::exclude_t<Exclude...> e = entt::exclude_t{}) {
+    auto v = view<Component, Other...>(e);
+    const auto* handle = v.handle();
+    PartitionRange range =
+        PartitionRange::Of(static_cast<std::uint32_t>(handle->size()),
+                           partition_index_, partition_count_);
+#ifdef IG_ENABLE_ECS_VALIDATION
+    partition_set_ = handle;
+    partition_range_ = range;
+#endif
+    return PartitionView<decltype(v)>(v, handle, range);
+  }
+
+  /**
+   * entt group owning Owned and observing Get - owned components are packed
+   *  in the same order, so iterating the group walks their storages in
+   *  lockstep instead of looking up each component through a sparse set.
+   *  Must be declared with Decl::owning_group (same template arguments).
+   *
+   * The first call for a set of components creates the group, which reorders
+   *  every owned storage - groups must be created during world setup, before
+   *  systems that touch their components run. Const-ness of the arguments is
+   *  checked against the decl, the group itself is always the registry's
+   *  mutable one.
+   */
+  template <typename... Owned, typename... Get, typename... Exclude>
+  auto group(entt::get_t<Get...> = entt::get_t{},
+             entt::exclude_t<Exclude...> = entt::exclude_t{}) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    bool rsl = view_test<Owned..., Get...>();
+    assert(rsl);
+    (::assert_and_print<Owned>(decl_.can_own<Owned>(), "group"), ...);
+#endif
+    (mark_view_write<Owned>(), ...);
+    (mark_view_write<Get>(), ...);
+    return registry_->group<std::remove_const_t<Owned>...>(
+        entt::get<std::remove_const_t<Get>...>,
+        entt::exclude<std::remove_const_t<Exclude>...>);
+  }
+
+  /**
+   * group<Owned...>(), restricted to the partition of this view (see
+   *  set_partition) - like primary_view, partitions are contiguous ranges of
+   *  the group, so each partition still walks packed memory.
+   */
+  template <typename... Owned, typename... Get, typename... Exclude>
+  auto primary_group(entt::get_t<Get...> get = entt::get_t{},
+                     entt::exclude_t<Exclude...> exclude = entt::exclude_t{}) {
+    auto g = group<Owned...>(get, exclude);
+    using LeadingT =
+        std::remove_const_t<std::tuple_element_t<0, std::tuple<Owned...>>>;
+    const entt::sparse_set* leading = &registry_->storage<LeadingT>();
+    PartitionRange range = PartitionRange::Of(
+        static_cast<std::uint32_t>(g.size()), partition_index_,
+        partition_count_);
+#ifdef IG_ENABLE_ECS_VALIDATION
+    partition_set_ = leading;
+    partition_range_ = range;
+#endif
+    return PartitionView<decltype(g)>(g, leading, range);
+  }
+
   template <typename T>
   void enqueue_event(T&& evt) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_evt_writes_);
-      ::assert_and_print<T>(decl_.can_evt_write<T>(), "enqueue_event");
-      evt_queue_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_evt_write<T>(), "enqueue_event");
+    record_access<T>(evt_queue_types_);
 #endif
     CtxEventQueue<T>& ctx_queue =
         ::get_ctx_or_create_default<CtxEventQueue<T>>(*registry_);
-    ctx_queue.queue.enqueue(evt);
+    ctx_queue.channel.enqueue(std::forward<T>(evt));
   }
 
   template <typename T>
-  std::vector<T> consume_events() {
+  void enqueue_events(std::span<const T> evts) {
 #ifdef IG_ENABLE_ECS_VALIDATION
-    {
-      std::lock_guard l(m_evt_consumes_);
-      ::assert_and_print<T>(decl_.can_evt_consume<T>(), "consume_events");
-      evt_consume_types_.insert(CttiTypeId::of<T>());
-    }
+    ::assert_and_print<T>(decl_.can_evt_write<T>(), "enqueue_events");
+    record_access<T>(evt_queue_types_);
+#endif
+    CtxEventQueue<T>& ctx_queue =
+        ::get_ctx_or_create_default<CtxEventQueue<T>>(*registry_);
+    ctx_queue.channel.enqueue_bulk(evts);
+  }
+
+  /**
+   * Every event of type T enqueued since the last consume, without copying
+   *  them out of the channel (see EventChannel::consume) - valid until the
+   *  end of the system.
+   */
+  template <typename T>
+  std::span<T> consume_events() {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    ::assert_and_print<T>(decl_.can_evt_consume<T>(), "consume_events");
+    record_access<T>(evt_consume_types_);
 #endif
     CtxEventQueue<T>& ctx_queue =
         ::get_ctx_or_create_default<CtxEventQueue<T>>(*registry_);
-    T bulk_events[16]{};
-    size_t num_evts = 0;
-    std::vector<T> evts;
-    while ((num_evts = ctx_queue.queue.try_dequeue_bulk(bulk_events, 16)) !=
-           0) {
-      for (size_t i = 0; i < num_evts; i++) {
-        evts.push_back(std::move(bulk_events[i]));
+    return ctx_queue.channel.consume();
+  }
+
+  /**
+   * Invoke fn(entity, components...) for every entity in view<Component,
+   *  Other...> (same arguments as view().each()), split into chunks that are
+   *  scheduled against any_thread. Each chunk is a contiguous range of the
+   *  view's leading storage - no list of entities is built up front.
+   *
+   * Chunk size comes from the cost per entity measured on earlier frames for
+   *  the system that owns this WorldView, aiming for chunks long enough to
+   *  hide scheduling overhead while still giving every thread several chunks.
+   *
+   * fn may run concurrently with itself, and must only touch the components
+   *  of the entity it is given. The returned promise resolves once every
+   *  entity has been visited.
+   */
+  template <typename Component, typename... Other, typename Fn>
+  std::shared_ptr<igasync::Promise<void>> parallel_each(
+      std::shared_ptr<igasync::ExecutionContext> any_thread, Fn&& fn) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    bool rsl = view_test<Component, Other...>();
+    assert(rsl);
+#endif
+    (mark_view_write<Component>(), ..., mark_view_write<Other>());
+    using ViewT = decltype(registry_->view<Component, Other...>());
+
+    struct ParallelEachState {
+      ParallelEachState(ViewT v, Fn&& f)
+          : view(v),
+            fn(std::forward<Fn>(f)),
+            remaining_chunks(0u),
+            done(igasync::Promise<void>::Create()) {}
+
+      ViewT view;
+      std::decay_t<Fn> fn;
+      std::atomic_uint32_t remaining_chunks;
+      std::shared_ptr<igasync::Promise<void>> done;
+    };
+
+    auto state = std::make_shared<ParallelEachState>(
+        registry_->view<Component, Other...>(), std::forward<Fn>(fn));
+
+    const std::uint32_t entity_count =
+        static_cast<std::uint32_t>(state->view.handle()->size());
+    const std::uint32_t grain = parallel_grain_size(entity_count);
+    const std::uint32_t chunk_count = (entity_count + grain - 1u) / grain;
+
+    auto run_chunk = [this](ParallelEachState* s, std::uint32_t begin,
+                            std::uint32_t end) {
+      auto start = std::chrono::high_resolution_clock::now();
+      const entt::entity* entities = s->view.handle()->data();
+      for (std::uint32_t i = begin; i < end; i++) {
+        entt::entity e = entities[i];
+        if (!s->view.contains(e)) continue;
+        std::apply([s, e](auto&&... c) { s->fn(e, c...); }, s->view.get(e));
       }
+      record_parallel_chunk(end - begin,
+                            std::chrono::high_resolution_clock::now() - start);
+    };
+
+    // Not worth a trip through the task queue
+    if (chunk_count <= 1u) {
+      run_chunk(state.get(), 0u, entity_count);
+      state->done->resolve();
+      return state->done;
     }
-    return std::move(evts);
+
+    state->remaining_chunks.store(chunk_count, std::memory_order_relaxed);
+    for (std::uint32_t begin = 0u; begin < entity_count; begin += grain) {
+      std::uint32_t end = std::min(begin + grain, entity_count);
+      any_thread->schedule(
+          igasync::Task::Of([state, begin, end, run_chunk]() {
+            run_chunk(state.get(), begin, end);
+            if (state->remaining_chunks.fetch_sub(
+                    1u, std::memory_order_acq_rel) == 1u) {
+              state->done->resolve();
+            }
+          }));
+    }
+
+    return state->done;
   }
 
-  inline entt::entity create() { return registry_->create(); }
+  inline entt::entity create() {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    if (!decl_.can_create_entities()) {
+      std::cerr << "ECS validation failure: method create failed (missing "
+                   "Decl::creates_entities)"
+                << std::endl;
+    }
+    assert(decl_.can_create_entities());
+    assert(partition_count_ <= 1u &&
+           "ECS validation failure: method create called in a partition");
+#endif
+    return registry_->create();
+  }
+
+  /**
+   * create() for every entity in [first, last) - fills the range with new
+   *  entities in one registry call
+   */
+  template <typename It>
+  void create(It first, It last) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    if (!decl_.can_create_entities()) {
+      std::cerr << "ECS validation failure: method create failed (missing "
+                   "Decl::creates_entities)"
+                << std::endl;
+    }
+    assert(decl_.can_create_entities());
+    assert(partition_count_ <= 1u &&
+           "ECS validation failure: method create called in a partition");
+#endif
+    registry_->create(first, last);
+  }
 
   inline bool valid(entt::entity e) { return registry_->valid(e); }
 
-  inline void destroy(entt::entity e) { registry_->destroy(e); }
+  inline void destroy(entt::entity e) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    if (!decl_.can_destroy_entities()) {
+      std::cerr << "ECS validation failure: method destroy failed (missing "
+                   "Decl::destroys_entities)"
+                << std::endl;
+    }
+    assert(decl_.can_destroy_entities());
+    assert(partition_count_ <= 1u &&
+           "ECS validation failure: method destroy called in a partition");
+#endif
+    registry_->destroy(e);
+  }
+
+  //
+  // Deferred structural changes - recorded to this view's command buffer, and
+  //  applied at the sync point of the node that owns the view: once the node
+  //  (and every partition of it) has finished, before any node that depends
+  //  on it starts. Checked against the decl like their immediate versions,
+  //  and allowed in partitioned nodes.
+  //
+  // Entities from defer_create can be used as the target of later deferred
+  //  commands on the same view.
+  //
+
+  inline CommandBuffer::DeferredEntity defer_create() {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    if (!decl_.can_create_entities()) {
+      std::cerr << "ECS validation failure: method defer_create failed "
+                   "(missing Decl::creates_entities)"
+                << std::endl;
+    }
+    assert(decl_.can_create_entities());
+#endif
+    return commands_.create();
+  }
+
+  template <typename ComponentT, typename... Args>
+  void defer_attach(CommandBuffer::Target e, Args&&... args) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    ::assert_and_print<ComponentT>(decl_.can_write<ComponentT>(),
+                                   "defer_attach");
+    record_access<ComponentT>(write_types_);
+#endif
+    commands_.attach<ComponentT>(e, std::forward<Args>(args)...);
+  }
+
+  template <typename ComponentT, typename... Args>
+  void defer_attach_or_replace(CommandBuffer::Target e, Args&&... args) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    ::assert_and_print<ComponentT>(decl_.can_write<ComponentT>(),
+                                   "defer_attach_or_replace");
+    record_access<ComponentT>(write_types_);
+#endif
+    commands_.attach_or_replace<ComponentT>(e, std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  void defer_remove(CommandBuffer::Target e) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    ::assert_and_print<T>(decl_.can_write<T>(), "defer_remove");
+    record_access<T>(write_types_);
+#endif
+    commands_.remove<T>(e);
+  }
+
+  inline void defer_destroy(entt::entity e) {
+#ifdef IG_ENABLE_ECS_VALIDATION
+    if (!decl_.can_destroy_entities()) {
+      std::cerr << "ECS validation failure: method defer_destroy failed "
+                   "(missing Decl::destroys_entities)"
+                << std::endl;
+    }
+    assert(decl_.can_destroy_entities());
+#endif
+    commands_.destroy(e);
+  }
+
+  /**
+   * Apply deferred changes recorded so far - called by the scheduler at the
+   *  sync point of the node that owns this view. Safe to call whenever no
+   *  other thread uses the registry.
+   */
+  void play_back_commands();
 
  private:
+  /** Entities per parallel_each chunk, for a view of entity_count entities */
+  std::uint32_t parallel_grain_size(std::uint32_t entity_count) const;
+  void record_parallel_chunk(
+      std::uint32_t entity_count,
+      std::chrono::high_resolution_clock::duration duration) const;
+
+  // Entities of a mutable view may be written anywhere in the system, so
+  //  every entity of each tracked mutable component counts as changed
+  template <typename T>
+  void mark_view_write() {
+    if constexpr (!std::is_const_v<T>) {
+      mark_all_changed<T>(change_tracking_);
+    }
+  }
+
+  template <typename T, typename VersionsT>
+  void add_versions(VersionsT& versions, std::size_t& i) {
+    if constexpr (TrackedComponent<T>) {
+      versions[i++] = &tracked_versions<T>(change_tracking_);
+    }
+  }
+
+#ifdef IG_ENABLE_ECS_VALIDATION
+  // Other partitions of the same system run concurrently - a partition may
+  //  only write components the system writes on entities it owns, and may not
+  //  read them from entities owned by another partition
+  template <typename T>
+  void assert_partition_owns(entt::entity e, const char* method,
+                             bool is_write) const {
+    if (partition_count_ <= 1u || !decl_.can_write<T>()) {
+      return;
+    }
+
+    bool owns = partition_set_ != nullptr;
+    if (owns && partition_set_->contains(e)) {
+      owns = partition_range_.contains(
+          static_cast<std::uint32_t>(partition_set_->index(e)));
+    } else if (is_write) {
+      owns = false;
+    }
+    if (!owns) {
+      std::cerr << "ECS validation failure: method " << method
+                << " touched an entity outside of its partition for type "
+                << CttiTypeId::GetName<T>() << std::endl;
+    }
+    assert(owns);
+  }
+
+  const entt::sparse_set* partition_set_;
+  PartitionRange partition_range_;
+#endif
+
   entt::registry* registry_;
+  // Looked up on create/reset - nullptr if the registry tracks no components
+  const CtxChangeTracking* change_tracking_;
   Decl decl_;
+  profile::FrameProfiler* profiler_;
+  std::uint32_t system_id_;
+  std::uint32_t partition_index_;
+  std::uint32_t partition_count_;
+  std::uint64_t version_;
+  CommandBuffer commands_;
 };
 }  // namespace igecs
 
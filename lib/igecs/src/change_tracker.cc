@@ -0,0 +1,94 @@
+#include <igecs/change_tracker.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// Shared by every registry - versions only have to be ordered, not dense
+std::atomic_uint64_t g_change_clock = 1u;
+
+}  // namespace
+
+namespace igecs {
+
+std::uint64_t ChangeClock::now() {
+  return g_change_clock.load(std::memory_order_relaxed);
+}
+
+std::uint64_t ChangeClock::tick() {
+  return g_change_clock.fetch_add(1u, std::memory_order_relaxed) + 1u;
+}
+
+ComponentVersions::ComponentVersions() : all_version_(0u) {
+  for (auto& page : pages_) {
+    page.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+ComponentVersions::~ComponentVersions() {
+  for (auto& page : pages_) {
+    delete[] page.load(std::memory_order_relaxed);
+  }
+}
+
+void ComponentVersions::stamp(entt::entity e, std::uint64_t version) {
+  const std::uint32_t index = static_cast<std::uint32_t>(entt::to_entity(e));
+  if (index >= kMaxEntities) {
+    return;
+  }
+
+  auto& slot = pages_[index / kPageSize];
+  std::uint64_t* page = slot.load(std::memory_order_acquire);
+  if (page == nullptr) {
+    std::uint64_t* fresh = new std::uint64_t[kPageSize]();
+    if (slot.compare_exchange_strong(page, fresh, std::memory_order_acq_rel)) {
+      page = fresh;
+    } else {
+      delete[] fresh;
+    }
+  }
+
+  page[index % kPageSize] = version;
+}
+
+void ComponentVersions::stamp_all(std::uint64_t version) {
+  all_version_.store(version, std::memory_order_relaxed);
+}
+
+bool ComponentVersions::changed_since(entt::entity e,
+                                      std::uint64_t since) const {
+  if (all_version_.load(std::memory_order_relaxed) >= since) {
+    return true;
+  }
+
+  const std::uint32_t index = static_cast<std::uint32_t>(entt::to_entity(e));
+  if (index >= kMaxEntities) {
+    return true;
+  }
+
+  const std::uint64_t* page =
+      pages_[index / kPageSize].load(std::memory_order_acquire);
+  return page != nullptr && page[index % kPageSize] >= since;
+}
+
+void CtxChangeTracking::track(std::uint32_t type_index) {
+  if (type_index >= versions_.size()) {
+    versions_.resize(type_index + 1u);
+  }
+  if (versions_[type_index] == nullptr) {
+    versions_[type_index] = std::make_unique<ComponentVersions>();
+  }
+}
+
+void change_tracking_missing(const std::string& type_name) {
+  std::fprintf(stderr,
+               "[IgECS::ChangeTracker] Component %s is tracked "
+               "(kTrackChanges), but track_changes was not called for it on "
+               "this registry\n",
+               type_name.c_str());
+  std::abort();
+}
+
+}  // namespace igecs
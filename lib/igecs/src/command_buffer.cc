@@ -0,0 +1,77 @@
+#include <igecs/command_buffer.h>
+
+namespace igecs {
+
+CommandBuffer::CommandBuffer()
+    : create_count_(0u), used_blocks_(0u), block_offset_(0u) {}
+
+CommandBuffer::~CommandBuffer() { clear(); }
+
+CommandBuffer::DeferredEntity CommandBuffer::create() {
+  DeferredEntity e{create_count_++};
+  commands_.push_back(Command{nullptr, nullptr, nullptr, entt::null, e.index});
+  return e;
+}
+
+void CommandBuffer::destroy(entt::entity e) {
+  commands_.push_back(
+      Command{&CommandBuffer::destroy_fn, nullptr, nullptr, e, 0u});
+}
+
+void CommandBuffer::destroy_fn(entt::registry& r, entt::entity e, void*) {
+  r.destroy(e);
+}
+
+void CommandBuffer::play_back(entt::registry& registry) {
+  created_.resize(create_count_);
+
+  for (Command& cmd : commands_) {
+    if (cmd.apply == nullptr) {
+      created_[cmd.created_index] = registry.create();
+      continue;
+    }
+
+    const entt::entity e =
+        cmd.entity != entt::null ? cmd.entity : created_[cmd.created_index];
+    if (registry.valid(e)) {
+      cmd.apply(registry, e, cmd.payload);
+    }
+
+    if (cmd.drop != nullptr) {
+      cmd.drop(cmd.payload);
+      cmd.drop = nullptr;
+    }
+  }
+
+  clear();
+}
+
+void CommandBuffer::clear() {
+  for (Command& cmd : commands_) {
+    if (cmd.drop != nullptr) {
+      cmd.drop(cmd.payload);
+    }
+  }
+
+  commands_.clear();
+  create_count_ = 0u;
+  created_.clear();
+  used_blocks_ = 0u;
+  block_offset_ = 0u;
+}
+
+void* CommandBuffer::allocate(std::size_t size, std::size_t align) {
+  std::size_t offset = (block_offset_ + align - 1u) & ~(align - 1u);
+  if (used_blocks_ == 0u || offset + size > kBlockSize) {
+    if (used_blocks_ == blocks_.size()) {
+      blocks_.push_back(std::make_unique<std::byte[]>(kBlockSize));
+    }
+    used_blocks_++;
+    offset = 0u;
+  }
+
+  block_offset_ = offset + size;
+  return blocks_[used_blocks_ - 1u].get() + offset;
+}
+
+}  // namespace igecs
@@ -1,7 +1,16 @@
 #include <igecs/profile/frame_profiler.h>
 
+#include <algorithm>
 #include <nlohmann/json.hpp>
 
+namespace {
+
+// Idle spans kept per frame - past this, new spans are folded into the last
+//  one, so that recording them never allocates after construction
+const std::size_t kMaxIdleSpans = 1024u;
+
+}  // namespace
+
 namespace igecs::profile {
 
 FrameProfiler::FrameProfiler(
@@ -9,7 +18,9 @@ FrameProfiler::FrameProfiler(
     const std::vector<std::thread::id>& worker_thread_ids)
     : graph_name_(graph_name),
       main_thread_id_(main_thread_id),
-      worker_thread_ids_(worker_thread_ids) {}
+      worker_thread_ids_(worker_thread_ids) {
+  idle_spans_.reserve(kMaxIdleSpans);
+}
 
 void FrameProfiler::AddSystem(igecs::CttiTypeId system_ctti,
                               std::string system_name,
@@ -54,8 +65,20 @@ void FrameProfiler::AddSystem(igecs::CttiTypeId system_ctti,
     components_[list_consume.id] =
         RegisteredComponent{list_consume.id, list_consume.name};
   }
+  for (auto& own : access.list_owns()) {
+    system.component_access.push_back(
+        {ComponentAccessMode::GroupOwn, own.id});
+    components_[own.id] = RegisteredComponent{own.id, own.name};
+  }
 
   systems_.push_back(system);
+
+  auto cost_history = std::make_unique<EntityCostHistory>();
+  cost_history->frame_ns = 0u;
+  cost_history->frame_entities = 0u;
+  cost_history->ns_per_entity = 0.;
+  entity_costs_[system.system_id] = std::move(cost_history);
+  durations_[system.system_id] = DurationHistory{0u, 0.};
 }
 
 void FrameProfiler::AddSystemDependency(igecs::CttiTypeId system_ctti,
@@ -67,16 +90,50 @@ void FrameProfiler::AddSystemDependency(igecs::CttiTypeId system_ctti,
   }
 }
 
-void FrameProfiler::ClearSystemRegistry() { systems_.clear(); }
+void FrameProfiler::ClearSystemRegistry() {
+  systems_.clear();
+  entity_costs_.clear();
+  durations_.clear();
+}
 
 void FrameProfiler::StartFrame() {
   executions_.clear();
+  idle_spans_.clear();
   frame_start_ = std::chrono::high_resolution_clock::now();
   frame_end_ = std::chrono::high_resolution_clock::time_point::min();
 }
 
 void FrameProfiler::EndFrame() {
   frame_end_ = std::chrono::high_resolution_clock::now();
+
+  // Weight of the latest frame in the moving average - high enough to follow
+  //  changes in entity counts within a handful of frames
+  const double kNewFrameWeight = 0.2;
+  for (auto& [system_id, cost] : entity_costs_) {
+    std::uint64_t ns = cost->frame_ns.exchange(0u, std::memory_order_relaxed);
+    std::uint64_t entities =
+        cost->frame_entities.exchange(0u, std::memory_order_relaxed);
+    if (entities == 0u) continue;
+
+    double frame_ns_per_entity = static_cast<double>(ns) / entities;
+    cost->ns_per_entity =
+        cost->ns_per_entity == 0.
+            ? frame_ns_per_entity
+            : cost->ns_per_entity * (1. - kNewFrameWeight) +
+                  frame_ns_per_entity * kNewFrameWeight;
+  }
+
+  for (auto& [system_id, duration] : durations_) {
+    if (duration.frame_ns == 0u) continue;
+
+    double frame_ns = static_cast<double>(duration.frame_ns);
+    duration.ns_per_frame =
+        duration.ns_per_frame == 0.
+            ? frame_ns
+            : duration.ns_per_frame * (1. - kNewFrameWeight) +
+                  frame_ns * kNewFrameWeight;
+    duration.frame_ns = 0u;
+  }
 }
 
 void FrameProfiler::AddExecution(
@@ -92,6 +149,64 @@ void FrameProfiler::AddExecution(
   execution.end_frame_time = end_time;
 
   executions_.push_back(execution);
+
+  auto it = durations_.find(system_id);
+  if (it != durations_.end() && end_time > start_time) {
+    it->second.frame_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               end_time - start_time)
+                               .count();
+  }
+}
+
+void FrameProfiler::AddEntityCostSample(
+    std::uint32_t system_id, std::uint32_t entity_count,
+    std::chrono::high_resolution_clock::duration duration) {
+  auto it = entity_costs_.find(system_id);
+  if (it == entity_costs_.end()) return;
+
+  it->second->frame_ns.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+      std::memory_order_relaxed);
+  it->second->frame_entities.fetch_add(entity_count,
+                                       std::memory_order_relaxed);
+}
+
+double FrameProfiler::EntityCostEstimate(std::uint32_t system_id) const {
+  auto it = entity_costs_.find(system_id);
+  if (it == entity_costs_.end()) return 0.;
+
+  return it->second->ns_per_entity;
+}
+
+double FrameProfiler::DurationEstimate(std::uint32_t system_id) const {
+  auto it = durations_.find(system_id);
+  if (it == durations_.end()) return 0.;
+
+  return it->second.ns_per_frame;
+}
+
+std::uint32_t FrameProfiler::ThreadCount() const {
+  return static_cast<std::uint32_t>(worker_thread_ids_.size()) + 1u;
+}
+
+void FrameProfiler::AddIdle(
+    std::thread::id thread_id,
+    std::chrono::high_resolution_clock::time_point start_time,
+    std::chrono::high_resolution_clock::time_point end_time, bool parked) {
+  if (idle_spans_.size() == kMaxIdleSpans) {
+    IdleSpan& last = idle_spans_.back();
+    last.end_frame_time = std::max(last.end_frame_time, end_time);
+    last.parked = last.parked || parked;
+    return;
+  }
+
+  IdleSpan span{};
+  span.thread_id = thread_id;
+  span.start_frame_time = start_time;
+  span.end_frame_time = end_time;
+  span.parked = parked;
+
+  idle_spans_.push_back(span);
 }
 
 std::string FrameProfiler::JsonSerializeFrame(bool pretty) {
@@ -112,6 +227,8 @@ std::string FrameProfiler::JsonSerializeFrame(bool pretty) {
         return "ListWrite";
       case FrameProfiler::ComponentAccessMode::ListConsume:
         return "ListConsume";
+      case FrameProfiler::ComponentAccessMode::GroupOwn:
+        return "GroupOwn";
       default:
         return "<< access_unknown >>";
     }
@@ -127,6 +244,10 @@ std::string FrameProfiler::JsonSerializeFrame(bool pretty) {
     if (system.main_thread_only) {
       systemj["main_thread"] = true;
     }
+    double ns_per_entity = EntityCostEstimate(system.system_id);
+    if (ns_per_entity > 0.) {
+      systemj["ns_per_entity"] = ns_per_entity;
+    }
 
     nlohmann::json accessj = nlohmann::json::array();
     for (auto& access : system.component_access) {
@@ -176,6 +297,30 @@ std::string FrameProfiler::JsonSerializeFrame(bool pretty) {
 
   j["executions"] = exj;
 
+  auto idlej = nlohmann::json::array();
+  std::int64_t total_idle_time = 0;
+  std::int64_t total_parked_time = 0;
+  for (auto& span : idle_spans_) {
+    auto start_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                          span.start_frame_time - frame_start_)
+                          .count();
+    auto end_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                        span.end_frame_time - frame_start_)
+                        .count();
+    idlej.push_back({{"thread_id", thread_id_hasher(span.thread_id)},
+                     {"parked", span.parked},
+                     {"start_time", start_time},
+                     {"end_time", end_time}});
+    total_idle_time += end_time - start_time;
+    if (span.parked) {
+      total_parked_time += end_time - start_time;
+    }
+  }
+
+  j["idle"] = idlej;
+  j["frame_meta"]["main_thread_idle_time"] = total_idle_time;
+  j["frame_meta"]["main_thread_parked_time"] = total_parked_time;
+
   if (pretty) {
     return j.dump(4);
   }
@@ -1,33 +1,80 @@
-#include <igasync/promise_combiner.h>
 #include <igecs/scheduler.h>
 
-#include <dglib/digraph.hh>
-#include <dglib/digraphop.hh>
-#include <dglib/schedule.hh>
+#include <algorithm>
+#include <deque>
 #include <iostream>
+#include <map>
+#include <optional>
+
+namespace igecs {
 
 namespace {
-template <class T>
-T& last(std::vector<T>& v) {
-  return v[v.size() - 1];
-}
 
-}  // namespace
+/**
+ * Transitive closure of a dependency graph, computed in one pass over the
+ *  nodes in topological order: row i is a bitset of every node that node i
+ *  (transitively) depends on.
+ */
+class Reachability {
+ public:
+  Reachability(const std::vector<std::vector<std::uint32_t>>& preds,
+               const std::vector<std::uint32_t>& topo_order)
+      : words_((static_cast<std::uint32_t>(preds.size()) + 63u) / 64u),
+        bits_(preds.size() * words_, 0ull) {
+    for (std::uint32_t i : topo_order) {
+      std::uint64_t* row = &bits_[i * words_];
+      for (std::uint32_t pred : preds[i]) {
+        const std::uint64_t* pred_row = &bits_[pred * words_];
+        for (std::uint32_t w = 0; w < words_; w++) {
+          row[w] |= pred_row[w];
+        }
+        row[pred / 64u] |= 1ull << (pred % 64u);
+      }
+    }
+  }
 
-namespace igecs {
+  /** True if and only if node a eventually depends on node b */
+  bool depends_on(std::uint32_t a, std::uint32_t b) const {
+    return (bits_[a * words_ + b / 64u] >> (b % 64u)) & 1ull;
+  }
+
+ private:
+  std::uint32_t words_;
+  std::vector<std::uint64_t> bits_;
+};
+
+}  // namespace
 
 //
 // Scheduler::Node::Builder
 //
 Scheduler::Node::Builder::Builder(Scheduler::Node::NodeId node_id,
                                   Scheduler::Builder& b)
-    : node_id_(node_id), is_main_thread_only_(false), b_(b), is_built_(false) {}
+    : node_id_(node_id),
+      is_main_thread_only_(false),
+      is_fixed_tick_(false),
+      partition_count_(1u),
+      b_(b),
+      is_built_(false) {}
 
 Scheduler::Node::Builder& Scheduler::Node::Builder::main_thread_only() {
   is_main_thread_only_ = true;
   return *this;
 }
 
+Scheduler::Node::Builder& Scheduler::Node::Builder::fixed_tick() {
+  is_fixed_tick_ = true;
+  return *this;
+}
+
+Scheduler::Node::Builder& Scheduler::Node::Builder::partitioned(
+    std::uint32_t partition_count) {
+  assert(partition_count > 0u &&
+         "[IgECS::Scheduler] Node must have at least one partition");
+  partition_count_ = partition_count;
+  return *this;
+}
+
 Scheduler::Node::Builder& Scheduler::Node::Builder::with_decl(
     WorldView::Decl decl) {
   world_view_decl_.merge_in_decl(decl);
@@ -45,17 +92,20 @@ Scheduler::Node::Builder& Scheduler::Node::Builder::depends_on(
 
 Scheduler::Node Scheduler::Node::Builder::build(
     std::function<std::shared_ptr<igasync::Promise<void>>(
-        WorldView* wv, std::shared_ptr<igasync::TaskList> main_thread_task_list,
-        std::shared_ptr<igasync::TaskList> any_thread_task_list,
+        WorldView* wv, std::shared_ptr<igasync::ExecutionContext> main_thread,
+        std::shared_ptr<igasync::ExecutionContext> any_thread,
         std::function<void(igasync::TaskProfile profile)> profile_cb)>
         cb,
     igecs::CttiTypeId system_id, std::string system_name) {
   assert(!is_built_ && "[IgECS::Scheduler] Node is already built");
+  assert(partition_count_ == 1u &&
+         "[IgECS::Scheduler] Only synchronous nodes can be partitioned");
 
   auto node =
       Scheduler::Node(std::move(world_view_decl_), is_main_thread_only_,
                       node_id_, std::move(dependency_ids_), std::move(cb),
-                      system_id, system_name, dependency_cttis_);
+                      nullptr, system_id, system_name, dependency_cttis_);
+  node.fixed_tick_ = is_fixed_tick_;
   b_.nodes_.push_back(node);
 
   is_built_ = true;
@@ -63,17 +113,22 @@ Scheduler::Node Scheduler::Node::Builder::build(
   return node;
 }
 
-Scheduler::Node Scheduler::Node::Builder::build(void (*cb)(WorldView* wv),
-                                                igecs::CttiTypeId system_id,
-                                                std::string system_name) {
-  auto fn = [cb](WorldView* wv,
-                 std::shared_ptr<igasync::TaskList> main_thread_task_list,
-                 std::shared_ptr<igasync::TaskList> any_thread_task_list,
-                 std::function<void(igasync::TaskProfile profile)> profile_cb) {
-    cb(wv);
-    return igasync::Promise<void>::Immediate();
-  };
-  return build(std::move(fn), system_id, system_name);
+Scheduler::Node Scheduler::Node::Builder::build(
+    std::function<void(WorldView* wv)> cb, igecs::CttiTypeId system_id,
+    std::string system_name) {
+  assert(!is_built_ && "[IgECS::Scheduler] Node is already built");
+  auto node = Scheduler::Node(std::move(world_view_decl_),
+                              is_main_thread_only_, node_id_,
+                              std::move(dependency_ids_), nullptr,
+                              std::move(cb), system_id, system_name,
+                              dependency_cttis_);
+  node.fixed_tick_ = is_fixed_tick_;
+  node.partition_count_ = partition_count_;
+  b_.nodes_.push_back(node);
+
+  is_built_ = true;
+
+  return node;
 }
 
 //
@@ -83,71 +138,46 @@ Scheduler::Node::Node()
     : id_(NodeId{0}),
       system_id_(),
       main_thread_only_(false),
+      fixed_tick_(false),
+      partition_count_(1u),
+      partition_index_(0u),
       wv_decl_(WorldView::Decl::Thin()) {}
 
 Scheduler::Node::Node(
     WorldView::Decl wv_decl, bool main_thread_only, NodeId id,
     std::vector<NodeId> dependency_ids,
     std::function<std::shared_ptr<igasync::Promise<void>>(
-        WorldView* wv, std::shared_ptr<igasync::TaskList> main_thread_task_list,
-        std::shared_ptr<igasync::TaskList> any_thread_task_list,
+        WorldView* wv, std::shared_ptr<igasync::ExecutionContext> main_thread,
+        std::shared_ptr<igasync::ExecutionContext> any_thread,
         std::function<void(igasync::TaskProfile profile)> profile_cb)>
         cb,
-    igecs::CttiTypeId system_id, std::string system_name,
-    std::vector<igecs::CttiTypeId> dependency_cttis)
+    std::function<void(WorldView* wv)> sync_cb, igecs::CttiTypeId system_id,
+    std::string system_name, std::vector<igecs::CttiTypeId> dependency_cttis)
     : id_(id),
       main_thread_only_(main_thread_only),
+      fixed_tick_(false),
+      partition_count_(1u),
+      partition_index_(0u),
       wv_decl_(std::move(wv_decl)),
       cb_(std::move(cb)),
+      sync_cb_(std::move(sync_cb)),
       dependency_ids_(std::move(dependency_ids)),
       system_id_(system_id),
       system_name_(std::move(system_name)),
       dependency_cttis_(std::move(dependency_cttis)) {}
 
-std::shared_ptr<igasync::Promise<void>> Scheduler::Node::schedule(
-    entt::registry* world, std::shared_ptr<igasync::TaskList> main_thread,
-    std::shared_ptr<igasync::TaskList> any_thread,
-    profile::FrameProfiler* profiler) {
-  auto system_id = system_id_;
-  auto rsl = igasync::Promise<void>::Create();
-  std::shared_ptr<igasync::TaskList> tl =
-      main_thread_only_ ? main_thread : any_thread;
-
-  auto profile_cb = [main_thread, profiler,
-                     system_id](igasync::TaskProfile profile) {
-    main_thread->schedule(igasync::Task::Of(
-        [profiler, system_id](igasync::TaskProfile profile) {
-          // TODO (sessamekesh): Number of entities accessed here
-          //  (that should be handled in a igecs wv layer)
-          profiler->AddExecution(system_id.id, profile.Started,
-                                 profile.Finished, 0u,
-                                 profile.ExecutorThreadId);
-        },
-        profile));
-  };
-
-  tl->schedule(igasync::Task::WithProfile(
-      profile_cb, [this, world, rsl, main_thread, any_thread, profile_cb]() {
-        auto wv = new igecs::WorldView(wv_decl_.create(world));
-        cb_(wv, main_thread, any_thread, profile_cb)
-            ->on_resolve(
-                [rsl, wv]() {
-                  rsl->resolve();
-                  delete wv;
-                },
-                any_thread);
-      }));
-
-  return rsl;
-}
-
 //
 // Scheduler::Builder
 //
 Scheduler::Builder::Builder(std::string graph_name)
     : graph_name_(graph_name),
       max_spin_time_(std::chrono::milliseconds(10)),
-      next_node_id_(1ul) {}
+      idle_spin_time_(std::chrono::microseconds(50)),
+      tick_length_(std::chrono::high_resolution_clock::duration::zero()),
+      max_ticks_per_frame_(0u),
+      on_tick_decl_(WorldView::Decl::Thin()),
+      next_node_id_(1ul),
+      infer_dependencies_(false) {}
 
 Scheduler::Builder& Scheduler::Builder::max_spin_time(
     std::chrono::high_resolution_clock::duration dt) {
@@ -155,6 +185,30 @@ Scheduler::Builder& Scheduler::Builder::max_spin_time(
   return *this;
 }
 
+Scheduler::Builder& Scheduler::Builder::idle_spin_time(
+    std::chrono::high_resolution_clock::duration dt) {
+  idle_spin_time_ = dt;
+  return *this;
+}
+
+Scheduler::Builder& Scheduler::Builder::fixed_tick(
+    std::chrono::high_resolution_clock::duration tick_length,
+    std::uint32_t max_ticks_per_frame) {
+  assert(tick_length > std::chrono::high_resolution_clock::duration::zero() &&
+         "[IgECS::Scheduler] Fixed tick length must be positive");
+  tick_length_ = tick_length;
+  max_ticks_per_frame_ = max_ticks_per_frame;
+  return *this;
+}
+
+Scheduler::Builder& Scheduler::Builder::on_tick(
+    std::function<void(entt::registry*, const TickInfo&)> cb,
+    WorldView::Decl decl) {
+  on_tick_ = std::move(cb);
+  on_tick_decl_ = std::move(decl);
+  return *this;
+}
+
 Scheduler::Builder& Scheduler::Builder::main_thread_id(std::thread::id id) {
   main_thread_id_ = id;
   return *this;
@@ -171,6 +225,11 @@ Scheduler::Builder& Scheduler::Builder::worker_thread_id(std::thread::id id) {
   return *this;
 }
 
+Scheduler::Builder& Scheduler::Builder::infer_dependencies(bool infer) {
+  infer_dependencies_ = infer;
+  return *this;
+}
+
 Scheduler::Node::Builder Scheduler::Builder::add_node() {
   return Scheduler::Node::Builder(Scheduler::Node::NodeId{next_node_id_++},
                                   *this);
@@ -178,150 +237,453 @@ Scheduler::Node::Builder Scheduler::Builder::add_node() {
 
 Scheduler Scheduler::Builder::build() { return Scheduler(*this); }
 
+//
+// Scheduler::MainThreadContext
+//
+Scheduler::MainThreadContext::MainThreadContext(
+    std::shared_ptr<igasync::TaskList> task_list)
+    : task_list_(task_list),
+      next_job_(0u),
+      queued_jobs_(0u),
+      wake_seq_(0u),
+      is_parked_(false) {}
+
+void Scheduler::MainThreadContext::schedule(
+    std::unique_ptr<igasync::Task> task) {
+  task_list_->schedule(std::move(task));
+  wake();
+}
+
+void Scheduler::MainThreadContext::schedule(WorkStealingPool::Job* job) {
+  {
+    std::lock_guard<std::mutex> l(jobs_lock_);
+    jobs_.push_back(job);
+    queued_jobs_.fetch_add(1u, std::memory_order_release);
+  }
+  wake();
+}
+
+bool Scheduler::MainThreadContext::execute_next() {
+  WorkStealingPool::Job* job = nullptr;
+  if (queued_jobs_.load(std::memory_order_acquire) > 0u) {
+    std::lock_guard<std::mutex> l(jobs_lock_);
+    job = jobs_[next_job_++];
+    queued_jobs_.fetch_sub(1u, std::memory_order_relaxed);
+    if (next_job_ == jobs_.size()) {
+      jobs_.clear();
+      next_job_ = 0u;
+    }
+  }
+
+  if (job != nullptr) {
+    job->run(job);
+    return true;
+  }
+
+  return task_list_->execute_next();
+}
+
+void Scheduler::MainThreadContext::wake() {
+  // Pairs with park(): either the parked thread sees the new sequence number
+  //  before it goes to sleep, or this thread sees that it is (about to be)
+  //  asleep and notifies it under the lock
+  wake_seq_.fetch_add(1u, std::memory_order_seq_cst);
+  if (is_parked_.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> l(park_lock_);
+    park_cv_.notify_one();
+  }
+}
+
+std::uint32_t Scheduler::MainThreadContext::wake_seq() const {
+  return wake_seq_.load(std::memory_order_seq_cst);
+}
+
+void Scheduler::MainThreadContext::park(
+    std::uint32_t wake_seq,
+    std::chrono::high_resolution_clock::time_point deadline) {
+  std::unique_lock<std::mutex> l(park_lock_);
+  is_parked_.store(true, std::memory_order_seq_cst);
+  park_cv_.wait_until(l, deadline, [this, wake_seq] {
+    return wake_seq_.load(std::memory_order_seq_cst) != wake_seq;
+  });
+  is_parked_.store(false, std::memory_order_relaxed);
+}
+
 //
 // Scheduler
 //
 
-bool Scheduler::has_strict_dep(const std::vector<Node>& nodes, Node::NodeId a,
-                               Node::NodeId b) {
-  auto find_node = [&nodes](Node::NodeId n) -> const Node& {
-    for (int i = 0; i < nodes.size(); i++) {
-      if (nodes[i].id_ == n) {
-        return nodes[i];
+std::vector<std::vector<std::uint32_t>> Scheduler::infer_dependency_indices(
+    const std::vector<Node>& nodes, const std::vector<WorldView::Decl>& decls,
+    const std::vector<bool>& is_tick_node) {
+  const std::uint32_t n = static_cast<std::uint32_t>(nodes.size());
+  const std::uint32_t words = (n + 63u) / 64u;
+
+  // ancestors[i] is a bitset of every node that node i (transitively) depends
+  //  on so far
+  std::vector<std::vector<std::uint64_t>> ancestors(
+      n, std::vector<std::uint64_t>(words, 0ull));
+  std::vector<std::vector<std::uint32_t>> preds(n);
+
+  for (std::uint32_t i = 0; i < n; i++) {
+    // Walk earlier nodes latest-first: every node that could make the edge
+    //  j -> i redundant (j -> k -> i, for j < k < i) has been visited already,
+    //  so an edge is only added if it is not implied by the ones already added
+    for (std::uint32_t j = i; j-- > 0;) {
+      if ((ancestors[i][j / 64u] >> (j % 64u)) & 1ull) continue;
+      // Partitions of the same node touch disjoint sets of entities
+      if (nodes[i].id_ == nodes[j].id_) continue;
+      // Fixed tick nodes always run before per-frame nodes
+      if (is_tick_node[i] != is_tick_node[j]) continue;
+      if (!decls[i].conflicts_with(decls[j])) continue;
+
+      preds[i].push_back(j);
+      ancestors[i][j / 64u] |= 1ull << (j % 64u);
+      for (std::uint32_t w = 0; w < words; w++) {
+        ancestors[i][w] |= ancestors[j][w];
       }
     }
+  }
 
-    assert(false && "No node with id found");
-    return nodes[0];
-  };
+  return preds;
+}
+
+Scheduler::GraphStats Scheduler::compute_graph_stats(
+    const std::vector<std::vector<std::uint32_t>>& preds) {
+  GraphStats stats{};
+  stats.node_count = static_cast<std::uint32_t>(preds.size());
 
-  const Node& na = find_node(a);
-  for (int i = 0; i < na.dependency_ids_.size(); i++) {
-    if (na.dependency_ids_[i] == b ||
-        has_strict_dep(nodes, na.dependency_ids_[i], b)) {
-      return true;
+  // depth[i] is the number of nodes on the longest chain ending in node i
+  std::vector<std::uint32_t> depth(preds.size(), 1u);
+  for (std::uint32_t i = 0; i < preds.size(); i++) {
+    stats.edge_count += static_cast<std::uint32_t>(preds[i].size());
+    for (std::uint32_t pred : preds[i]) {
+      assert(pred < i && "[IgECS::Scheduler] Dependency added after dependent");
+      depth[i] = std::max(depth[i], depth[pred] + 1u);
     }
+    stats.critical_path_length = std::max(stats.critical_path_length, depth[i]);
   }
 
-  return false;
+  std::vector<std::uint32_t> width(stats.critical_path_length + 1u, 0u);
+  for (std::uint32_t d : depth) {
+    stats.max_width = std::max(stats.max_width, ++width[d]);
+  }
+
+  return stats;
+}
+
+float Scheduler::GraphStats::average_parallelism() const {
+  if (critical_path_length == 0u) return 0.f;
+  return static_cast<float>(node_count) / critical_path_length;
+}
+
+std::ostream& operator<<(std::ostream& o, const Scheduler::GraphStats& s) {
+  return o << s.node_count << " nodes, " << s.edge_count << " edges, "
+           << "critical path " << s.critical_path_length << " nodes, "
+           << "max width " << s.max_width << ", average parallelism "
+           << s.average_parallelism();
 }
 
 Scheduler::Scheduler(Scheduler::Builder b)
     : frame_profiler_(b.graph_name_, b.main_thread_id_,
                       std::move(b.worker_thread_ids_)),
-      max_spin_time_(b.max_spin_time_) {
-  // Build a digraph of nodes...
-  digraph<Node::NodeId, int> g;
-  for (int i = 0; i < b.nodes_.size(); i++) {
-    g.add(b.nodes_[i].id_);
-    for (int j = 0; j < b.nodes_[i].dependency_ids_.size(); j++) {
-      g.add(b.nodes_[i].id_, b.nodes_[i].dependency_ids_[j], 1);
+      max_spin_time_(b.max_spin_time_),
+      idle_spin_time_(b.idle_spin_time_),
+      tick_node_count_(0u),
+      tick_length_(b.tick_length_),
+      max_ticks_per_frame_(b.max_ticks_per_frame_),
+      on_tick_(std::move(b.on_tick_)),
+      on_tick_decl_(std::move(b.on_tick_decl_)),
+      tick_accumulator_(std::chrono::high_resolution_clock::duration::zero()),
+      frame_time_(std::chrono::high_resolution_clock::duration::zero()),
+      next_tick_index_(0u),
+      frame_state_(std::make_unique<FrameState>()) {
+  //
+  // Compile the graph: everything that can be computed once about the shape of
+  //  the graph is computed here, so that executing a frame only has to reset
+  //  a set of counters and release root nodes.
+  //
+  // Partitioned nodes are expanded here - a dependency on a partitioned node
+  //  is a dependency on every one of its partitions
+  std::vector<Node> in_nodes;
+  for (const Node& node : b.nodes_) {
+    for (std::uint32_t p = 0; p < node.partition_count_; p++) {
+      in_nodes.push_back(node);
+      in_nodes.back().partition_index_ = p;
     }
   }
-#ifdef IG_ENABLE_ECS_VALIDATION
-  // Make sure that there are no cycles in the graph (using digraph lib)
-  assert(cycles(g) == 0 && "[IgECS::Scheduler] Cycle in input graph found!");
-
-  // Make sure all nodes that write any component writes either strictly depend
-  //  on, or are depended on by, all other nodes that read/write that same
-  //  component type in the same context
-  for (int node_idx = 0; node_idx < b.nodes_.size(); node_idx++) {
-    const auto& node = b.nodes_[node_idx];
-    const auto& ctx_writes = node.wv_decl_.list_ctx_writes();
-    const auto& writes = node.wv_decl_.list_writes();
-    const auto& consumes = node.wv_decl_.list_evt_consumes();
-
-    // CTX read/write comparisons...
-    for (int ctx_write_idx = 0; ctx_write_idx < ctx_writes.size();
-         ctx_write_idx++) {
-      const auto& ctx_write = ctx_writes[ctx_write_idx];
-
-      for (int compare_node_idx = 0; compare_node_idx < b.nodes_.size();
-           compare_node_idx++) {
-        if (compare_node_idx == node_idx) continue;
-
-        const auto& compare_node = b.nodes_[compare_node_idx];
-        if (::vec_contains(compare_node.wv_decl_.list_ctx_writes(),
-                           ctx_write) ||
-            ::vec_contains(compare_node.wv_decl_.list_ctx_reads(), ctx_write)) {
-          if (!has_strict_dep(b.nodes_, node.id_, compare_node.id_) &&
-              !has_strict_dep(b.nodes_, compare_node.id_, node.id_)) {
-            assert(false &&
-                   "[IgECS::Scheduler] Strict dependency not found between "
-                   "ctx_write and other ctx access!");
-          }
-        }
-      }
+
+  std::map<Node::NodeId, std::vector<std::uint32_t>> idx_by_id;
+  for (std::uint32_t i = 0; i < in_nodes.size(); i++) {
+    idx_by_id[in_nodes[i].id_].push_back(i);
+  }
+
+  // Structural changes to any member of an owning group reorder every owned
+  //  storage of it - conflicts are found on decls widened to match
+  std::vector<WorldView::Decl::Group> groups;
+  for (const Node& node : in_nodes) {
+    for (const auto& group : node.wv_decl_.list_groups()) {
+      if (!::vec_contains(groups, group)) groups.push_back(group);
     }
+  }
+  std::vector<WorldView::Decl> access_decls;
+  access_decls.reserve(in_nodes.size());
+  for (const Node& node : in_nodes) {
+    access_decls.push_back(node.wv_decl_.with_group_writes(groups));
+  }
 
-    // Component read/write comparisons...
-    for (int write_idx = 0; write_idx < writes.size(); write_idx++) {
-      const auto& write = writes[write_idx];
+  // Without a fixed tick rate, fixed tick nodes are just per-frame nodes
+  const bool has_fixed_tick =
+      tick_length_ > std::chrono::high_resolution_clock::duration::zero();
+  std::vector<bool> is_tick_node(in_nodes.size(), false);
+  for (std::uint32_t i = 0; i < in_nodes.size(); i++) {
+    is_tick_node[i] = has_fixed_tick && in_nodes[i].fixed_tick_;
+  }
 
-      for (int compare_node_idx = 0; compare_node_idx < b.nodes_.size();
-           compare_node_idx++) {
-        if (compare_node_idx == node_idx) continue;
+  std::vector<std::vector<std::uint32_t>> in_preds(in_nodes.size());
+  for (std::uint32_t i = 0; i < in_nodes.size(); i++) {
+    for (const auto& dep_id : in_nodes[i].dependency_ids_) {
+      auto it = idx_by_id.find(dep_id);
+      assert(it != idx_by_id.end() &&
+             "[IgECS::Scheduler] Node dependency listed but not found");
+      if (it == idx_by_id.end()) continue;
+      for (std::uint32_t dep_idx : it->second) {
+        in_preds[i].push_back(dep_idx);
+      }
+    }
+  }
+  hand_written_graph_stats_ = compute_graph_stats(in_preds);
+
+  if (b.infer_dependencies_) {
+    in_preds = infer_dependency_indices(in_nodes, access_decls, is_tick_node);
 
-        const auto& compare_node = b.nodes_[compare_node_idx];
-        if (::vec_contains(compare_node.wv_decl_.list_writes(), write) ||
-            ::vec_contains(compare_node.wv_decl_.list_reads(), write)) {
-          if (!has_strict_dep(b.nodes_, node.id_, compare_node.id_) &&
-              !has_strict_dep(b.nodes_, compare_node.id_, node.id_)) {
-            assert(false &&
-                   "[IgECS::Scheduler] Strict dependency not found between "
-                   "write and other component access!");
-          }
+    // Validation and the profiler both read dependencies off of the nodes
+    for (std::uint32_t i = 0; i < in_nodes.size(); i++) {
+      in_nodes[i].dependency_ids_.clear();
+      in_nodes[i].dependency_cttis_.clear();
+      for (std::uint32_t pred : in_preds[i]) {
+        if (::vec_contains(in_nodes[i].dependency_ids_, in_nodes[pred].id_)) {
+          continue;
         }
+        in_nodes[i].dependency_ids_.push_back(in_nodes[pred].id_);
+        in_nodes[i].dependency_cttis_.push_back(in_nodes[pred].system_id_);
       }
     }
+  }
+  graph_stats_ = compute_graph_stats(in_preds);
 
-    // Event queue/consume comparisons...
-    for (int consume_idx = 0; consume_idx < consumes.size(); consume_idx++) {
-      const auto& consume = consumes[consume_idx];
-
-      for (int compare_node_idx = 0; compare_node_idx < b.nodes_.size();
-           compare_node_idx++) {
-        if (compare_node_idx == node_idx) continue;
-
-        const auto& compare_node = b.nodes_[compare_node_idx];
-        if (::vec_contains(compare_node.wv_decl_.list_evt_writes(), consume) ||
-            ::vec_contains(compare_node.wv_decl_.list_evt_consumes(),
-                           consume)) {
-          if (!has_strict_dep(b.nodes_, node.id_, compare_node.id_) &&
-              !has_strict_dep(b.nodes_, compare_node.id_, node.id_)) {
-            assert(false &&
-                   "[IgECS::Scheduler] Strict dependency not found between "
-                   "event consume and event enqueue nodes!");
-          }
-        }
+  std::vector<std::vector<std::uint32_t>> in_successors(in_nodes.size());
+  std::vector<std::uint32_t> in_dep_counts(in_nodes.size(), 0u);
+  for (std::uint32_t i = 0; i < in_nodes.size(); i++) {
+    for (std::uint32_t pred : in_preds[i]) {
+      assert((!is_tick_node[i] || is_tick_node[pred]) &&
+             "[IgECS::Scheduler] Fixed tick node depends on a per-frame node");
+      in_successors[pred].push_back(i);
+      in_dep_counts[i]++;
+    }
+  }
+
+  // Kahn's algorithm - breadth-first topological sort, ties broken by the order
+  //  in which nodes were added to the builder
+  std::vector<std::uint32_t> order;
+  order.reserve(in_nodes.size());
+  {
+    std::vector<std::uint32_t> remaining_deps = in_dep_counts;
+    std::deque<std::uint32_t> ready;
+    for (std::uint32_t i = 0; i < in_nodes.size(); i++) {
+      if (remaining_deps[i] == 0) ready.push_back(i);
+    }
+    while (!ready.empty()) {
+      std::uint32_t idx = ready.front();
+      ready.pop_front();
+      order.push_back(idx);
+      for (std::uint32_t succ : in_successors[idx]) {
+        if (--remaining_deps[succ] == 0) ready.push_back(succ);
       }
     }
   }
-#endif
-  auto s = bfschedule(g);
-  for (Node::NodeId nid : s.elements()) {
+  assert(order.size() == in_nodes.size() &&
+         "[IgECS::Scheduler] Cycle in input graph found!");
+
+  const Reachability reachability(in_preds, order);
+
 #ifdef IG_ENABLE_ECS_VALIDATION
-    bool found_node = false;
+  // Make sure every pair of nodes whose decls conflict (see
+  //  WorldView::Decl::conflicts_with) is ordered by a strict dependency in the
+  //  same context. Partitions of the same node are exempt - WorldView checks
+  //  that each one only writes to its own entities.
+  for (std::uint32_t node_idx = 0; node_idx < in_nodes.size(); node_idx++) {
+    for (std::uint32_t compare_node_idx = node_idx + 1;
+         compare_node_idx < in_nodes.size(); compare_node_idx++) {
+      if (is_tick_node[compare_node_idx] != is_tick_node[node_idx]) continue;
+      if (in_nodes[compare_node_idx].id_ == in_nodes[node_idx].id_) continue;
+      if (reachability.depends_on(node_idx, compare_node_idx) ||
+          reachability.depends_on(compare_node_idx, node_idx)) {
+        continue;
+      }
+
+      // Same rule that infer_dependency_indices uses to add edges
+      assert(!access_decls[node_idx].conflicts_with(
+                 access_decls[compare_node_idx]) &&
+             "[IgECS::Scheduler] Strict dependency not found between nodes "
+             "with conflicting component, ctx, event or entity access!");
+    }
+  }
 #endif
-    for (int i = 0; i < b.nodes_.size(); i++) {
-      if (b.nodes_[i].id_ == nid) {
-        nodes_.push_back(b.nodes_[i]);
-        frame_profiler_.AddSystem(
-            b.nodes_[i].system_id_, b.nodes_[i].system_name_,
-            b.nodes_[i].wv_decl_, b.nodes_[i].main_thread_only_);
-        for (auto& dep : b.nodes_[i].dependency_cttis_) {
-          frame_profiler_.AddSystemDependency(b.nodes_[i].system_id_, dep);
+
+  std::vector<std::uint32_t> pos_by_idx(in_nodes.size(), 0u);
+  for (std::uint32_t pos = 0; pos < order.size(); pos++) {
+    pos_by_idx[order[pos]] = pos;
+  }
+
+  // Per-frame nodes that only depend on each other, and touch nothing that a
+  //  fixed tick node or on_tick touches, run alongside the ticks
+  std::vector<bool> runs_with_ticks(in_nodes.size(), false);
+  if (has_fixed_tick) {
+    for (std::uint32_t idx : order) {
+      if (is_tick_node[idx] ||
+          access_decls[idx].conflicts_with(on_tick_decl_)) {
+        continue;
+      }
+      bool can_run = true;
+      for (std::uint32_t pred : in_preds[idx]) {
+        can_run = can_run && runs_with_ticks[pred];
+      }
+      for (std::uint32_t other = 0; can_run && other < in_nodes.size();
+           other++) {
+        can_run = !is_tick_node[other] ||
+                  !access_decls[idx].conflicts_with(access_decls[other]);
+      }
+      runs_with_ticks[idx] = can_run;
+    }
+  }
+
+  // Edges from fixed tick nodes to per-frame nodes are satisfied by holding
+  //  back per-frame nodes that do not run with the ticks until every tick is
+  //  done - only edges within a subgraph are compiled. Edges that are implied
+  //  by another dependency of the same node (a -> c, where also a -> b -> c)
+  //  are dropped, they would only cost an extra counter update.
+  std::vector<std::vector<std::uint32_t>> compiled_successors(in_nodes.size());
+  std::vector<std::uint32_t> compiled_dep_counts(in_nodes.size(), 0u);
+  std::vector<bool> waits_for_ticks_through_pred(in_nodes.size(), false);
+  for (std::uint32_t i = 0; i < in_nodes.size(); i++) {
+    for (std::uint32_t pred : in_preds[i]) {
+      if (is_tick_node[pred] != is_tick_node[i]) continue;
+
+      bool is_implied = false;
+      for (std::uint32_t other : in_preds[i]) {
+        if (other != pred && reachability.depends_on(other, pred)) {
+          is_implied = true;
+          break;
         }
-#ifdef IG_ENABLE_ECS_VALIDATION
-        found_node = true;
-#endif
-        break;
+      }
+      if (is_implied) continue;
+
+      compiled_successors[pred].push_back(i);
+      compiled_dep_counts[i]++;
+      if (!is_tick_node[pred] && !runs_with_ticks[pred]) {
+        waits_for_ticks_through_pred[i] = true;
       }
     }
-#ifdef IG_ENABLE_ECS_VALIDATION
-    assert(found_node &&
-           "[IgECS::Scheduler] Input node with given ID not found!");
-#endif
+  }
+
+  nodes_.reserve(order.size());
+  successor_offsets_.reserve(order.size() + 1);
+  dependency_counts_.reserve(order.size());
+  for (std::uint32_t idx : order) {
+    const Node& node = in_nodes[idx];
+    nodes_.push_back(node);
+    if (node.partition_index_ == 0u) {
+      frame_profiler_.AddSystem(node.system_id_, node.system_name_,
+                                node.wv_decl_, node.main_thread_only_);
+      for (auto& dep : node.dependency_cttis_) {
+        frame_profiler_.AddSystemDependency(node.system_id_, dep);
+      }
+    }
+
+    successor_offsets_.push_back(
+        static_cast<std::uint32_t>(successors_.size()));
+    for (std::uint32_t succ : compiled_successors[idx]) {
+      successors_.push_back(pos_by_idx[succ]);
+    }
+    std::uint32_t dep_count = compiled_dep_counts[idx];
+    if (is_tick_node[idx]) {
+      tick_node_count_++;
+      if (dep_count == 0) tick_root_nodes_.push_back(pos_by_idx[idx]);
+    } else if (runs_with_ticks[idx]) {
+      if (dep_count == 0) root_nodes_.push_back(pos_by_idx[idx]);
+    } else if (!waits_for_ticks_through_pred[idx]) {
+      dep_count++;
+      after_tick_nodes_.push_back(pos_by_idx[idx]);
+    }
+    dependency_counts_.push_back(dep_count);
+    is_tick_node_.push_back(is_tick_node[idx]);
+  }
+  successor_offsets_.push_back(static_cast<std::uint32_t>(successors_.size()));
+
+  // Nodes of each partitioned node, in partition order
+  {
+    std::map<Node::NodeId, std::uint32_t> group_by_id;
+    partition_groups_.resize(nodes_.size(), 0u);
+    for (std::uint32_t i = 0; i < nodes_.size(); i++) {
+      if (nodes_[i].partition_count_ == 1u) continue;
+      auto it = group_by_id.find(nodes_[i].id_);
+      if (it == group_by_id.end()) {
+        it = group_by_id
+                 .emplace(nodes_[i].id_,
+                          static_cast<std::uint32_t>(partitions_.size()))
+                 .first;
+        partitions_.emplace_back(nodes_[i].partition_count_, 0u);
+      }
+      partition_groups_[i] = it->second;
+      partitions_[it->second][nodes_[i].partition_index_] = i;
+    }
+  }
+
+  frame_state_->pending_deps =
+      std::make_unique<std::atomic_uint32_t[]>(nodes_.size());
+  frame_state_->pending_partitions =
+      std::make_unique<std::atomic_uint32_t[]>(partitions_.size());
+  frame_state_->remaining_tick_nodes = 0u;
+  frame_state_->remaining_frame_nodes = 0u;
+  frame_state_->is_tick_done = true;
+  frame_state_->is_frame_done = true;
+  frame_state_->main_thread_task_list = igasync::TaskList::Create();
+  frame_state_->main_thread = std::make_shared<MainThreadContext>(
+      frame_state_->main_thread_task_list);
+  frame_state_->world = nullptr;
+  frame_state_->scheduler = nullptr;
+
+  priorities_.resize(nodes_.size(), 0.);
+  frame_state_->ready_heap.reserve(nodes_.size());
+  frame_state_->released_nodes.reserve(after_tick_nodes_.size());
+  frame_state_->node_jobs = std::make_unique<NodeJob[]>(nodes_.size());
+  frame_state_->ready_jobs = std::make_unique<NodeJob[]>(nodes_.size());
+  frame_state_->node_runs = std::make_unique<NodeRun[]>(nodes_.size());
+  frame_state_->world_views.resize(nodes_.size());
+  frame_state_->profile_cbs.reserve(nodes_.size());
+  for (std::uint32_t i = 0; i < nodes_.size(); i++) {
+    FrameState* fs = frame_state_.get();
+    fs->node_jobs[i].run = &Scheduler::run_node_job;
+    fs->node_jobs[i].fs = fs;
+    fs->node_jobs[i].node_idx = i;
+    fs->ready_jobs[i].run = &Scheduler::run_ready_job;
+    fs->ready_jobs[i].fs = fs;
+    fs->ready_jobs[i].node_idx = i;
+    fs->node_runs[i].ran = false;
+
+    // Profiles reported by async systems (e.g. for their own tasks) are added
+    //  on the main thread, like the profiler expects
+    std::uint16_t system_id = nodes_[i].system_id_.id;
+    fs->profile_cbs.push_back([fs, system_id](igasync::TaskProfile profile) {
+      fs->main_thread_task_list->schedule(igasync::Task::Of(
+          [fs, system_id](igasync::TaskProfile profile) {
+            fs->scheduler->frame_profiler_.AddExecution(
+                system_id, profile.Started, profile.Finished, 0u,
+                profile.ExecutorThreadId);
+          },
+          profile));
+    });
   }
 
   if (nodes_.size() == 0) {
@@ -330,8 +692,216 @@ Scheduler::Scheduler(Scheduler::Builder b)
   }
 }
 
+bool Scheduler::runs_on_main_thread(std::uint32_t node_idx) const {
+  const FrameState& fs = *frame_state_;
+
+  // Without an any-thread executor, every node runs on the main thread
+  return nodes_[node_idx].main_thread_only_ ||
+         fs.any_thread_task_list == fs.main_thread_task_list;
+}
+
+void Scheduler::dispatch_node(std::uint32_t node_idx) {
+  FrameState& fs = *frame_state_;
+
+  if (runs_on_main_thread(node_idx)) {
+    fs.main_thread->schedule(&fs.node_jobs[node_idx]);
+    return;
+  }
+
+  push_ready(node_idx);
+  schedule_ready_job(node_idx);
+}
+
+bool Scheduler::runs_after(std::uint32_t a, std::uint32_t b) const {
+  // Ties go to the node that comes first in topological order
+  return priorities_[a] < priorities_[b] ||
+         (priorities_[a] == priorities_[b] && a > b);
+}
+
+void Scheduler::push_ready(std::uint32_t node_idx) {
+  FrameState& fs = *frame_state_;
+  auto by_priority = [this](std::uint32_t a, std::uint32_t b) {
+    return runs_after(a, b);
+  };
+
+  std::lock_guard<std::mutex> l(fs.ready_lock);
+  fs.ready_heap.push_back(node_idx);
+  std::push_heap(fs.ready_heap.begin(), fs.ready_heap.end(), by_priority);
+}
+
+void Scheduler::schedule_ready_job(std::uint32_t node_idx) {
+  FrameState& fs = *frame_state_;
+  NodeJob* job = &fs.ready_jobs[node_idx];
+
+  if (fs.any_thread_pool) {
+    fs.any_thread_pool->schedule(job);
+  } else {
+    fs.any_thread_task_list->schedule(
+        igasync::Task::Of([job]() { job->run(job); }));
+  }
+}
+
+void Scheduler::run_node_job(WorkStealingPool::Job* job) {
+  NodeJob* node_job = static_cast<NodeJob*>(job);
+  node_job->fs->scheduler->run_node(node_job->node_idx);
+}
+
+void Scheduler::run_ready_job(WorkStealingPool::Job* job) {
+  // The job belongs to whichever node was released with it, but runs the
+  //  most important node that is ready right now
+  FrameState* fs = static_cast<NodeJob*>(job)->fs;
+  Scheduler* scheduler = fs->scheduler;
+  auto by_priority = [scheduler](std::uint32_t a, std::uint32_t b) {
+    return scheduler->runs_after(a, b);
+  };
+
+  std::uint32_t node_idx = 0u;
+  {
+    std::lock_guard<std::mutex> l(fs->ready_lock);
+    assert(!fs->ready_heap.empty() &&
+           "[IgECS::Scheduler] Ready job scheduled without a ready node");
+    std::pop_heap(fs->ready_heap.begin(), fs->ready_heap.end(), by_priority);
+    node_idx = fs->ready_heap.back();
+    fs->ready_heap.pop_back();
+  }
+
+  scheduler->run_node(node_idx);
+}
+
+void Scheduler::run_node(std::uint32_t node_idx) {
+  FrameState& fs = *frame_state_;
+  const Node& node = nodes_[node_idx];
+  NodeRun& run = fs.node_runs[node_idx];
+
+  run.thread_id = std::this_thread::get_id();
+  run.start = std::chrono::high_resolution_clock::now();
+
+  auto& wv = fs.world_views[node_idx];
+  if (wv == nullptr) {
+    wv = std::make_unique<WorldView>(fs.world, node.wv_decl_, &frame_profiler_,
+                                     node.system_id_.id);
+    wv->set_partition(node.partition_index_, node.partition_count_);
+  } else {
+    wv->reset(fs.world);
+  }
+
+  // Timing is recorded before finishing the node - the subgraph (and the
+  //  report of node timings) may complete as soon as it finishes
+  if (node.sync_cb_) {
+    node.sync_cb_(wv.get());
+    play_back_commands(node_idx);
+    run.end = std::chrono::high_resolution_clock::now();
+    run.ran = true;
+    finish_node(node_idx);
+    return;
+  }
+
+  // Async nodes are timed until their promise resolves, not until the
+  //  callback returns - otherwise only the time it took to schedule their
+  //  work would count towards their priority
+  auto rsl = node.cb_(wv.get(), fs.main_thread, fs.any_thread,
+                      fs.profile_cbs[node_idx]);
+  rsl->on_resolve(
+      [this, node_idx]() {
+        play_back_commands(node_idx);
+        NodeRun& run = frame_state_->node_runs[node_idx];
+        run.end = std::chrono::high_resolution_clock::now();
+        run.ran = true;
+        finish_node(node_idx);
+      },
+      fs.any_thread);
+}
+
+void Scheduler::play_back_commands(std::uint32_t node_idx) {
+  FrameState& fs = *frame_state_;
+  const Node& node = nodes_[node_idx];
+  if (node.partition_count_ == 1u) {
+    fs.world_views[node_idx]->play_back_commands();
+    return;
+  }
+
+  // Successors wait for every partition - the last partition to finish plays
+  //  back commands of all of them (in partition order) before it finishes
+  const std::uint32_t group = partition_groups_[node_idx];
+  if (fs.pending_partitions[group].fetch_sub(
+          1u, std::memory_order_acq_rel) != 1u) {
+    return;
+  }
+  for (std::uint32_t partition_idx : partitions_[group]) {
+    fs.world_views[partition_idx]->play_back_commands();
+  }
+}
+
+void Scheduler::finish_node(std::uint32_t node_idx) {
+  FrameState& fs = *frame_state_;
+
+  for (std::uint32_t i = successor_offsets_[node_idx];
+       i < successor_offsets_[node_idx + 1]; i++) {
+    std::uint32_t succ = successors_[i];
+    if (fs.pending_deps[succ].fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+      dispatch_node(succ);
+    }
+  }
+
+  // Nothing on the frame state may be touched after the last node finishes -
+  //  the main thread is free to start tearing down the frame at that point.
+  const bool is_tick_node = is_tick_node_[node_idx];
+  auto& remaining =
+      is_tick_node ? fs.remaining_tick_nodes : fs.remaining_frame_nodes;
+  if (remaining.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+    auto main_thread = fs.main_thread;
+    (is_tick_node ? fs.is_tick_done : fs.is_frame_done)
+        .store(true, std::memory_order_release);
+    main_thread->wake();
+  }
+}
+
 void Scheduler::execute(std::shared_ptr<igasync::TaskList> any_thread_task_list,
                         entt::registry* world) {
+  FrameState& fs = *frame_state_;
+
+  // Single threaded case: concurrency is not real, and all tasks should be
+  //  scheduled against the main thread
+  if (any_thread_task_list == nullptr) {
+    any_thread_task_list = fs.main_thread_task_list;
+  }
+
+  fs.any_thread_task_list = any_thread_task_list;
+  fs.any_thread = any_thread_task_list;
+  execute_frame(world);
+  fs.any_thread_task_list = nullptr;
+  fs.any_thread = nullptr;
+}
+
+void Scheduler::execute(std::shared_ptr<WorkStealingPool> any_thread_pool,
+                        entt::registry* world) {
+  if (any_thread_pool == nullptr) {
+    execute(nullptr, world);
+    return;
+  }
+
+  FrameState& fs = *frame_state_;
+  fs.any_thread_pool = any_thread_pool;
+  fs.any_thread = any_thread_pool;
+  execute_frame(world);
+  fs.any_thread_pool = nullptr;
+  fs.any_thread = nullptr;
+}
+
+void Scheduler::execute(std::nullptr_t, entt::registry* world) {
+  execute(std::shared_ptr<igasync::TaskList>(nullptr), world);
+}
+
+void Scheduler::advance_time(
+    std::chrono::high_resolution_clock::duration dt) {
+  tick_accumulator_ += dt;
+  frame_time_ = dt;
+}
+
+void Scheduler::execute_frame(entt::registry* world) {
+  using Duration = std::chrono::high_resolution_clock::duration;
+  using FpSeconds = std::chrono::duration<float>;
+
   frame_profiler_.StartFrame();
 
   // Degenerate case
@@ -339,75 +909,157 @@ void Scheduler::execute(std::shared_ptr<igasync::TaskList> any_thread_task_list,
     return;
   }
 
-  auto main_thread_task_list = igasync::TaskList::Create();
+  FrameState& fs = *frame_state_;
+  fs.world = world;
 
-  // Single threaded case: concurrency is not real, and all tasks should be
-  //  scheduled against the main thread
-  if (any_thread_task_list == nullptr) {
-    any_thread_task_list = main_thread_task_list;
+  // World views hold on to the profiler of the scheduler that built them, so
+  //  they are rebuilt if the scheduler has moved since the last frame
+  if (fs.scheduler != this) {
+    fs.scheduler = this;
+    for (auto& wv : fs.world_views) {
+      wv = nullptr;
+    }
   }
 
-  struct SNode {
-    Node::NodeId id;
-    std::shared_ptr<igasync::Promise<void>> rslPromise;
-  };
-  std::vector<SNode> schedule;
-  schedule.reserve(nodes_.size());
-
-  auto all_nodes_combiner = igasync::PromiseCombiner::Create();
-
-  for (int i = 0; i < nodes_.size(); i++) {
-    if (nodes_[i].dependency_ids_.size() == 0) {
-      schedule.push_back(SNode{
-          nodes_[i].id_,
-          nodes_[i].schedule(world, main_thread_task_list, any_thread_task_list,
-                             &frame_profiler_),
-      });
-      all_nodes_combiner->add(::last(schedule).rslPromise,
-                              any_thread_task_list);
-      continue;
+  update_priorities();
+
+  std::uint32_t tick_count = 0u;
+  float interpolation_alpha = 1.f;
+  if (tick_length_ > Duration::zero()) {
+    while (tick_accumulator_ >= tick_length_ &&
+           tick_count < max_ticks_per_frame_) {
+      tick_accumulator_ -= tick_length_;
+      tick_count++;
     }
 
-    auto node_combiner = igasync::PromiseCombiner::Create();
+    // Falling further behind than max_ticks_per_frame - drop the time instead
+    //  of trying to catch up (which would only make the next frame longer)
+    if (tick_accumulator_ >= tick_length_) {
+      tick_accumulator_ %= tick_length_;
+    }
 
-    for (int j = 0; j < nodes_[i].dependency_ids_.size(); j++) {
-#ifdef IG_ENABLE_ECS_VALIDATION
-      bool found_dep = false;
-#endif
-      for (int nid = 0; nid < schedule.size(); nid++) {
-        const auto& sn = schedule[nid];
-        if (sn.id == nodes_[i].dependency_ids_[j]) {
-          node_combiner->add(sn.rslPromise, any_thread_task_list);
-#ifdef IG_ENABLE_ECS_VALIDATION
-          found_dep = true;
-#endif
-          break;
-        }
-      }
-#ifdef IG_ENABLE_ECS_VALIDATION
-      assert(found_dep &&
-             "[IgECS::Scheduler] Node dependency listed but not found");
-#endif
+    interpolation_alpha =
+        FpSeconds(tick_accumulator_).count() / FpSeconds(tick_length_).count();
+  }
+
+  // Per-frame nodes that do not wait for the ticks start right away, and
+  //  overlap with them
+  reset_subgraph(false);
+  start_nodes(root_nodes_);
+
+  for (std::uint32_t i = 0; i < tick_count; i++) {
+    if (on_tick_) {
+      TickInfo tick{};
+      tick.is_fixed_tick = true;
+      tick.tick_index = next_tick_index_;
+      tick.dt_seconds = FpSeconds(tick_length_).count();
+      tick.interpolation_alpha = 0.f;
+      on_tick_(world, tick);
     }
+    reset_subgraph(true);
+    start_nodes(tick_root_nodes_);
+    wait_until(fs.is_tick_done);
+    report_node_runs(true);
+    next_tick_index_++;
+  }
 
-    schedule.push_back(SNode{
-        nodes_[i].id_,
-        node_combiner->combine([](auto) {}, any_thread_task_list)
-            ->then_chain(
-                [this, i, world, main_thread_task_list, any_thread_task_list] {
-                  return this->nodes_[i].schedule(world, main_thread_task_list,
-                                                  any_thread_task_list,
-                                                  &frame_profiler_);
-                },
-                main_thread_task_list),
-    });
-    all_nodes_combiner->add(::last(schedule).rslPromise, any_thread_task_list);
+  if (on_tick_) {
+    TickInfo tick{};
+    tick.is_fixed_tick = false;
+    tick.tick_index = next_tick_index_;
+    tick.dt_seconds = FpSeconds(frame_time_).count();
+    tick.interpolation_alpha = interpolation_alpha;
+    on_tick_(world, tick);
   }
 
-  // Schedule is built! Proceed to execute everything...
-  bool is_done = false;
-  all_nodes_combiner->combine([&is_done](auto) { is_done = true; },
-                              main_thread_task_list);
+  // The ticks are the last dependency of these nodes that is not a per-frame
+  //  node - some of them may still wait for nodes that started with the ticks
+  fs.released_nodes.clear();
+  for (std::uint32_t node_idx : after_tick_nodes_) {
+    if (fs.pending_deps[node_idx].fetch_sub(1u, std::memory_order_acq_rel) ==
+        1u) {
+      fs.released_nodes.push_back(node_idx);
+    }
+  }
+  start_nodes(fs.released_nodes);
+  wait_until(fs.is_frame_done);
+  report_node_runs(false);
+
+  // Flush main thread task list to capture any lingering tasks (profiles etc)
+  while (fs.main_thread->execute_next()) {
+  }
+
+  fs.world = nullptr;
+
+  frame_profiler_.EndFrame();
+}
+
+void Scheduler::update_priorities() {
+  // Nodes that have not run yet are assumed to take this long - before any
+  //  history exists, priority follows the number of nodes left on the path
+  const double kDefaultNodeNs = 1000.;
+
+  // Successors always come later in topological order
+  for (std::uint32_t i = static_cast<std::uint32_t>(nodes_.size()); i-- > 0;) {
+    double longest_successor_path = 0.;
+    for (std::uint32_t s = successor_offsets_[i]; s < successor_offsets_[i + 1];
+         s++) {
+      longest_successor_path =
+          std::max(longest_successor_path, priorities_[successors_[s]]);
+    }
+
+    // Partitions share one profiler entry, and split its time between them
+    const double estimate =
+        frame_profiler_.DurationEstimate(nodes_[i].system_id_.id) /
+        nodes_[i].partition_count_;
+    priorities_[i] =
+        (estimate > 0. ? estimate : kDefaultNodeNs) + longest_successor_path;
+  }
+}
+
+void Scheduler::reset_subgraph(bool fixed_tick) {
+  FrameState& fs = *frame_state_;
+
+  std::uint32_t node_count = 0u;
+  for (std::uint32_t i = 0; i < nodes_.size(); i++) {
+    if (is_tick_node_[i] != fixed_tick) continue;
+    fs.pending_deps[i].store(dependency_counts_[i], std::memory_order_relaxed);
+    node_count++;
+  }
+  for (std::uint32_t i = 0; i < partitions_.size(); i++) {
+    if (is_tick_node_[partitions_[i][0]] != fixed_tick) continue;
+    fs.pending_partitions[i].store(
+        static_cast<std::uint32_t>(partitions_[i].size()),
+        std::memory_order_relaxed);
+  }
+
+  auto& remaining =
+      fixed_tick ? fs.remaining_tick_nodes : fs.remaining_frame_nodes;
+  remaining.store(node_count, std::memory_order_relaxed);
+  (fixed_tick ? fs.is_tick_done : fs.is_frame_done)
+      .store(node_count == 0u, std::memory_order_release);
+}
+
+void Scheduler::start_nodes(const std::vector<std::uint32_t>& ready_nodes) {
+  // Every node is in the ready heap before any of them can start, so that the
+  //  first nodes to run are the roots of the longest paths
+  for (std::uint32_t node_idx : ready_nodes) {
+    if (runs_on_main_thread(node_idx)) {
+      dispatch_node(node_idx);
+    } else {
+      push_ready(node_idx);
+    }
+  }
+  for (std::uint32_t node_idx : ready_nodes) {
+    if (!runs_on_main_thread(node_idx)) {
+      schedule_ready_job(node_idx);
+    }
+  }
+}
+
+void Scheduler::wait_until(const std::atomic_bool& is_done) {
+  FrameState& fs = *frame_state_;
+  auto main_thread_task_list = fs.main_thread_task_list;
 
   //
   // Okay this is a tricky section full of weird shit.
@@ -416,54 +1068,93 @@ void Scheduler::execute(std::shared_ptr<igasync::TaskList> any_thread_task_list,
   // (1) Spin, doing everything that can be done against main_thread list
   // (2) Once the main thread is waiting, pull something from any_thread list
   // (3) Repeat so long as either main or any has any work to do
-  // (4) If any work was done, clear any existing hanging state.
-  // (5) If no work was done, set a hanging state if one is not found.
-  // (6) If a hanging state is present and stale for longer than max_spin_time_,
-  //     trigger an assertion failure that crashes the application (this helps
-  //     guard against infinite spinloops in scheduling in case of bugs)
-  std::optional<std::chrono::high_resolution_clock::time_point> hang_start = {};
-  while (!is_done) {
+  // (4) If no work was found, keep spinning for up to idle_spin_time_ - work
+  //     tends to show up quickly when workers are about to finish something
+  // (5) Past that, park until woken up. Workers wake the main thread when they
+  //     schedule main thread work, and when the last node finishes. Nothing
+  //     can wake the main thread if there are no workers, so in that case it
+  //     keeps spinning.
+  // (6) If no work was done for longer than max_spin_time_, trigger an
+  //     assertion failure that crashes the application (this helps guard
+  //     against infinite spinloops in scheduling in case of bugs)
+  //
+  // Time spent spinning or parked is reported to the profiler as idle time.
+  using Clock = std::chrono::high_resolution_clock;
+  const bool can_park =
+      fs.any_thread_pool ? fs.any_thread_pool->worker_count() > 0
+                         : (fs.any_thread_task_list != main_thread_task_list &&
+                            frame_profiler_.ThreadCount() > 1u);
+  const auto main_thread_id = std::this_thread::get_id();
+
+  std::optional<Clock::time_point> hang_start = {};
+  std::optional<Clock::time_point> idle_start = {};
+  while (!is_done.load(std::memory_order_acquire)) {
+    std::uint32_t wake_seq = fs.main_thread->wake_seq();
+
     bool did_a_thing = false;
-    bool is_spinning = true;
-    do {
-      did_a_thing = false;
-      while (main_thread_task_list->execute_next()) {
-        did_a_thing = true;
-      }
-      if (!did_a_thing) {
-        did_a_thing = did_a_thing || any_thread_task_list->execute_next();
-      }
-      if (did_a_thing) {
-        is_spinning = false;
-      }
-    } while (did_a_thing);
+    while (fs.main_thread->execute_next()) {
+      did_a_thing = true;
+    }
+    if (!did_a_thing) {
+      did_a_thing = fs.any_thread_pool
+                        ? fs.any_thread_pool->execute_next()
+                        : fs.any_thread_task_list->execute_next();
+    }
 
-    if (!is_spinning) {
-      if (hang_start.has_value()) {
-        // TODO (sessamekesh): telemetry around unnecessary hang time (if any)
-        hang_start = {};
-      }
-    } else {
-      // Hanging!
-      if (!hang_start.has_value()) {
-        hang_start = std::chrono::high_resolution_clock::now();
-      } else {
-        if ((*hang_start + max_spin_time_) <
-            std::chrono::high_resolution_clock::now()) {
-          // Max spin elapsed - fail spectacularly
-          assert(false &&
-                 "[IgECS::Scheduler] Maximum spin time elapsed - game must now "
-                 "crash");
-        }
+    if (did_a_thing) {
+      if (idle_start.has_value()) {
+        frame_profiler_.AddIdle(main_thread_id, *idle_start, Clock::now(),
+                                false);
+        idle_start = {};
       }
+      hang_start = {};
+      continue;
+    }
+
+    // Hanging!
+    auto now = Clock::now();
+    if (!hang_start.has_value()) {
+      hang_start = now;
+      idle_start = now;
+      continue;
+    }
+
+    if ((*hang_start + max_spin_time_) < now) {
+      // Max spin elapsed - fail spectacularly
+      assert(false &&
+             "[IgECS::Scheduler] Maximum spin time elapsed - game must now "
+             "crash");
     }
+
+    if (!can_park || (now - *hang_start) < idle_spin_time_) {
+      continue;
+    }
+
+    frame_profiler_.AddIdle(main_thread_id, *idle_start, now, false);
+    fs.main_thread->park(wake_seq, *hang_start + max_spin_time_);
+    idle_start = Clock::now();
+    frame_profiler_.AddIdle(main_thread_id, now, *idle_start, true);
   }
 
-  // Flush main thread task list to capture any lingering tasks (profiles etc)
-  while (main_thread_task_list->execute_next()) {
+  if (idle_start.has_value()) {
+    frame_profiler_.AddIdle(main_thread_id, *idle_start, Clock::now(), false);
   }
+}
 
-  frame_profiler_.EndFrame();
+void Scheduler::report_node_runs(bool fixed_tick) {
+  FrameState& fs = *frame_state_;
+  for (std::uint32_t i = 0; i < nodes_.size(); i++) {
+    // Nodes of the other subgraph may still be running
+    if (is_tick_node_[i] != fixed_tick) continue;
+    NodeRun& run = fs.node_runs[i];
+    if (!run.ran) continue;
+
+    // TODO (sessamekesh): Number of entities accessed here
+    //  (that should be handled in a igecs wv layer)
+    frame_profiler_.AddExecution(nodes_[i].system_id_.id, run.start, run.end,
+                                 0u, run.thread_id);
+    run.ran = false;
+  }
 }
 
 std::string Scheduler::dump_profile(bool pretty) {
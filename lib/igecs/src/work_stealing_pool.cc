@@ -0,0 +1,228 @@
+#include <igecs/work_stealing_pool.h>
+
+#include <functional>
+
+namespace {
+
+// How many rounds of failed searches a worker makes before going to sleep
+const std::uint32_t kIdleSpinRounds = 64;
+
+// Identifies the pool (and the worker within that pool) that owns the calling
+//  thread, so that schedule() can push onto the local deque
+thread_local const igecs::WorkStealingPool* tl_pool = nullptr;
+thread_local std::int32_t tl_worker_idx = -1;
+
+const std::uintptr_t kJobTag = 1u;
+
+// Victim selection for steals (xorshift32) - per thread, so that thieves do
+//  not share a counter
+thread_local std::uint32_t tl_steal_state = 0u;
+
+std::uint32_t next_steal_start() {
+  std::uint32_t x = tl_steal_state;
+  if (x == 0u) {
+    x = static_cast<std::uint32_t>(
+            std::hash<std::thread::id>{}(std::this_thread::get_id())) |
+        1u;
+  }
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  tl_steal_state = x;
+  return x;
+}
+
+}  // namespace
+
+namespace igecs {
+
+std::shared_ptr<WorkStealingPool> WorkStealingPool::Create(
+    std::uint32_t worker_count) {
+  auto pool =
+      std::shared_ptr<WorkStealingPool>(new WorkStealingPool(worker_count));
+
+  // Threads are only started once every worker (and its deque) exists, since
+  //  any worker may try to steal from any other as soon as it starts
+  for (std::uint32_t i = 0; i < pool->workers_.size(); i++) {
+    pool->workers_[i]->thread =
+        std::thread(&WorkStealingPool::worker_loop, pool.get(), i);
+  }
+
+  return pool;
+}
+
+WorkStealingPool::WorkStealingPool(std::uint32_t worker_count)
+    : sleeping_workers_(0u), is_stopping_(false) {
+  workers_.reserve(worker_count);
+  for (std::uint32_t i = 0; i < worker_count; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard l(sleep_lock_);
+    is_stopping_.store(true, std::memory_order_seq_cst);
+  }
+  sleep_cv_.notify_all();
+
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+
+  // Drop anything that never got a chance to run (jobs are not owned)
+  WorkItem item = 0u;
+  auto drop = [](WorkItem item) {
+    if ((item & kJobTag) == 0u) {
+      delete reinterpret_cast<igasync::Task*>(item);
+    }
+  };
+  for (auto& worker : workers_) {
+    while (worker->deque.pop(item)) {
+      drop(item);
+    }
+  }
+  while (injection_queue_.try_dequeue(item)) {
+    drop(item);
+  }
+}
+
+void WorkStealingPool::schedule(std::unique_ptr<igasync::Task> task) {
+  schedule_item(reinterpret_cast<WorkItem>(task.release()));
+}
+
+void WorkStealingPool::schedule(Job* job) {
+  schedule_item(reinterpret_cast<WorkItem>(job) | kJobTag);
+}
+
+void WorkStealingPool::schedule_item(WorkItem item) {
+  if (tl_pool == this) {
+    workers_[tl_worker_idx]->deque.push(item);
+  } else {
+    injection_queue_.enqueue(item);
+  }
+
+  // Sleeping workers register themselves before re-checking the queues, so
+  //  (with a full fence on both sides) either the worker sees this task, or
+  //  this thread sees the sleeping worker and wakes it up. No shared counter
+  //  is written while nobody sleeps.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_workers_.load(std::memory_order_relaxed) > 0u) {
+    std::lock_guard l(sleep_lock_);
+    sleep_cv_.notify_one();
+  }
+}
+
+bool WorkStealingPool::execute_next() {
+  WorkItem item = 0u;
+  if (!find_task(tl_pool == this ? tl_worker_idx : std::int32_t{-1}, item)) {
+    return false;
+  }
+
+  run_task(item);
+  return true;
+}
+
+std::vector<std::thread::id> WorkStealingPool::thread_ids() const {
+  std::vector<std::thread::id> ids;
+  ids.reserve(workers_.size());
+  for (const auto& worker : workers_) {
+    ids.push_back(worker->thread.get_id());
+  }
+  return ids;
+}
+
+std::uint32_t WorkStealingPool::worker_count() const {
+  return static_cast<std::uint32_t>(workers_.size());
+}
+
+void WorkStealingPool::worker_loop(std::uint32_t worker_idx) {
+  tl_pool = this;
+  tl_worker_idx = static_cast<std::int32_t>(worker_idx);
+
+  std::uint32_t idle_rounds = 0u;
+  while (!is_stopping_.load(std::memory_order_relaxed)) {
+    WorkItem item = 0u;
+    if (find_task(tl_worker_idx, item)) {
+      idle_rounds = 0u;
+      run_task(item);
+      continue;
+    }
+
+    if (++idle_rounds < kIdleSpinRounds) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    idle_rounds = 0u;
+    std::unique_lock l(sleep_lock_);
+    sleeping_workers_.fetch_add(1u, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    sleep_cv_.wait(l, [this] {
+      return is_stopping_.load(std::memory_order_seq_cst) ||
+             has_visible_work();
+    });
+    sleeping_workers_.fetch_sub(1u, std::memory_order_seq_cst);
+  }
+
+  tl_pool = nullptr;
+  tl_worker_idx = -1;
+}
+
+bool WorkStealingPool::find_task(std::int32_t worker_idx, WorkItem& out) {
+  // (1) Own deque, newest first
+  if (worker_idx >= 0 && workers_[worker_idx]->deque.pop(out)) {
+    return true;
+  }
+
+  // (2) Work scheduled from outside of the pool
+  if (injection_queue_.try_dequeue(out)) {
+    return true;
+  }
+
+  // (3) Steal the oldest work from another worker, starting at a random
+  //  victim to avoid every thief hammering the same deque
+  const std::uint32_t worker_count =
+      static_cast<std::uint32_t>(workers_.size());
+  if (worker_count == 0u) {
+    return false;
+  }
+  std::uint32_t start = next_steal_start() % worker_count;
+  for (std::uint32_t i = 0; i < worker_count; i++) {
+    std::uint32_t victim = (start + i) % worker_count;
+    if (static_cast<std::int32_t>(victim) == worker_idx) continue;
+    if (workers_[victim]->deque.steal(out)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool WorkStealingPool::has_visible_work() const {
+  if (injection_queue_.size_approx() > 0u) {
+    return true;
+  }
+  for (const auto& worker : workers_) {
+    if (worker->deque.size_approx() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::run_task(WorkItem item) {
+  if ((item & kJobTag) != 0u) {
+    Job* job = reinterpret_cast<Job*>(item & ~kJobTag);
+    job->run(job);
+    return;
+  }
+
+  std::unique_ptr<igasync::Task> owned_task(
+      reinterpret_cast<igasync::Task*>(item));
+  owned_task->run();
+}
+
+}  // namespace igecs
@@ -1,64 +1,204 @@
 #include <igecs/ctti_type_id.h>
+#include <igecs/profile/frame_profiler.h>
 #include <igecs/world_view.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace igecs {
 
 WorldView::Decl WorldView::Decl::Thin() { return Decl(true); }
 
-WorldView::Decl::Decl() : allow_all_(false) {}
+WorldView::Decl::Decl()
+    : allow_all_(false), creates_entities_(false), destroys_entities_(false) {}
 
-WorldView::Decl::Decl(bool allow_all) : allow_all_(allow_all) {}
+WorldView::Decl::Decl(bool allow_all)
+    : allow_all_(allow_all),
+      creates_entities_(false),
+      destroys_entities_(false) {}
 
-WorldView WorldView::Decl::create(entt::registry* registry) const {
-  return WorldView(registry, *this);
+WorldView::Decl& WorldView::Decl::creates_entities() {
+  creates_entities_ = true;
+  return *this;
 }
 
-WorldView::WorldView(entt::registry* registry, Decl decl)
-    : registry_(registry), decl_(std::move(decl)) {
-  assert(registry != nullptr);
+WorldView::Decl& WorldView::Decl::destroys_entities() {
+  destroys_entities_ = true;
+  return *this;
 }
 
-WorldView::Decl& WorldView::Decl::merge_in_decl(const WorldView::Decl& o) {
-  for (int i = 0; i < o.reads_.size(); i++) {
-    if (!::vec_contains(reads_, o.reads_[i])) {
-      reads_.push_back(o.reads_[i]);
-    }
+bool WorldView::Decl::conflicts_with(const WorldView::Decl& o) const {
+  // Thin decls may touch anything
+  if (allow_all_ || o.allow_all_) {
+    return true;
   }
 
-  for (int i = 0; i < o.writes_.size(); i++) {
-    if (!::vec_contains(writes_, o.writes_[i])) {
-      writes_.push_back(o.writes_[i]);
-    }
+  // Writes are always also listed as reads, so this covers write/write too
+  if (write_set_.intersects(o.read_set_) ||
+      o.write_set_.intersects(read_set_)) {
+    return true;
   }
 
-  for (int i = 0; i < o.ctx_reads_.size(); i++) {
-    if (!::vec_contains(ctx_reads_, o.ctx_reads_[i])) {
-      ctx_reads_.push_back(o.ctx_reads_[i]);
-    }
+  if (ctx_write_set_.intersects(o.ctx_read_set_) ||
+      o.ctx_write_set_.intersects(ctx_read_set_)) {
+    return true;
   }
 
-  for (int i = 0; i < o.ctx_writes_.size(); i++) {
-    if (!::vec_contains(ctx_writes_, o.ctx_writes_[i])) {
-      ctx_writes_.push_back(o.ctx_writes_[i]);
-    }
+  // Enqueueing events is thread safe, but consumers must see every event that
+  //  is enqueued before them, and only one consumer may drain a queue at once
+  if (evt_consume_set_.intersects(o.evt_write_set_) ||
+      o.evt_consume_set_.intersects(evt_write_set_) ||
+      evt_consume_set_.intersects(o.evt_consume_set_)) {
+    return true;
   }
 
-  for (int i = 0; i < o.evt_writes_.size(); i++) {
-    if (!::vec_contains(evt_writes_, o.evt_writes_[i])) {
-      evt_writes_.push_back(o.evt_writes_[i]);
-    }
+  auto touches_entities = [](const Decl& d) {
+    return !d.read_set_.empty() || d.creates_entities_ || d.destroys_entities_;
+  };
+  if ((destroys_entities_ && touches_entities(o)) ||
+      (o.destroys_entities_ && touches_entities(*this))) {
+    return true;
   }
 
-  for (int i = 0; i < o.evt_consumes_.size(); i++) {
-    if (!::vec_contains(evt_consumes_, o.evt_consumes_[i])) {
-      evt_consumes_.push_back(o.evt_consumes_[i]);
-    }
+  return creates_entities_ && o.creates_entities_;
+}
+
+WorldView WorldView::Decl::create(entt::registry* registry,
+                                  profile::FrameProfiler* profiler,
+                                  std::uint32_t system_id) const {
+  return WorldView(registry, *this, profiler, system_id);
+}
+
+WorldView::WorldView(entt::registry* registry, Decl decl,
+                     profile::FrameProfiler* profiler, std::uint32_t system_id)
+    : registry_(registry),
+      change_tracking_(nullptr),
+      decl_(std::move(decl)),
+      profiler_(profiler),
+      system_id_(system_id),
+      partition_index_(0u),
+      partition_count_(1u),
+      version_(ChangeClock::tick()) {
+  assert(registry != nullptr);
+  change_tracking_ = registry->ctx().find<CtxChangeTracking>();
+#ifdef IG_ENABLE_ECS_VALIDATION
+  partition_set_ = nullptr;
+  partition_range_ = PartitionRange{0u, 0u};
+#endif
+}
+
+void WorldView::Decl::add_type(std::vector<CttiTypeId>& list,
+                               CttiTypeSet& set, const CttiTypeId& id) {
+  if (!set.contains(id)) {
+    set.insert(id);
+    list.push_back(id);
+  }
+}
+
+WorldView::Decl& WorldView::Decl::merge_in_decl(const WorldView::Decl& o) {
+  for (const auto& id : o.reads_) add_type(reads_, read_set_, id);
+  for (const auto& id : o.writes_) add_type(writes_, write_set_, id);
+  for (const auto& id : o.ctx_reads_) add_type(ctx_reads_, ctx_read_set_, id);
+  for (const auto& id : o.ctx_writes_) {
+    add_type(ctx_writes_, ctx_write_set_, id);
   }
+  for (const auto& id : o.evt_writes_) {
+    add_type(evt_writes_, evt_write_set_, id);
+  }
+  for (const auto& id : o.evt_consumes_) {
+    add_type(evt_consumes_, evt_consume_set_, id);
+  }
+  for (const auto& id : o.owns_) add_type(owns_, own_set_, id);
+  for (const auto& group : o.groups_) add_group(group);
+
+  creates_entities_ = creates_entities_ || o.creates_entities_;
+  destroys_entities_ = destroys_entities_ || o.destroys_entities_;
   return *this;
 }
 
+void WorldView::Decl::add_group(const Group& group) {
+  if (std::find(groups_.begin(), groups_.end(), group) == groups_.end()) {
+    groups_.push_back(group);
+  }
+}
+
+WorldView::Decl WorldView::Decl::with_group_writes(
+    const std::vector<Group>& groups) const {
+  Decl rsl = *this;
+  for (const auto& group : groups) {
+    if (write_set_.intersects(group.members)) {
+      rsl.write_set_ |= group.owned;
+      rsl.read_set_ |= group.owned;
+    }
+  }
+  return rsl;
+}
+
 WorldView WorldView::Thin(entt::registry* world) {
   return WorldView(world, WorldView::Decl::Thin());
 }
 
+void WorldView::reset(entt::registry* registry) {
+  assert(registry != nullptr);
+  registry_ = registry;
+  change_tracking_ = registry->ctx().find<CtxChangeTracking>();
+  version_ = ChangeClock::tick();
+
+#ifdef IG_ENABLE_ECS_VALIDATION
+  read_types_.clear();
+  write_types_.clear();
+  ctx_read_types_.clear();
+  ctx_write_types_.clear();
+  evt_queue_types_.clear();
+  evt_consume_types_.clear();
+  partition_set_ = nullptr;
+#endif
+  commands_.clear();
+}
+
+void WorldView::play_back_commands() { commands_.play_back(*registry_); }
+
+void WorldView::set_partition(std::uint32_t index, std::uint32_t count) {
+  assert(count > 0u && index < count);
+  partition_index_ = index;
+  partition_count_ = count;
+}
+
+std::uint32_t WorldView::parallel_grain_size(std::uint32_t entity_count) const {
+  // Chunks should take at least this long, so that the cost of scheduling and
+  //  running a task is small next to the work in it...
+  const double kMinChunkNs = 50000.;
+  // ...but there should be at least this many chunks per thread, so that a
+  //  thread that finishes early has something left to pick up.
+  const std::uint32_t kChunksPerThread = 4u;
+
+  const std::uint32_t thread_count =
+      profiler_ ? profiler_->ThreadCount()
+                : std::max(std::thread::hardware_concurrency(), 1u);
+  if (thread_count <= 1u || entity_count == 0u) {
+    return std::max(entity_count, 1u);
+  }
+
+  const std::uint32_t chunk_target = thread_count * kChunksPerThread;
+  std::uint32_t grain = (entity_count + chunk_target - 1u) / chunk_target;
+
+  // Without history, start from the most even split and measure
+  const double ns_per_entity =
+      profiler_ ? profiler_->EntityCostEstimate(system_id_) : 0.;
+  if (ns_per_entity > 0.) {
+    grain = std::max(grain, static_cast<std::uint32_t>(
+                                std::ceil(kMinChunkNs / ns_per_entity)));
+  }
+
+  return std::min(grain, entity_count);
+}
+
+void WorldView::record_parallel_chunk(
+    std::uint32_t entity_count,
+    std::chrono::high_resolution_clock::duration duration) const {
+  if (profiler_) {
+    profiler_->AddEntityCostSample(system_id_, entity_count, duration);
+  }
+}
+
 }  // namespace igecs
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <igecs/world_view.h>
+
+#include <vector>
+
+using namespace igecs;
+
+namespace {
+struct TrackedT {
+  static constexpr bool kTrackChanges = true;
+  int a;
+};
+
+struct UntrackedT {
+  int b;
+};
+
+std::vector<entt::entity> changed_entities(WorldView& wv,
+                                           std::uint64_t since) {
+  std::vector<entt::entity> rsl;
+  for (auto [e, t, u] :
+       wv.changed_view<const TrackedT, const UntrackedT>(since).each()) {
+    rsl.push_back(e);
+  }
+  return rsl;
+}
+}  // namespace
+
+TEST(IgECS_ChangeTracker, VisitsOnlyEntitiesWrittenSinceVersion) {
+  entt::registry registry;
+  track_changes<TrackedT>(registry);
+
+  auto setup = WorldView::Thin(&registry);
+  std::vector<entt::entity> entities;
+  for (int i = 0; i < 3; i++) {
+    auto e = setup.create();
+    setup.attach<TrackedT>(e, i);
+    setup.attach<UntrackedT>(e, i);
+    entities.push_back(e);
+  }
+
+  WorldView reader(&registry,
+                   WorldView::Decl().reads<TrackedT>().reads<UntrackedT>());
+
+  // Everything is new to a system that has not run before
+  EXPECT_EQ(changed_entities(reader, 0u).size(), 3u);
+
+  // Writes to untracked components do not count
+  const std::uint64_t since = reader.version();
+  auto writer = WorldView::Thin(&registry);
+  writer.write<TrackedT>(entities[1]).a = 10;
+  writer.write<UntrackedT>(entities[2]).b = 20;
+
+  reader.reset(&registry);
+  EXPECT_EQ(changed_entities(reader, since),
+            std::vector<entt::entity>{entities[1]});
+
+  // ...and nothing was written since the last run
+  EXPECT_TRUE(changed_entities(reader, reader.version()).empty());
+}
+
+TEST(IgECS_ChangeTracker, MutableViewMarksEveryEntity) {
+  entt::registry registry;
+  track_changes<TrackedT>(registry);
+
+  auto setup = WorldView::Thin(&registry);
+  for (int i = 0; i < 3; i++) {
+    auto e = setup.create();
+    setup.attach<TrackedT>(e, i);
+    setup.attach<UntrackedT>(e, i);
+  }
+
+  WorldView reader(&registry,
+                   WorldView::Decl().reads<TrackedT>().reads<UntrackedT>());
+  const std::uint64_t since = reader.version();
+
+  auto writer = WorldView::Thin(&registry);
+  writer.view<TrackedT>();
+
+  reader.reset(&registry);
+  EXPECT_EQ(changed_entities(reader, since).size(), 3u);
+}
+
+TEST(IgECS_ChangeTracker, DeferredAttachMarksEntity) {
+  entt::registry registry;
+  track_changes<TrackedT>(registry);
+
+  auto setup = WorldView::Thin(&registry);
+  auto e = setup.create();
+  setup.attach<UntrackedT>(e, 1);
+
+  WorldView reader(&registry,
+                   WorldView::Decl().reads<TrackedT>().reads<UntrackedT>());
+  const std::uint64_t since = reader.version();
+
+  auto writer = WorldView::Thin(&registry);
+  writer.defer_attach<TrackedT>(e, 2);
+  writer.play_back_commands();
+
+  reader.reset(&registry);
+  EXPECT_EQ(changed_entities(reader, since), std::vector<entt::entity>{e});
+}
+
+TEST(IgECS_ChangeTracker, ResetPicksUpTrackingSetUpLater) {
+  entt::registry registry;
+  auto wv = WorldView::Thin(&registry);
+  auto e = wv.create();
+  wv.attach<UntrackedT>(e, 1);
+
+  track_changes<TrackedT>(registry);
+  wv.reset(&registry);
+  const std::uint64_t since = wv.version();
+  wv.attach<TrackedT>(e, 2);
+
+  wv.reset(&registry);
+  EXPECT_EQ(changed_entities(wv, since), std::vector<entt::entity>{e});
+}
+
+TEST(IgECS_ChangeTrackerDeathTest, FailsToWriteUntrackedRegistry) {
+  entt::registry registry;
+  auto wv = WorldView::Thin(&registry);
+  auto e = wv.create();
+
+  EXPECT_DEATH({ wv.attach<TrackedT>(e, 1); },
+               "\\[IgECS::ChangeTracker\\] Component .*TrackedT is tracked");
+}
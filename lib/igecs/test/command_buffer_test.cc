@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <igecs/command_buffer.h>
+
+#include <memory>
+
+using namespace igecs;
+
+namespace {
+struct FooT {
+  int a;
+};
+
+struct BarT {
+  int b;
+};
+
+struct TagT {};
+}  // namespace
+
+TEST(IgECS_CommandBuffer, AppliesCommandsInOrder) {
+  entt::registry registry;
+  entt::entity existing = registry.create();
+  registry.emplace<FooT>(existing, 1);
+
+  CommandBuffer commands;
+  auto created = commands.create();
+  commands.attach<FooT>(created, 2);
+  commands.attach<TagT>(created);
+  commands.attach_or_replace<FooT>(existing, 3);
+  commands.attach<BarT>(existing, 4);
+  commands.remove<BarT>(existing);
+
+  // Nothing happens until play back
+  EXPECT_EQ(commands.size(), 6u);
+  EXPECT_EQ(registry.get<FooT>(existing).a, 1);
+  EXPECT_EQ(registry.view<FooT>().size(), 1u);
+
+  commands.play_back(registry);
+  EXPECT_TRUE(commands.empty());
+
+  EXPECT_EQ(registry.get<FooT>(existing).a, 3);
+  EXPECT_FALSE(registry.all_of<BarT>(existing));
+
+  int created_count = 0;
+  for (auto [e, foo] : registry.view<FooT, TagT>().each()) {
+    EXPECT_NE(e, existing);
+    EXPECT_EQ(foo.a, 2);
+    created_count++;
+  }
+  EXPECT_EQ(created_count, 1);
+}
+
+TEST(IgECS_CommandBuffer, SkipsCommandsOnDestroyedEntities) {
+  entt::registry registry;
+  entt::entity e = registry.create();
+
+  CommandBuffer commands;
+  commands.destroy(e);
+  commands.destroy(e);
+  commands.attach<FooT>(e, 1);
+
+  commands.play_back(registry);
+  EXPECT_FALSE(registry.valid(e));
+  EXPECT_EQ(registry.view<FooT>().size(), 0u);
+}
+
+TEST(IgECS_CommandBuffer, DropsPayloadsThatNeverRun) {
+  auto payload = std::make_shared<int>(5);
+  {
+    CommandBuffer commands;
+    commands.attach<std::shared_ptr<int>>(entt::entity{0}, payload);
+    EXPECT_EQ(payload.use_count(), 2);
+
+    commands.clear();
+    EXPECT_EQ(payload.use_count(), 1);
+
+    commands.attach<std::shared_ptr<int>>(entt::entity{0}, payload);
+    EXPECT_EQ(payload.use_count(), 2);
+  }
+  EXPECT_EQ(payload.use_count(), 1);
+}
+
+TEST(IgECS_CommandBuffer, RecordsManyLargePayloads) {
+  struct BigT {
+    int values[200];
+  };
+
+  entt::registry registry;
+  CommandBuffer commands;
+  for (int frame = 0; frame < 2; frame++) {
+    for (int i = 0; i < 100; i++) {
+      auto e = commands.create();
+      BigT big{};
+      big.values[199] = i;
+      commands.attach<BigT>(e, big);
+    }
+    commands.play_back(registry);
+  }
+
+  int total = 0;
+  for (auto [e, big] : registry.view<BigT>().each()) {
+    total += big.values[199];
+  }
+  EXPECT_EQ(total, 2 * (99 * 100 / 2));
+}
@@ -1,5 +1,7 @@
+#include <gtest/gtest-death-test.h>
 #include <gtest/gtest.h>
 #include <igecs/ctti_type_id.h>
+#include <igecs/ctti_type_set.h>
 
 using namespace igecs;
 
@@ -29,3 +31,37 @@ TEST(IgECS_CttiTypeId, OutputsTypeNames) {
   EXPECT_TRUE(CttiTypeId::name<FooT>().find_last_of("FooT") > 0);
   EXPECT_STREQ(CttiTypeId::name<CttiTypeId>().c_str(), "igecs::CttiTypeId");
 }
+
+TEST(IgECS_CttiTypeId, IndexMatchesId) {
+  EXPECT_EQ(CttiTypeId::index_of<FooT>(), CttiTypeId::of<FooT>().id);
+  EXPECT_EQ(CttiTypeId::index_of<BarT>(), CttiTypeId::of<BarT>().id);
+  EXPECT_LT(CttiTypeId::index_of<BarT>(), CttiTypeSet::kCapacity);
+}
+
+TEST(IgECS_CttiTypeSet, TracksMembershipAndIntersections) {
+  CttiTypeSet foo, bar, both;
+  EXPECT_TRUE(foo.empty());
+
+  foo.insert(CttiTypeId::of<FooT>());
+  bar.insert(CttiTypeId::of<BarT>());
+  both |= foo;
+  both |= bar;
+
+  EXPECT_FALSE(foo.empty());
+  EXPECT_TRUE(foo.contains(CttiTypeId::of<FooT>()));
+  EXPECT_FALSE(foo.contains(CttiTypeId::of<BarT>()));
+  EXPECT_FALSE(foo.intersects(bar));
+  EXPECT_TRUE(both.intersects(foo));
+  EXPECT_TRUE(both.intersects(bar));
+  EXPECT_FALSE(foo.contains(CttiTypeSet::kCapacity + 5u));
+}
+
+TEST(IgECS_CttiTypeSetDeathTest, InsertPastCapacityAborts) {
+  // Not an assert - the check also has to hold in release builds
+  CttiTypeSet set;
+  EXPECT_DEATH(set.insert(CttiTypeSet::kCapacity), "out of range");
+
+  AtomicCttiTypeSet atomic_set;
+  EXPECT_DEATH(atomic_set.insert(CttiTypeSet::kCapacity + 64u),
+               "out of range");
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <igecs/evt_queue.h>
+
+#include <algorithm>
+#include <entt/entt.hpp>
+#include <thread>
+#include <vector>
+
+using namespace igecs;
+
+namespace {
+struct FooEvt {
+  int a;
+};
+
+// Enqueue values [begin, end) from thread_count threads, some one at a time
+//  and some in bulk
+void produce(EventChannel<FooEvt>& channel, int thread_count, int per_thread) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_count; t++) {
+    threads.emplace_back([&channel, t, per_thread]() {
+      const int begin = t * per_thread;
+      const int half = per_thread / 2;
+      for (int i = begin; i < begin + half; i++) {
+        channel.enqueue(FooEvt{i});
+      }
+
+      std::vector<FooEvt> bulk;
+      for (int i = begin + half; i < begin + per_thread; i++) {
+        bulk.push_back(FooEvt{i});
+      }
+      channel.enqueue_bulk(bulk);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void expect_each_once(std::span<FooEvt> evts, int count) {
+  ASSERT_EQ(evts.size(), count);
+  std::vector<int> values;
+  for (const auto& evt : evts) {
+    values.push_back(evt.a);
+  }
+  std::sort(values.begin(), values.end());
+  for (int i = 0; i < count; i++) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+}  // namespace
+
+TEST(IgECS_EventChannel, ConsumesNothingWhenEmpty) {
+  EventChannel<FooEvt> channel;
+  EXPECT_TRUE(channel.consume().empty());
+}
+
+TEST(IgECS_EventChannel, KeepsSingleThreadOrder) {
+  EventChannel<FooEvt> channel;
+
+  // First through the overflow list, then through the arena
+  for (int frame = 0; frame < 2; frame++) {
+    for (int i = 0; i < 100; i++) {
+      channel.enqueue(FooEvt{i});
+    }
+
+    auto evts = channel.consume();
+    ASSERT_EQ(evts.size(), 100);
+    for (int i = 0; i < 100; i++) {
+      EXPECT_EQ(evts[i].a, i);
+    }
+  }
+}
+
+TEST(IgECS_EventChannel, ConsumesEveryEventFromManyThreadsOnce) {
+  EventChannel<FooEvt> channel;
+
+  // Odd sizes leave partly filled blocks behind on every thread
+  for (int frame = 0; frame < 4; frame++) {
+    produce(channel, 4, 1001 + frame * 37);
+    expect_each_once(channel.consume(), 4 * (1001 + frame * 37));
+  }
+}
+
+TEST(IgECS_EventChannel, MixesArenaAndOverflowEvents) {
+  EventChannel<FooEvt> channel;
+  produce(channel, 2, 50);
+  expect_each_once(channel.consume(), 100);
+
+  // Arena now fits ~200 events - this frame spills into the overflow list
+  produce(channel, 4, 500);
+  expect_each_once(channel.consume(), 2000);
+}
+
+namespace {
+struct KeyedEvt {
+  entt::entity e;
+  int source;
+
+  entt::entity key() const { return e; }
+};
+}  // namespace
+
+TEST(IgECS_KeyedEventChannel, CoalescesDuplicateKeys) {
+  KeyedEventChannel<KeyedEvt> channel;
+
+  // First frame goes through the locked key set, the second through the
+  //  bitset - both must coalesce
+  for (int frame = 0; frame < 2; frame++) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&channel, t]() {
+        for (int i = 0; i < 1000; i++) {
+          channel.enqueue(KeyedEvt{static_cast<entt::entity>(i), t});
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    auto evts = channel.consume();
+    ASSERT_EQ(evts.size(), 1000);
+    for (int i = 0; i < 1000; i++) {
+      EXPECT_EQ(evts[i].e, static_cast<entt::entity>(i));
+    }
+  }
+}
+
+TEST(IgECS_KeyedEventChannel, KeepsFirstEventAndAcceptsKeyAfterConsume) {
+  KeyedEventChannel<KeyedEvt> channel;
+  const auto e = static_cast<entt::entity>(3);
+
+  EXPECT_TRUE(channel.enqueue(KeyedEvt{e, 1}));
+  EXPECT_FALSE(channel.enqueue(KeyedEvt{e, 2}));
+  auto evts = channel.consume();
+  ASSERT_EQ(evts.size(), 1);
+  EXPECT_EQ(evts[0].source, 1);
+
+  EXPECT_TRUE(channel.enqueue(KeyedEvt{e, 3}));
+  evts = channel.consume();
+  ASSERT_EQ(evts.size(), 1);
+  EXPECT_EQ(evts[0].source, 3);
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <igecs/prefab.h>
+
+#include <vector>
+
+using namespace igecs;
+
+namespace {
+struct FooT {
+  int a;
+};
+
+struct TrackedT {
+  static constexpr bool kTrackChanges = true;
+  float b;
+};
+
+struct TagT {};
+}  // namespace
+
+TEST(IgECS_Prefab, SpawnsCopiesOfTemplate) {
+  entt::registry registry;
+  track_changes<TrackedT>(registry);
+
+  Prefab<FooT, TrackedT, TagT> prefab(FooT{3}, TrackedT{1.5f}, TagT{});
+  auto wv = prefab.decl().create(&registry);
+
+  std::vector<entt::entity> entities(100u);
+  prefab.spawn(&wv, entities);
+
+  for (auto e : entities) {
+    ASSERT_TRUE(registry.valid(e));
+    EXPECT_EQ(registry.get<FooT>(e).a, 3);
+    EXPECT_EQ(registry.get<TrackedT>(e).b, 1.5f);
+    EXPECT_TRUE(registry.all_of<TagT>(e));
+  }
+  EXPECT_EQ(registry.storage<FooT>().size(), 100u);
+}
+
+TEST(IgECS_Prefab, OverridesEachInstance) {
+  entt::registry registry;
+  track_changes<TrackedT>(registry);
+
+  Prefab<FooT, TrackedT, TagT> prefab(FooT{3}, TrackedT{1.5f}, TagT{});
+  auto wv = prefab.decl().create(&registry);
+
+  std::vector<entt::entity> entities(10u);
+  prefab.spawn(&wv, entities, [](std::size_t i, auto& instance) {
+    std::get<FooT>(instance).a = static_cast<int>(i);
+  });
+
+  for (std::size_t i = 0u; i < entities.size(); i++) {
+    EXPECT_EQ(registry.get<FooT>(entities[i]).a, static_cast<int>(i));
+    EXPECT_EQ(registry.get<TrackedT>(entities[i]).b, 1.5f);
+    EXPECT_TRUE(registry.all_of<TagT>(entities[i]));
+  }
+
+  // The template itself is untouched
+  EXPECT_EQ(std::get<FooT>(prefab.instance()).a, 3);
+}
+
+TEST(IgECS_Prefab, MarksTrackedComponentsChanged) {
+  entt::registry registry;
+  track_changes<TrackedT>(registry);
+
+  WorldView reader(&registry, WorldView::Decl().reads<TrackedT>());
+  const std::uint64_t since = reader.version();
+
+  Prefab<FooT, TrackedT> prefab(FooT{0}, TrackedT{0.f});
+  auto wv = prefab.decl().create(&registry);
+  std::vector<entt::entity> entities(5u);
+  prefab.spawn(&wv, entities);
+
+  reader.reset(&registry);
+  int changed = 0;
+  for (auto e : reader.changed_view<const TrackedT>(since)) {
+    (void)e;
+    changed++;
+  }
+  EXPECT_EQ(changed, 5);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <igecs/scheduler.h>
+#include <igecs/work_stealing_pool.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces global operator new for the whole test binary - allocations are
+//  only counted while g_count_allocations is set
+namespace {
+std::atomic_bool g_count_allocations = false;
+std::atomic_uint64_t g_allocation_count = 0u;
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (g_count_allocations.load(std::memory_order_relaxed)) {
+    g_allocation_count.fetch_add(1u, std::memory_order_relaxed);
+  }
+
+  void* ptr = std::malloc(size == 0u ? 1u : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace igecs;
+
+namespace {
+struct FooT {
+  int a;
+};
+
+struct BarT {
+  int b;
+};
+
+template <int N>
+struct TestSystem {};
+
+// Systems iterate views by entity, which never allocates - anything counted
+//  comes from the scheduler itself
+Scheduler build_diamond_scheduler(
+    const std::vector<std::thread::id>& worker_thread_ids) {
+  Scheduler::Builder sb("SchedulerAllocationTest");
+  sb.main_thread_id(std::this_thread::get_id());
+  for (auto id : worker_thread_ids) {
+    sb.worker_thread_id(id);
+  }
+
+  auto top = sb.add_node()
+                 .with_decl(WorldView::Decl().writes<FooT>())
+                 .build(
+                     [](WorldView* wv) {
+                       auto view = wv->view<FooT>();
+                       for (auto e : view) {
+                         view.get<FooT>(e).a++;
+                       }
+                     },
+                     CttiTypeId::of<TestSystem<1>>(), "top");
+  auto left = sb.add_node()
+                  .with_decl(WorldView::Decl().reads<FooT>().writes<BarT>())
+                  .depends_on(top)
+                  .build(
+                      [](WorldView* wv) {
+                        auto view = wv->view<const FooT, BarT>();
+                        for (auto e : view) {
+                          view.get<BarT>(e).b += view.get<const FooT>(e).a;
+                        }
+                      },
+                      CttiTypeId::of<TestSystem<2>>(), "left");
+  auto right = sb.add_node()
+                   .with_decl(WorldView::Decl().reads<FooT>())
+                   .depends_on(top)
+                   .main_thread_only()
+                   .build([](WorldView*) {}, CttiTypeId::of<TestSystem<3>>(),
+                          "right");
+  auto bottom = sb.add_node()
+                    .with_decl(WorldView::Decl().writes<FooT>())
+                    .depends_on(left)
+                    .depends_on(right)
+                    .build(
+                        [](WorldView* wv) {
+                          auto view = wv->view<FooT>();
+                          for (auto e : view) {
+                            view.get<FooT>(e).a--;
+                          }
+                        },
+                        CttiTypeId::of<TestSystem<4>>(), "bottom");
+
+  return sb.build();
+}
+
+template <typename ExecutorT>
+std::uint64_t count_steady_state_allocations(Scheduler& scheduler,
+                                             ExecutorT executor,
+                                             entt::registry* r) {
+  for (int i = 0; i < 10; i++) {
+    scheduler.execute(executor, r);
+  }
+
+  g_allocation_count = 0u;
+  g_count_allocations = true;
+  for (int i = 0; i < 100; i++) {
+    scheduler.execute(executor, r);
+  }
+  g_count_allocations = false;
+
+  return g_allocation_count.load();
+}
+
+void populate(entt::registry* r) {
+  for (int i = 0; i < 100; i++) {
+    auto e = r->create();
+    r->emplace<FooT>(e, i);
+    r->emplace<BarT>(e, 0);
+  }
+}
+}  // namespace
+
+TEST(IgECS_SchedulerAllocation, SingleThreadedExecuteDoesNotAllocate) {
+  auto scheduler = build_diamond_scheduler({});
+  entt::registry r;
+  populate(&r);
+
+  EXPECT_EQ(count_steady_state_allocations(scheduler, nullptr, &r), 0u);
+}
+
+TEST(IgECS_SchedulerAllocation, WorkStealingPoolExecuteDoesNotAllocate) {
+  auto pool = WorkStealingPool::Create(3);
+  auto scheduler = build_diamond_scheduler(pool->thread_ids());
+  entt::registry r;
+  populate(&r);
+
+  EXPECT_EQ(count_steady_state_allocations(scheduler, pool, &r), 0u);
+}
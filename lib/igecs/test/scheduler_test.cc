@@ -4,6 +4,12 @@
 #include <gtest/gtest.h>
 #include <igecs/scheduler.h>
 
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace igecs {
 
 namespace {
@@ -14,6 +20,14 @@ struct BarT {
   int b;
 };
 
+template <int N>
+struct TestSystem {};
+
+template <int N>
+CttiTypeId sys_id() {
+  return CttiTypeId::of<TestSystem<N>>();
+}
+
 WorldView::Decl read_foo_decl() {
   WorldView::Decl d;
   d.reads<FooT>();
@@ -41,12 +55,12 @@ WorldView::Decl write_bar_decl() {
 }  // namespace
 
 TEST(IgECS_Scheduler, TrivialExecutes) {
-  Scheduler::Builder sb;
+  Scheduler::Builder sb("TrivialExecutes");
 
   bool n1_ran = false;
 
-  Scheduler::Node n =
-      sb.add_node().with_decl(write_foo_decl()).build([&n1_ran](WorldView* wv) {
+  Scheduler::Node n = sb.add_node().with_decl(write_foo_decl()).build(
+      [&n1_ran](WorldView* wv) {
         EXPECT_TRUE(wv->can_write<FooT>());
         EXPECT_TRUE(wv->can_read<FooT>());
         EXPECT_FALSE(wv->can_read<BarT>());
@@ -55,9 +69,8 @@ TEST(IgECS_Scheduler, TrivialExecutes) {
         EXPECT_FALSE(wv->can_ctx_write<FooT>());
 
         n1_ran = true;
-
-        return igasync::Promise<void>::Immediate();
-      });
+      },
+      sys_id<1>(), "n1");
 
   sb.max_spin_time(std::chrono::seconds(2));
   Scheduler scheduler = sb.build();
@@ -70,12 +83,12 @@ TEST(IgECS_Scheduler, TrivialExecutes) {
 }
 
 TEST(IgECS_Scheduler, ExecutesWithDependencies) {
-  Scheduler::Builder sb;
+  Scheduler::Builder sb("ExecutesWithDependencies");
 
   bool n1_ran = false, n2_ran = false;
 
-  Scheduler::Node n1 =
-      sb.add_node().with_decl(write_foo_decl()).build([&n1_ran](WorldView* wv) {
+  Scheduler::Node n1 = sb.add_node().with_decl(write_foo_decl()).build(
+      [&n1_ran](WorldView* wv) {
         EXPECT_TRUE(wv->can_write<FooT>());
         n1_ran = true;
 
@@ -86,29 +99,29 @@ TEST(IgECS_Scheduler, ExecutesWithDependencies) {
           runs++;
         }
         EXPECT_EQ(runs, 2);
-
-        return igasync::Promise<void>::Immediate();
-      });
+      },
+      sys_id<1>(), "n1");
 
   Scheduler::Node n2 = sb.add_node()
                            .with_decl(read_foo_decl())
                            .depends_on(n1)
-                           .build([&n2_ran, &n1_ran](WorldView* wv) {
-                             EXPECT_FALSE(wv->can_write<FooT>());
-                             EXPECT_TRUE(wv->can_read<FooT>());
-                             EXPECT_TRUE(n1_ran);
-
-                             auto view = wv->view<const FooT>();
-                             int runs = 0;
-                             for (auto [e, foo] : view.each()) {
-                               runs++;
-                               EXPECT_EQ(foo.a, 100);
-                             }
-                             EXPECT_EQ(runs, 2);
-
-                             n2_ran = true;
-                             return igasync::Promise<void>::Immediate();
-                           });
+                           .build(
+                               [&n2_ran, &n1_ran](WorldView* wv) {
+                                 EXPECT_FALSE(wv->can_write<FooT>());
+                                 EXPECT_TRUE(wv->can_read<FooT>());
+                                 EXPECT_TRUE(n1_ran);
+
+                                 auto view = wv->view<const FooT>();
+                                 int runs = 0;
+                                 for (auto [e, foo] : view.each()) {
+                                   runs++;
+                                   EXPECT_EQ(foo.a, 100);
+                                 }
+                                 EXPECT_EQ(runs, 2);
+
+                                 n2_ran = true;
+                               },
+                               sys_id<2>(), "n2");
 
   Scheduler scheduler = sb.build();
 
@@ -125,24 +138,63 @@ TEST(IgECS_Scheduler, ExecutesWithDependencies) {
   EXPECT_TRUE(n2_ran);
 }
 
-TEST(IgECS_Scheduler, SuccessfullyBuildsWithCorrectDepChaining) {
-  Scheduler::Builder sb;
-
-  auto write_node = sb.add_node().with_decl(write_foo_decl()).build([](auto*) {
-    return igasync::Promise<void>::Immediate();
-  });
-  auto read_node_1 =
+TEST(IgECS_Scheduler, ExecutesDiamondEveryFrame) {
+  Scheduler::Builder sb("ExecutesDiamondEveryFrame");
+
+  std::vector<int> run_order;
+
+  auto top = sb.add_node().with_decl(write_foo_decl()).build(
+      [&run_order](WorldView*) { run_order.push_back(1); }, sys_id<1>(),
+      "top");
+  auto left = sb.add_node()
+                  .with_decl(read_foo_decl())
+                  .depends_on(top)
+                  .build([&run_order](WorldView*) { run_order.push_back(2); },
+                         sys_id<2>(), "left");
+  auto right = sb.add_node()
+                   .with_decl(read_foo_decl())
+                   .depends_on(top)
+                   .build([&run_order](WorldView*) { run_order.push_back(3); },
+                          sys_id<3>(), "right");
+  auto bottom =
       sb.add_node()
-          .with_decl(read_foo_decl())
-          .with_decl(write_bar_decl())
-          .depends_on(write_node)
-          .build([](auto*) { return igasync::Promise<void>::Immediate(); });
-  auto read_node_2 =
-      sb.add_node()
-          .with_decl(read_foo_decl())
-          .with_decl(read_bar_decl())
-          .depends_on(read_node_1)
-          .build([](auto*) { return igasync::Promise<void>::Immediate(); });
+          .with_decl(write_foo_decl())
+          .depends_on(left)
+          .depends_on(right)
+          .build([&run_order](WorldView*) { run_order.push_back(4); },
+                 sys_id<4>(), "bottom");
+
+  auto scheduler = sb.build();
+  entt::registry r;
+
+  // Dependency counters are reset on each execution - every frame must run
+  //  every node exactly once, in a valid order
+  for (int frame = 0; frame < 3; frame++) {
+    run_order.clear();
+    scheduler.execute(nullptr, &r);
+
+    ASSERT_EQ(run_order.size(), 4);
+    EXPECT_EQ(run_order[0], 1);
+    EXPECT_EQ(run_order[3], 4);
+    EXPECT_NE(run_order[1], run_order[2]);
+  }
+}
+
+TEST(IgECS_Scheduler, SuccessfullyBuildsWithCorrectDepChaining) {
+  Scheduler::Builder sb("SuccessfullyBuildsWithCorrectDepChaining");
+
+  auto write_node = sb.add_node().with_decl(write_foo_decl()).build(
+      [](auto*) {}, sys_id<1>(), "write_node");
+  auto read_node_1 = sb.add_node()
+                         .with_decl(read_foo_decl())
+                         .with_decl(write_bar_decl())
+                         .depends_on(write_node)
+                         .build([](auto*) {}, sys_id<2>(), "read_node_1");
+  auto read_node_2 = sb.add_node()
+                         .with_decl(read_foo_decl())
+                         .with_decl(read_bar_decl())
+                         .depends_on(read_node_1)
+                         .build([](auto*) {}, sys_id<3>(), "read_node_2");
 
   auto scheduler = sb.build();
   entt::registry r;
@@ -150,7 +202,7 @@ TEST(IgECS_Scheduler, SuccessfullyBuildsWithCorrectDepChaining) {
 }
 
 TEST(IgECS_Scheduler, SuccessfullyBuildsWithGoodEventOrdering) {
-  Scheduler::Builder sb;
+  Scheduler::Builder sb("SuccessfullyBuildsWithGoodEventOrdering");
 
   struct EvtType {
     int payload;
@@ -158,60 +210,563 @@ TEST(IgECS_Scheduler, SuccessfullyBuildsWithGoodEventOrdering) {
   WorldView::Decl write_decl = WorldView::Decl().evt_writes<EvtType>();
   WorldView::Decl consume_decl = WorldView::Decl().evt_consumes<EvtType>();
 
-  auto producer_node_a = sb.add_node().with_decl(write_decl).build([](auto*) {
-    return igasync::Promise<void>::Immediate();
-  });
-  auto producer_node_b = sb.add_node().with_decl(write_decl).build([](auto*) {
-    return igasync::Promise<void>::Immediate();
+  auto producer_node_a = sb.add_node().with_decl(write_decl).build(
+      [](auto*) {}, sys_id<1>(), "producer_a");
+  auto producer_node_b = sb.add_node().with_decl(write_decl).build(
+      [](auto*) {}, sys_id<2>(), "producer_b");
+
+  auto consumer_node = sb.add_node()
+                           .with_decl(consume_decl)
+                           .depends_on(producer_node_a)
+                           .depends_on(producer_node_b)
+                           .build([](auto*) {}, sys_id<3>(), "consumer");
+
+  auto scheduler = sb.build();
+  entt::registry r;
+  scheduler.execute(nullptr, &r);
+}
+
+TEST(IgECS_Scheduler, InfersMinimalDependenciesFromDecls) {
+  Scheduler::Builder sb("InfersMinimalDependenciesFromDecls");
+  sb.infer_dependencies();
+
+  struct EvtType {
+    int payload;
+  };
+
+  std::vector<int> run_order;
+
+  // (write_foo -> (read_foo_a, read_foo_b), write_bar) -> consume
+  //  - the hand-written graph below is a straight chain
+  auto write_foo = sb.add_node().with_decl(write_foo_decl()).build(
+      [&run_order](WorldView*) { run_order.push_back(1); }, sys_id<1>(),
+      "write_foo");
+  auto read_foo_a =
+      sb.add_node()
+          .with_decl(read_foo_decl())
+          .with_decl(WorldView::Decl().evt_writes<EvtType>())
+          .depends_on(write_foo)
+          .build([&run_order](WorldView*) { run_order.push_back(2); },
+                 sys_id<2>(), "read_foo_a");
+  auto read_foo_b =
+      sb.add_node()
+          .with_decl(read_foo_decl())
+          .depends_on(read_foo_a)
+          .build([&run_order](WorldView*) { run_order.push_back(3); },
+                 sys_id<3>(), "read_foo_b");
+  auto write_bar =
+      sb.add_node()
+          .with_decl(write_bar_decl())
+          .depends_on(read_foo_b)
+          .build([&run_order](WorldView*) { run_order.push_back(4); },
+                 sys_id<4>(), "write_bar");
+  auto consume =
+      sb.add_node()
+          .with_decl(read_bar_decl())
+          .with_decl(write_foo_decl())
+          .with_decl(WorldView::Decl().evt_consumes<EvtType>())
+          .depends_on(write_bar)
+          .build([&run_order](WorldView*) { run_order.push_back(5); },
+                 sys_id<5>(), "consume");
+
+  auto scheduler = sb.build();
+
+  const auto& hand_written = scheduler.hand_written_graph_stats();
+  EXPECT_EQ(hand_written.node_count, 5);
+  EXPECT_EQ(hand_written.edge_count, 4);
+  EXPECT_EQ(hand_written.critical_path_length, 5);
+  EXPECT_EQ(hand_written.max_width, 1);
+
+  // write_foo -> read_foo_a, write_foo -> read_foo_b, read_foo_a -> consume,
+  //  read_foo_b -> consume, write_bar -> consume. write_foo -> consume is
+  //  implied by the path through either reader, and is left out.
+  const auto& inferred = scheduler.graph_stats();
+  EXPECT_EQ(inferred.node_count, 5);
+  EXPECT_EQ(inferred.edge_count, 5);
+  EXPECT_EQ(inferred.critical_path_length, 3);
+  EXPECT_EQ(inferred.max_width, 2);
+  EXPECT_GT(inferred.average_parallelism(),
+            hand_written.average_parallelism());
+
+  entt::registry r;
+  scheduler.execute(nullptr, &r);
+
+  ASSERT_EQ(run_order.size(), 5);
+  auto pos = [&run_order](int n) {
+    return std::find(run_order.begin(), run_order.end(), n) - run_order.begin();
+  };
+  EXPECT_LT(pos(1), pos(2));
+  EXPECT_LT(pos(1), pos(3));
+  EXPECT_LT(pos(2), pos(5));
+  EXPECT_LT(pos(3), pos(5));
+  EXPECT_LT(pos(4), pos(5));
+}
+
+TEST(IgECS_Scheduler, InfersDependenciesForEntityDestruction) {
+  Scheduler::Builder sb("InfersDependenciesForEntityDestruction");
+  sb.infer_dependencies();
+
+  auto read_foo = sb.add_node().with_decl(read_foo_decl()).build(
+      [](auto*) {}, sys_id<1>(), "read_foo");
+  auto read_bar = sb.add_node().with_decl(read_bar_decl()).build(
+      [](auto*) {}, sys_id<2>(), "read_bar");
+  auto destroy = sb.add_node()
+                     .with_decl(WorldView::Decl().destroys_entities())
+                     .build([](auto*) {}, sys_id<3>(), "destroy");
+  auto read_foo_after = sb.add_node().with_decl(read_foo_decl()).build(
+      [](auto*) {}, sys_id<4>(), "read_foo_after");
+
+  auto scheduler = sb.build();
+
+  EXPECT_EQ(scheduler.graph_stats().edge_count, 3);
+  EXPECT_EQ(scheduler.graph_stats().critical_path_length, 3);
+  EXPECT_EQ(scheduler.hand_written_graph_stats().edge_count, 0);
+}
+
+TEST(IgECS_Scheduler, InfersDependenciesForOwningGroups) {
+  Scheduler::Builder sb("InfersDependenciesForOwningGroups");
+  sb.infer_dependencies();
+
+  // Writing BarT (e.g. attaching it) reorders FooT too, since a group owns
+  //  both - so read_foo has to wait for write_bar
+  auto write_bar = sb.add_node().with_decl(write_bar_decl()).build(
+      [](auto*) {}, sys_id<1>(), "write_bar");
+  auto read_foo = sb.add_node().with_decl(read_foo_decl()).build(
+      [](auto*) {}, sys_id<2>(), "read_foo");
+  auto iterate_group =
+      sb.add_node()
+          .with_decl(WorldView::Decl().owning_group<const FooT, const BarT>())
+          .build([](auto*) {}, sys_id<3>(), "iterate_group");
+
+  auto scheduler = sb.build();
+
+  EXPECT_EQ(scheduler.graph_stats().edge_count, 2);
+  EXPECT_EQ(scheduler.graph_stats().critical_path_length, 2);
+}
+
+TEST(IgECS_Scheduler, RunsFixedTickNodesZeroToNTimesPerFrame) {
+  Scheduler::Builder sb("RunsFixedTickNodesZeroToNTimesPerFrame");
+  sb.fixed_tick(std::chrono::milliseconds(10), 4u);
+
+  std::vector<Scheduler::TickInfo> ticks;
+  sb.on_tick([&ticks](entt::registry*, const Scheduler::TickInfo& tick) {
+    ticks.push_back(tick);
   });
 
-  auto consumer_node =
+  int tick_runs = 0;
+  int frame_runs = 0;
+  auto simulate =
       sb.add_node()
-          .with_decl(consume_decl)
-          .depends_on(producer_node_a)
-          .depends_on(producer_node_b)
-          .build([](auto*) { return igasync::Promise<void>::Immediate(); });
+          .with_decl(write_foo_decl())
+          .fixed_tick()
+          .build([&tick_runs](auto*) { tick_runs++; }, sys_id<1>(), "sim");
+  auto render = sb.add_node()
+                    .with_decl(read_foo_decl())
+                    .depends_on(simulate)
+                    .build([&frame_runs](auto*) { frame_runs++; },
+                           sys_id<2>(), "render");
 
   auto scheduler = sb.build();
   entt::registry r;
+
+  // Half a tick - no simulation, render halfway to the next tick
+  scheduler.advance_time(std::chrono::milliseconds(5));
   scheduler.execute(nullptr, &r);
+  EXPECT_EQ(tick_runs, 0);
+  EXPECT_EQ(frame_runs, 1);
+  ASSERT_EQ(ticks.size(), 1);
+  EXPECT_FALSE(ticks[0].is_fixed_tick);
+  EXPECT_NEAR(ticks[0].interpolation_alpha, 0.5f, 0.001f);
+
+  // Brings the total to 3 ticks
+  ticks.clear();
+  scheduler.advance_time(std::chrono::milliseconds(25));
+  scheduler.execute(nullptr, &r);
+  EXPECT_EQ(tick_runs, 3);
+  EXPECT_EQ(frame_runs, 2);
+  ASSERT_EQ(ticks.size(), 4);
+  for (std::uint64_t i = 0; i < 3; i++) {
+    EXPECT_TRUE(ticks[i].is_fixed_tick);
+    EXPECT_EQ(ticks[i].tick_index, i);
+    EXPECT_NEAR(ticks[i].dt_seconds, 0.01f, 0.0001f);
+  }
+  EXPECT_FALSE(ticks[3].is_fixed_tick);
+  EXPECT_EQ(ticks[3].tick_index, 3);
+  EXPECT_NEAR(ticks[3].dt_seconds, 0.025f, 0.0001f);
+  EXPECT_NEAR(ticks[3].interpolation_alpha, 0.f, 0.001f);
+
+  // A long frame is capped at max_ticks_per_frame, and the rest is dropped
+  ticks.clear();
+  scheduler.advance_time(std::chrono::milliseconds(107));
+  scheduler.execute(nullptr, &r);
+  EXPECT_EQ(tick_runs, 7);
+  EXPECT_EQ(frame_runs, 3);
+  EXPECT_EQ(ticks.size(), 5);
+  EXPECT_NEAR(ticks.back().interpolation_alpha, 0.7f, 0.001f);
+}
+
+TEST(IgECS_Scheduler, FixedTickNodesRunPerFrameWithoutTickRate) {
+  Scheduler::Builder sb("FixedTickNodesRunPerFrameWithoutTickRate");
+
+  int tick_runs = 0;
+  auto simulate =
+      sb.add_node()
+          .with_decl(write_foo_decl())
+          .fixed_tick()
+          .build([&tick_runs](auto*) { tick_runs++; }, sys_id<1>(), "sim");
+
+  auto scheduler = sb.build();
+  entt::registry r;
+  for (int i = 0; i < 3; i++) {
+    scheduler.execute(nullptr, &r);
+  }
+
+  EXPECT_EQ(tick_runs, 3);
+}
+
+TEST(IgECS_Scheduler, StartsIndependentFrameNodesWithTheTicks) {
+  struct CtxTickTime {
+    float dt;
+  };
+
+  Scheduler::Builder sb("StartsIndependentFrameNodesWithTheTicks");
+  sb.fixed_tick(std::chrono::milliseconds(10), 4u);
+
+  std::vector<std::string> run_order;
+  auto record = [&run_order](std::string name) {
+    return [&run_order, name](WorldView*) { run_order.push_back(name); };
+  };
+  sb.on_tick(
+      [&run_order](entt::registry*, const Scheduler::TickInfo& tick) {
+        run_order.push_back(tick.is_fixed_tick ? "on_tick" : "on_frame");
+      },
+      WorldView::Decl().ctx_writes<CtxTickTime>());
+
+  auto sim = sb.add_node()
+                 .with_decl(write_foo_decl())
+                 .fixed_tick()
+                 .build(record("sim"), sys_id<1>(), "sim");
+
+  // Touches nothing the ticks touch - overlaps with them
+  auto present = sb.add_node()
+                     .with_decl(write_bar_decl())
+                     .build(record("present"), sys_id<2>(), "present");
+
+  // Reads what on_tick writes
+  auto camera =
+      sb.add_node()
+          .with_decl(WorldView::Decl().ctx_reads<CtxTickTime>())
+          .build(record("camera"), sys_id<3>(), "camera");
+
+  // Reads what the ticks write
+  auto extract = sb.add_node()
+                     .with_decl(read_foo_decl())
+                     .with_decl(read_bar_decl())
+                     .depends_on(sim)
+                     .depends_on(present)
+                     .build(record("extract"), sys_id<4>(), "extract");
+
+  auto scheduler = sb.build();
+  entt::registry r;
+  scheduler.advance_time(std::chrono::milliseconds(20));
+  scheduler.execute(nullptr, &r);
+
+  EXPECT_EQ(run_order,
+            (std::vector<std::string>{"on_tick", "present", "sim", "on_tick",
+                                      "sim", "on_frame", "camera",
+                                      "extract"}));
+}
+
+TEST(IgECS_Scheduler, ValidatesLargeGraphQuickly) {
+  // 200 layers of one writer followed by 9 readers - every reader depends on
+  //  the writer before it, and every writer on all 9 readers before it. There
+  //  are ~9^200 paths from the last node to the first.
+  const int kLayers = 200;
+  const int kReadersPerLayer = 9;
+
+  // Distinct system ids, well away from the ids of real types
+  static const std::string kSystemName = "LargeGraphSystem";
+  std::uint32_t next_system_id = 10000u;
+
+  Scheduler::Builder sb("ValidatesLargeGraphQuickly");
+  std::vector<Scheduler::Node> readers;
+  int run_count = 0;
+  for (int layer = 0; layer < kLayers; layer++) {
+    auto writer_builder = sb.add_node().with_decl(write_foo_decl());
+    for (const auto& reader : readers) {
+      writer_builder.depends_on(reader);
+    }
+    auto writer = writer_builder.build(
+        [&run_count](auto*) { run_count++; },
+        CttiTypeId(next_system_id++, kSystemName), "writer");
+
+    readers.clear();
+    for (int i = 0; i < kReadersPerLayer; i++) {
+      readers.push_back(sb.add_node()
+                            .with_decl(read_foo_decl())
+                            .depends_on(writer)
+                            .build([&run_count](auto*) { run_count++; },
+                                   CttiTypeId(next_system_id++, kSystemName),
+                                   "reader"));
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto scheduler = sb.build();
+  auto build_time = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(scheduler.graph_stats().node_count,
+            kLayers * (kReadersPerLayer + 1));
+  EXPECT_LT(build_time, std::chrono::milliseconds(500));
+
+  entt::registry r;
+  scheduler.execute(nullptr, &r);
+  EXPECT_EQ(run_count, kLayers * (kReadersPerLayer + 1));
+}
+
+TEST(IgECS_Scheduler, RunsLongestPathFirst) {
+  Scheduler::Builder sb("RunsLongestPathFirst");
+  std::vector<std::string> run_order;
+  auto record = [&run_order](std::string name) {
+    return [&run_order, name](WorldView*) { run_order.push_back(name); };
+  };
+
+  // Cheap independent nodes are added first, but the chain is longer
+  auto i1 = sb.add_node().build(record("i1"), sys_id<1>(), "i1");
+  auto i2 = sb.add_node().build(record("i2"), sys_id<2>(), "i2");
+  auto i3 = sb.add_node().build(record("i3"), sys_id<3>(), "i3");
+  auto c1 = sb.add_node().build(record("c1"), sys_id<4>(), "c1");
+  auto c2 =
+      sb.add_node().depends_on(c1).build(record("c2"), sys_id<5>(), "c2");
+  auto c3 =
+      sb.add_node().depends_on(c2).build(record("c3"), sys_id<6>(), "c3");
+
+  // No workers - the main thread runs every node, one at a time
+  auto pool = WorkStealingPool::Create(0);
+  auto scheduler = sb.build();
+  entt::registry r;
+  scheduler.execute(pool, &r);
+
+  ASSERT_EQ(run_order.size(), 6);
+  EXPECT_EQ(run_order[0], "c1");
+  EXPECT_EQ(run_order[1], "c2");
+  EXPECT_EQ(run_order[2], "c3");
+}
+
+TEST(IgECS_Scheduler, PrioritizesNodesByMeasuredDuration) {
+  Scheduler::Builder sb("PrioritizesNodesByMeasuredDuration");
+  std::vector<std::string> run_order;
+
+  auto slow = sb.add_node().build(
+      [&run_order](WorldView*) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        run_order.push_back("slow");
+      },
+      sys_id<1>(), "slow");
+  auto fast_1 = sb.add_node().build(
+      [&run_order](WorldView*) { run_order.push_back("fast_1"); }, sys_id<2>(),
+      "fast_1");
+  auto fast_2 = sb.add_node().depends_on(fast_1).build(
+      [&run_order](WorldView*) { run_order.push_back("fast_2"); }, sys_id<3>(),
+      "fast_2");
+
+  auto pool = WorkStealingPool::Create(0);
+  auto scheduler = sb.build();
+  entt::registry r;
+
+  // Without history, the two node chain goes first...
+  scheduler.execute(pool, &r);
+  ASSERT_EQ(run_order.size(), 3);
+  EXPECT_EQ(run_order[0], "fast_1");
+
+  // ... but once durations are known, the single slow node does
+  run_order.clear();
+  scheduler.execute(pool, &r);
+  ASSERT_EQ(run_order.size(), 3);
+  EXPECT_EQ(run_order[0], "slow");
+}
+
+TEST(IgECS_Scheduler, TimesAsyncNodesUntilTheyResolve) {
+  Scheduler::Builder sb("TimesAsyncNodesUntilTheyResolve");
+  std::vector<std::string> run_order;
+
+  // Returns right away, but its work takes longer than the sync node
+  auto async_slow = sb.add_node().build(
+      [&run_order](WorldView*,
+                   std::shared_ptr<igasync::ExecutionContext> main_thread,
+                   std::shared_ptr<igasync::ExecutionContext> any_thread,
+                   std::function<void(igasync::TaskProfile)>) {
+        run_order.push_back("async_slow");
+        auto rsl = igasync::Promise<void>::Create();
+        any_thread->schedule(igasync::Task::Of([rsl] {
+          std::this_thread::sleep_for(std::chrono::milliseconds(6));
+          rsl->resolve();
+        }));
+        return rsl;
+      },
+      sys_id<1>(), "async_slow");
+  auto sync_slow = sb.add_node().build(
+      [&run_order](WorldView*) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        run_order.push_back("sync_slow");
+      },
+      sys_id<2>(), "sync_slow");
+
+  auto pool = WorkStealingPool::Create(0);
+  auto scheduler = sb.build();
+  entt::registry r;
+
+  scheduler.execute(pool, &r);
+  ASSERT_EQ(run_order.size(), 2);
+
+  // Timed until the promise resolved, the async node is the longer one
+  run_order.clear();
+  scheduler.execute(pool, &r);
+  ASSERT_EQ(run_order.size(), 2);
+  EXPECT_EQ(run_order[0], "async_slow");
+}
+
+TEST(IgECS_Scheduler, RunsPartitionedNodeOverDisjointRanges) {
+  Scheduler::Builder sb("RunsPartitionedNodeOverDisjointRanges");
+  std::atomic_uint32_t partitions_run = 0u;
+  bool read_foo_ran = false;
+
+  auto increment_foo = [&partitions_run](WorldView* wv) {
+    for (auto [e, foo] : wv->primary_view<FooT>().each()) {
+      foo.a++;
+    }
+    partitions_run++;
+  };
+  auto check_foo = [&partitions_run, &read_foo_ran](WorldView* wv) {
+    EXPECT_EQ(partitions_run.load(), 4u);
+    int count = 0;
+    for (auto [e, foo] : wv->view<const FooT>().each()) {
+      EXPECT_EQ(foo.a, 1);
+      count++;
+    }
+    EXPECT_EQ(count, 1000);
+    read_foo_ran = true;
+  };
+
+  auto write_foo = sb.add_node()
+                       .with_decl(write_foo_decl())
+                       .partitioned(4u)
+                       .build(increment_foo, sys_id<1>(), "write_foo");
+  auto read_foo = sb.add_node()
+                      .with_decl(read_foo_decl())
+                      .depends_on(write_foo)
+                      .build(check_foo, sys_id<2>(), "read_foo");
+
+  entt::registry r;
+  for (int i = 0; i < 1000; i++) {
+    r.emplace<FooT>(r.create(), 0);
+  }
+
+  auto pool = WorkStealingPool::Create(3);
+  auto scheduler = sb.build();
+  EXPECT_EQ(scheduler.graph_stats().node_count, 5u);
+
+  scheduler.execute(pool, &r);
+  EXPECT_EQ(partitions_run.load(), 4u);
+  EXPECT_TRUE(read_foo_ran);
+}
+
+TEST(IgECS_Scheduler, PlaysBackDeferredCommandsAtSyncPoint) {
+  Scheduler::Builder sb("PlaysBackDeferredCommandsAtSyncPoint");
+
+  WorldView::Decl decl;
+  decl.reads<FooT>().writes<BarT>().creates_entities();
+
+  auto tag_foo = [](WorldView* wv) {
+    for (auto [e, foo] : wv->primary_view<const FooT>().each()) {
+      wv->defer_attach<BarT>(e, foo.a);
+    }
+    auto created = wv->defer_create();
+    wv->defer_attach<BarT>(created, -1);
+
+    // Nothing is applied until every partition is done
+    EXPECT_EQ(wv->view<const BarT>().size(), 0u);
+  };
+  auto check_bar = [](WorldView* wv) {
+    int tagged = 0, created = 0;
+    for (auto [e, bar] : wv->view<const BarT>().each()) {
+      if (bar.b < 0) {
+        created++;
+      } else {
+        EXPECT_EQ(bar.b, wv->read<FooT>(e).a);
+        tagged++;
+      }
+    }
+    EXPECT_EQ(tagged, 1000);
+    EXPECT_EQ(created, 4);
+  };
+
+  auto tag_node = sb.add_node().with_decl(decl).partitioned(4u).build(
+      tag_foo, sys_id<1>(), "tag_foo");
+  WorldView::Decl check_decl;
+  check_decl.reads<FooT>().reads<BarT>();
+  auto check_node = sb.add_node()
+                        .with_decl(check_decl)
+                        .depends_on(tag_node)
+                        .build(check_bar, sys_id<2>(), "check_bar");
+
+  entt::registry r;
+  for (int i = 0; i < 1000; i++) {
+    r.emplace<FooT>(r.create(), i);
+  }
+
+  auto pool = WorkStealingPool::Create(3);
+  auto scheduler = sb.build();
+  scheduler.execute(pool, &r);
+  EXPECT_EQ(r.view<BarT>().size(), 1004u);
 }
 
 #ifndef NDEBUG
 TEST(IgECS_SchedulerDeathTest, FailsToBuildWithUnclearDepOrdering) {
-  Scheduler::Builder sb;
+  Scheduler::Builder sb("FailsToBuildWithUnclearDepOrdering");
 
-  auto n1 = sb.add_node().with_decl(write_foo_decl()).build([](auto*) {
-    return igasync::Promise<void>::Immediate();
-  });
-  auto n2 = sb.add_node().with_decl(read_foo_decl()).build([](auto*) {
-    return igasync::Promise<void>::Immediate();
-  });
+  auto n1 = sb.add_node().with_decl(write_foo_decl()).build(
+      [](auto*) {}, sys_id<1>(), "n1");
+  auto n2 = sb.add_node().with_decl(read_foo_decl()).build(
+      [](auto*) {}, sys_id<2>(), "n2");
 
   EXPECT_DEATH({ auto scheduler = sb.build(); },
                "\\[IgECS::Scheduler\\] Strict dependency not found");
 }
 
+TEST(IgECS_SchedulerDeathTest, FixedTickNodeCannotDependOnFrameNode) {
+  Scheduler::Builder sb("FixedTickNodeCannotDependOnFrameNode");
+  sb.fixed_tick(std::chrono::milliseconds(10));
+
+  auto per_frame = sb.add_node().with_decl(read_foo_decl()).build(
+      [](auto*) {}, sys_id<1>(), "per_frame");
+  auto tick = sb.add_node()
+                  .with_decl(write_foo_decl())
+                  .fixed_tick()
+                  .depends_on(per_frame)
+                  .build([](auto*) {}, sys_id<2>(), "tick");
+
+  EXPECT_DEATH({ auto scheduler = sb.build(); },
+               "\\[IgECS::Scheduler\\] Fixed tick node depends on a "
+               "per-frame node");
+}
+
 TEST(IgECS_SchedulerDeathTest, CannotBuildNodeTwice) {
   // This is an API mitigation against cycles - being able to build a node twice
   //  would result in the possibility of introducing cycles by being unable to
   //  distinguish between nodes, which would be a problem.
-  Scheduler::Builder sb;
+  Scheduler::Builder sb("CannotBuildNodeTwice");
 
   auto nb = sb.add_node();
 
-  auto n = nb.build([](auto*) { return igasync::Promise<void>::Immediate(); });
+  auto n = nb.build([](auto*) {}, sys_id<1>(), "n");
 
-  EXPECT_DEATH(
-      {
-        auto n2 =
-            nb.build([](auto*) { return igasync::Promise<void>::Immediate(); });
-      },
-      "\\[IgECS::Scheduler\\] Node is already built");
+  EXPECT_DEATH({ auto n2 = nb.build([](auto*) {}, sys_id<2>(), "n2"); },
+               "\\[IgECS::Scheduler\\] Node is already built");
 }
 
 TEST(IgECS_SchedulerDeathTest, FailsWithUnclearEventOrdering) {
-  Scheduler::Builder sb;
+  Scheduler::Builder sb("FailsWithUnclearEventOrdering");
 
   struct EvtType {
     int payload;
@@ -219,20 +774,32 @@ TEST(IgECS_SchedulerDeathTest, FailsWithUnclearEventOrdering) {
   WorldView::Decl write_decl = WorldView::Decl().evt_writes<EvtType>();
   WorldView::Decl consume_decl = WorldView::Decl().evt_consumes<EvtType>();
 
-  auto producer_node_a = sb.add_node().with_decl(write_decl).build([](auto*) {
-    return igasync::Promise<void>::Immediate();
-  });
-  auto producer_node_b = sb.add_node().with_decl(write_decl).build([](auto*) {
-    return igasync::Promise<void>::Immediate();
-  });
+  auto producer_node_a = sb.add_node().with_decl(write_decl).build(
+      [](auto*) {}, sys_id<1>(), "producer_a");
+  auto producer_node_b = sb.add_node().with_decl(write_decl).build(
+      [](auto*) {}, sys_id<2>(), "producer_b");
 
-  auto consumer_node =
-      sb.add_node()
-          .with_decl(consume_decl)
-          .depends_on(producer_node_a)
-          // Leave commented out - this is the missing piece
-          // .depends_on(producer_node_b)
-          .build([](auto*) { return igasync::Promise<void>::Immediate(); });
+  auto consumer_node = sb.add_node()
+                           .with_decl(consume_decl)
+                           .depends_on(producer_node_a)
+                           // Leave commented out - this is the missing piece
+                           // .depends_on(producer_node_b)
+                           .build([](auto*) {}, sys_id<3>(), "consumer");
+
+  EXPECT_DEATH({ auto scheduler = sb.build(); },
+               "\\[IgECS::Scheduler\\] Strict dependency not found");
+}
+
+TEST(IgECS_SchedulerDeathTest, FailsWithUnclearEntityDestructionOrdering) {
+  // No component conflicts here - but destroying entities while another node
+  //  iterates over them is still a race
+  Scheduler::Builder sb("FailsWithUnclearEntityDestructionOrdering");
+
+  auto read_foo = sb.add_node().with_decl(read_foo_decl()).build(
+      [](auto*) {}, sys_id<1>(), "read_foo");
+  auto destroy = sb.add_node()
+                     .with_decl(WorldView::Decl().destroys_entities())
+                     .build([](auto*) {}, sys_id<2>(), "destroy");
 
   EXPECT_DEATH({ auto scheduler = sb.build(); },
                "\\[IgECS::Scheduler\\] Strict dependency not found");
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <igecs/chase_lev_deque.h>
+#include <igecs/scheduler.h>
+#include <igecs/work_stealing_pool.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace igecs;
+
+namespace {
+struct FooT {
+  int a;
+};
+
+template <int N>
+struct TestSystem {};
+
+void wait_for(WorkStealingPool* pool, const std::atomic_int& counter,
+              int target) {
+  while (counter.load() < target) {
+    if (!pool->execute_next()) {
+      std::this_thread::yield();
+    }
+  }
+}
+}  // namespace
+
+TEST(IgECS_ChaseLevDeque, OwnerPopsNewestFirst) {
+  ChaseLevDeque<int*> deque;
+  int values[3] = {1, 2, 3};
+
+  for (int i = 0; i < 3; i++) {
+    deque.push(&values[i]);
+  }
+
+  int* out = nullptr;
+  EXPECT_TRUE(deque.pop(out));
+  EXPECT_EQ(*out, 3);
+  EXPECT_TRUE(deque.pop(out));
+  EXPECT_EQ(*out, 2);
+  EXPECT_TRUE(deque.pop(out));
+  EXPECT_EQ(*out, 1);
+  EXPECT_FALSE(deque.pop(out));
+}
+
+TEST(IgECS_ChaseLevDeque, ThiefStealsOldestFirst) {
+  ChaseLevDeque<int*> deque;
+  int values[3] = {1, 2, 3};
+
+  for (int i = 0; i < 3; i++) {
+    deque.push(&values[i]);
+  }
+
+  int* out = nullptr;
+  EXPECT_TRUE(deque.steal(out));
+  EXPECT_EQ(*out, 1);
+  EXPECT_TRUE(deque.pop(out));
+  EXPECT_EQ(*out, 3);
+  EXPECT_TRUE(deque.steal(out));
+  EXPECT_EQ(*out, 2);
+  EXPECT_FALSE(deque.steal(out));
+}
+
+TEST(IgECS_ChaseLevDeque, GrowsPastInitialCapacity) {
+  ChaseLevDeque<std::intptr_t> deque(2);
+
+  for (std::intptr_t i = 0; i < 1000; i++) {
+    deque.push(i);
+  }
+  EXPECT_EQ(deque.size_approx(), 1000);
+
+  std::intptr_t out = 0;
+  for (std::intptr_t i = 0; i < 1000; i++) {
+    EXPECT_TRUE(deque.steal(out));
+    EXPECT_EQ(out, i);
+  }
+  EXPECT_FALSE(deque.pop(out));
+}
+
+TEST(IgECS_WorkStealingPool, RunsExternallyScheduledTasks) {
+  auto pool = WorkStealingPool::Create(4);
+  EXPECT_EQ(pool->thread_ids().size(), 4);
+
+  std::atomic_int counter = 0;
+  for (int i = 0; i < 1000; i++) {
+    pool->schedule(igasync::Task::Of([&counter] { counter++; }));
+  }
+
+  wait_for(pool.get(), counter, 1000);
+  EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(IgECS_WorkStealingPool, RunsTasksScheduledFromWorkers) {
+  auto pool = WorkStealingPool::Create(4);
+
+  std::atomic_int counter = 0;
+  for (int i = 0; i < 10; i++) {
+    pool->schedule(igasync::Task::Of([&counter, p = pool.get()] {
+      for (int j = 0; j < 100; j++) {
+        p->schedule(igasync::Task::Of([&counter] { counter++; }));
+      }
+    }));
+  }
+
+  wait_for(pool.get(), counter, 1000);
+  EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(IgECS_WorkStealingPool, RunsWithNoWorkers) {
+  auto pool = WorkStealingPool::Create(0);
+
+  std::atomic_int counter = 0;
+  for (int i = 0; i < 10; i++) {
+    pool->schedule(igasync::Task::Of([&counter] { counter++; }));
+  }
+
+  wait_for(pool.get(), counter, 10);
+  EXPECT_EQ(counter.load(), 10);
+}
+
+TEST(IgECS_WorkStealingPool, SchedulerExecutesWithPool) {
+  auto pool = WorkStealingPool::Create(3);
+
+  Scheduler::Builder sb("SchedulerExecutesWithPool");
+  for (auto id : pool->thread_ids()) {
+    sb.worker_thread_id(id);
+  }
+
+  std::atomic_int runs = 0;
+  auto top = sb.add_node()
+                 .with_decl(WorldView::Decl().writes<FooT>())
+                 .build(
+                     [&runs](WorldView* wv) {
+                       for (auto [e, foo] : wv->view<FooT>().each()) {
+                         foo.a++;
+                       }
+                       runs++;
+                     },
+                     CttiTypeId::of<TestSystem<1>>(), "top");
+  auto left = sb.add_node()
+                  .with_decl(WorldView::Decl().reads<FooT>())
+                  .depends_on(top)
+                  .build([&runs](WorldView*) { runs++; },
+                         CttiTypeId::of<TestSystem<2>>(), "left");
+  auto right =
+      sb.add_node()
+          .with_decl(WorldView::Decl().reads<FooT>())
+          .depends_on(top)
+          .build(
+              [&runs](WorldView* wv,
+                      std::shared_ptr<igasync::ExecutionContext> main_thread,
+                      std::shared_ptr<igasync::ExecutionContext> any_thread,
+                      std::function<void(igasync::TaskProfile)>) {
+                auto rsl = igasync::Promise<void>::Create();
+                any_thread->schedule(igasync::Task::Of([&runs, rsl] {
+                  runs++;
+                  rsl->resolve();
+                }));
+                return rsl;
+              },
+              CttiTypeId::of<TestSystem<3>>(), "right");
+  auto bottom = sb.add_node()
+                    .with_decl(WorldView::Decl().writes<FooT>())
+                    .depends_on(left)
+                    .depends_on(right)
+                    .main_thread_only()
+                    .build([&runs](WorldView*) { runs++; },
+                           CttiTypeId::of<TestSystem<4>>(), "bottom");
+
+  auto scheduler = sb.build();
+
+  entt::registry r;
+  auto e = r.create();
+  r.emplace<FooT>(e, 0);
+
+  for (int i = 0; i < 10; i++) {
+    scheduler.execute(pool, &r);
+  }
+
+  EXPECT_EQ(runs.load(), 40);
+  EXPECT_EQ(r.get<FooT>(e).a, 10);
+}
+
+TEST(IgECS_WorkStealingPool, MainThreadParksWhileWaitingOnWorkers) {
+  auto pool = WorkStealingPool::Create(2);
+
+  Scheduler::Builder sb("MainThreadParksWhileWaitingOnWorkers");
+  for (auto id : pool->thread_ids()) {
+    sb.worker_thread_id(id);
+  }
+  sb.main_thread_id(std::this_thread::get_id());
+  sb.max_spin_time(std::chrono::seconds(5));
+  sb.idle_spin_time(std::chrono::microseconds(0));
+
+  // The slow node waits on something outside of the scheduler entirely, so
+  //  neither the main thread nor the workers have anything to do meanwhile
+  std::atomic_bool slow_ran = false;
+  std::thread::id main_node_thread_id;
+  std::thread external_work;
+  auto slow =
+      sb.add_node()
+          .with_decl(WorldView::Decl().writes<FooT>())
+          .build(
+              [&slow_ran, &external_work](
+                  WorldView*, std::shared_ptr<igasync::ExecutionContext>,
+                  std::shared_ptr<igasync::ExecutionContext>,
+                  std::function<void(igasync::TaskProfile)>) {
+                auto rsl = igasync::Promise<void>::Create();
+                external_work = std::thread([&slow_ran, rsl] {
+                  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                  slow_ran = true;
+                  rsl->resolve();
+                });
+                return rsl;
+              },
+              CttiTypeId::of<TestSystem<1>>(), "slow");
+  auto main_only = sb.add_node()
+                       .with_decl(WorldView::Decl().reads<FooT>())
+                       .depends_on(slow)
+                       .main_thread_only()
+                       .build(
+                           [&slow_ran, &main_node_thread_id](WorldView*) {
+                             EXPECT_TRUE(slow_ran.load());
+                             main_node_thread_id = std::this_thread::get_id();
+                           },
+                           CttiTypeId::of<TestSystem<2>>(), "main_only");
+
+  auto scheduler = sb.build();
+  entt::registry r;
+  scheduler.execute(pool, &r);
+  external_work.join();
+
+  EXPECT_TRUE(slow_ran.load());
+  EXPECT_EQ(main_node_thread_id, std::this_thread::get_id());
+  EXPECT_NE(scheduler.dump_profile(false).find("\"parked\":true"),
+            std::string::npos);
+}
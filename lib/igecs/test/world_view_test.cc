@@ -3,8 +3,12 @@
 
 #include <gtest/gtest-death-test.h>
 #include <gtest/gtest.h>
+#include <igecs/profile/frame_profiler.h>
 #include <igecs/world_view.h>
 
+#include <thread>
+#include <vector>
+
 using namespace igecs;
 
 namespace {
@@ -16,6 +20,17 @@ struct BarT {
   int a;
   int b;
 };
+
+struct TestSystem {};
+
+// Runs every task on the list, returns how many there were
+int drain(igasync::TaskList* task_list) {
+  int ct = 0;
+  while (task_list->execute_next()) {
+    ct++;
+  }
+  return ct;
+}
 }  // namespace
 
 TEST(IgECS_WorldView, UnrestrictedWorldViewAllowsAccesses) {
@@ -174,6 +189,31 @@ TEST(IgECS_WorldView, MergesInDecl) {
   }
 }
 
+TEST(IgECS_WorldView, MergeInDeclListsEachTypeOnce) {
+  WorldView::Decl d;
+  d.reads<FooT>().writes<BarT>();
+  WorldView::Decl d2;
+  d2.writes<FooT>().reads<BarT>();
+  d.merge_in_decl(d2).merge_in_decl(d2);
+
+  EXPECT_EQ(d.list_reads().size(), 2);
+  EXPECT_EQ(d.list_writes().size(), 2);
+  EXPECT_TRUE(d.can_write<FooT>());
+  EXPECT_TRUE(d.can_write<const BarT>());
+}
+
+TEST(IgECS_WorldView, DeclConflictsOnSharedWrites) {
+  WorldView::Decl read_foo, write_foo, read_bar;
+  read_foo.reads<FooT>();
+  write_foo.writes<FooT>();
+  read_bar.reads<BarT>();
+
+  EXPECT_FALSE(read_foo.conflicts_with(read_foo));
+  EXPECT_TRUE(read_foo.conflicts_with(write_foo));
+  EXPECT_TRUE(write_foo.conflicts_with(read_foo));
+  EXPECT_FALSE(write_foo.conflicts_with(read_bar));
+}
+
 TEST(IgECS_WorldView, RecordsDebugInfoForOtherTests) {
   entt::registry world;
   auto e = world.create();
@@ -229,6 +269,242 @@ TEST(IgECS_WorldView, RecordsDebugInfoForOtherTests) {
   }
 }
 
+TEST(IgECS_WorldView, RecordsAccessFromManyThreads) {
+  entt::registry world;
+  std::vector<entt::entity> entities;
+  for (int i = 0; i < 1000; i++) {
+    auto e = world.create();
+    world.emplace<FooT>(e, i);
+    world.emplace<BarT>(e, i, i);
+    entities.push_back(e);
+  }
+
+  WorldView::Decl decl;
+  decl.reads<FooT>().writes<BarT>();
+  WorldView wv = decl.create(&world);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&wv, &entities, t]() {
+      for (int i = t; i < entities.size(); i += 4) {
+        wv.write<BarT>(entities[i]).b = wv.read<FooT>(entities[i]).a;
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_TRUE(wv.has_read<FooT>());
+  EXPECT_TRUE(wv.has_written<BarT>());
+  EXPECT_FALSE(wv.has_written<FooT>());
+  EXPECT_EQ(world.get<BarT>(entities[999]).b, 999);
+
+  wv.reset(&world);
+  EXPECT_FALSE(wv.has_read<FooT>());
+  EXPECT_FALSE(wv.has_written<BarT>());
+}
+
+TEST(IgECS_WorldView, ParallelEachVisitsEveryMatchingEntityOnce) {
+  entt::registry registry;
+  for (int i = 0; i < 1000; i++) {
+    auto e = registry.create();
+    registry.emplace<FooT>(e, 0);
+    if (i % 2 == 0) {
+      registry.emplace<BarT>(e, i, 0);
+    }
+  }
+
+  WorldView::Decl decl;
+  decl.writes<FooT>().reads<BarT>();
+
+  // Pretend there are 4 threads, so that the work is split up
+  profile::FrameProfiler profiler("ParallelEach", std::thread::id(),
+                                  {std::thread::id(), std::thread::id(),
+                                   std::thread::id()});
+  auto system_id = CttiTypeId::of<TestSystem>();
+  profiler.AddSystem(system_id, "TestSystem", decl, false);
+
+  auto wv = decl.create(&registry, &profiler, system_id.id);
+  auto task_list = igasync::TaskList::Create();
+
+  bool is_done = false;
+  wv.parallel_each<FooT, const BarT>(task_list,
+                                     [](entt::entity, FooT& foo,
+                                        const BarT& bar) { foo.a += bar.a; })
+      ->on_resolve([&is_done] { is_done = true; }, task_list);
+
+  EXPECT_GT(drain(task_list.get()), 2);
+  EXPECT_TRUE(is_done);
+
+  int visited = 0;
+  for (auto [e, foo] : registry.view<FooT>().each()) {
+    if (registry.all_of<BarT>(e)) {
+      EXPECT_EQ(foo.a, registry.get<BarT>(e).a);
+      visited++;
+    } else {
+      EXPECT_EQ(foo.a, 0);
+    }
+  }
+  EXPECT_EQ(visited, 500);
+}
+
+TEST(IgECS_WorldView, ParallelEachSizesChunksFromCostHistory) {
+  entt::registry registry;
+  for (int i = 0; i < 10000; i++) {
+    registry.emplace<FooT>(registry.create(), i);
+  }
+
+  WorldView::Decl decl;
+  decl.writes<FooT>();
+
+  auto system_id = CttiTypeId::of<TestSystem>();
+  auto run_frame = [&](profile::FrameProfiler* profiler) {
+    auto task_list = igasync::TaskList::Create();
+    profiler->StartFrame();
+    auto wv = decl.create(&registry, profiler, system_id.id);
+    wv.parallel_each<FooT>(task_list, [](entt::entity, FooT& foo) {});
+    int task_ct = drain(task_list.get());
+    profiler->EndFrame();
+    return task_ct;
+  };
+
+  // No history - even split, several chunks per thread
+  {
+    profile::FrameProfiler profiler("ParallelEach", std::thread::id(),
+                                    {std::thread::id(), std::thread::id(),
+                                     std::thread::id()});
+    profiler.AddSystem(system_id, "TestSystem", decl, false);
+    EXPECT_EQ(run_frame(&profiler), 16);
+  }
+
+  // Cheap entities - chunks grow until they are long enough to be worth
+  //  scheduling. Here everything fits in one chunk, which runs inline.
+  {
+    profile::FrameProfiler profiler("ParallelEach", std::thread::id(),
+                                    {std::thread::id(), std::thread::id(),
+                                     std::thread::id()});
+    profiler.AddSystem(system_id, "TestSystem", decl, false);
+    profiler.StartFrame();
+    profiler.AddEntityCostSample(system_id.id, 10000,
+                                 std::chrono::microseconds(10));
+    profiler.EndFrame();
+    EXPECT_EQ(profiler.EntityCostEstimate(system_id.id), 1.);
+    EXPECT_EQ(run_frame(&profiler), 0);
+  }
+}
+
+TEST(IgECS_WorldView, PrimaryViewPartitionsAreDisjoint) {
+  entt::registry registry;
+  for (int i = 0; i < 1000; i++) {
+    auto e = registry.create();
+    registry.emplace<FooT>(e, 0);
+    if (i % 2 == 0) {
+      registry.emplace<BarT>(e, i, 0);
+    }
+  }
+
+  WorldView::Decl decl;
+  decl.writes<FooT>().reads<BarT>();
+
+  const std::uint32_t kPartitionCount = 3u;
+  std::uint32_t next_begin = 0u;
+  for (std::uint32_t i = 0; i < kPartitionCount; i++) {
+    auto wv = decl.create(&registry);
+    wv.set_partition(i, kPartitionCount);
+
+    auto view = wv.primary_view<FooT, const BarT>();
+    EXPECT_EQ(view.range().begin, next_begin);
+    next_begin = view.range().end;
+
+    for (auto [e, foo, bar] : view.each()) {
+      EXPECT_TRUE(view.contains(e));
+      wv.write<FooT>(e).a++;
+    }
+  }
+  auto full_view = registry.view<FooT, const BarT>();
+  EXPECT_EQ(next_begin,
+            static_cast<std::uint32_t>(full_view.handle()->size()));
+
+  int visited = 0;
+  for (auto [e, foo] : registry.view<FooT>().each()) {
+    if (registry.all_of<BarT>(e)) {
+      EXPECT_EQ(foo.a, 1);
+      visited++;
+    } else {
+      EXPECT_EQ(foo.a, 0);
+    }
+  }
+  EXPECT_EQ(visited, 500);
+}
+
+TEST(IgECS_WorldView, PartitionRangeSplitsExternalItems) {
+  entt::registry registry;
+  WorldView::Decl decl;
+
+  // Everything belongs to a view without a partition
+  auto unpartitioned = decl.create(&registry);
+  EXPECT_EQ(unpartitioned.partition_range(10u).begin, 0u);
+  EXPECT_EQ(unpartitioned.partition_range(10u).end, 10u);
+
+  const std::uint32_t kPartitionCount = 3u;
+  std::uint32_t next_begin = 0u;
+  for (std::uint32_t i = 0; i < kPartitionCount; i++) {
+    auto wv = decl.create(&registry);
+    wv.set_partition(i, kPartitionCount);
+
+    auto range = wv.partition_range(10u);
+    EXPECT_EQ(range.begin, next_begin);
+    next_begin = range.end;
+  }
+  EXPECT_EQ(next_begin, 10u);
+}
+
+TEST(IgECS_WorldView, PrimaryGroupPartitionsOwnedComponents) {
+  entt::registry registry;
+  for (int i = 0; i < 1000; i++) {
+    auto e = registry.create();
+    registry.emplace<FooT>(e, 0);
+    if (i % 2 == 0) {
+      registry.emplace<BarT>(e, i, 0);
+    }
+  }
+
+  WorldView::Decl decl;
+  decl.owning_group<FooT, const BarT>();
+
+  // Groups are created along with the rest of the world setup
+  decl.create(&registry).group<FooT, const BarT>();
+
+  const std::uint32_t kPartitionCount = 3u;
+  std::uint32_t next_begin = 0u;
+  for (std::uint32_t i = 0; i < kPartitionCount; i++) {
+    auto wv = decl.create(&registry);
+    wv.set_partition(i, kPartitionCount);
+
+    auto group = wv.primary_group<FooT, const BarT>();
+    EXPECT_EQ(group.range().begin, next_begin);
+    next_begin = group.range().end;
+
+    for (auto [e, foo, bar] : group.each()) {
+      EXPECT_TRUE(group.contains(e));
+      wv.write<FooT>(e).a++;
+    }
+  }
+  EXPECT_EQ(next_begin, 500u);
+
+  int visited = 0;
+  for (auto [e, foo] : registry.view<FooT>().each()) {
+    if (registry.all_of<BarT>(e)) {
+      EXPECT_EQ(foo.a, 1);
+      visited++;
+    } else {
+      EXPECT_EQ(foo.a, 0);
+    }
+  }
+  EXPECT_EQ(visited, 500);
+}
+
 #ifndef NDEBUG
 TEST(IgECS_WorldViewDeathTest, BadCtxReadFails) {
   entt::registry registry;
@@ -317,6 +593,18 @@ TEST(IgECS_WorldViewDeathTest, BadViewWriteFails) {
   EXPECT_DEATH({ get(); }, "IMMUTABLE view_test failed for type .*FooT");
 }
 
+TEST(IgECS_WorldViewDeathTest, UndeclaredGroupFails) {
+  entt::registry registry;
+
+  WorldView::Decl decl;
+  decl.writes<FooT>().reads<BarT>();
+  auto wv = decl.create(&registry);
+
+  auto get = [&wv]() { return wv.group<FooT, const BarT>(); };
+  EXPECT_DEATH({ get(); },
+               "ECS validation failure: method group failed for type .*FooT");
+}
+
 TEST(IgECS_WorldViewDeathTest, BadEventQueueFails) {
   entt::registry registry;
 
@@ -340,4 +628,36 @@ TEST(IgECS_WorldViewDeathTest, BadEventQueueFails) {
       { wv.consume_events<FooT>(); },
       "ECS validation failure: method consume_events failed for type .*FooT");
 }
+
+TEST(IgECS_WorldViewDeathTest, PartitionedWriteOutsideOfPartitionFails) {
+  entt::registry registry;
+  std::vector<entt::entity> entities;
+  for (int i = 0; i < 10; i++) {
+    entities.push_back(registry.create());
+    registry.emplace<FooT>(entities.back(), i);
+  }
+
+  WorldView::Decl decl;
+  decl.writes<FooT>();
+  auto wv = decl.create(&registry);
+  wv.set_partition(0u, 2u);
+
+  auto view = wv.primary_view<FooT>();
+  entt::entity outside = entt::null;
+  for (auto e : entities) {
+    if (view.contains(e)) {
+      wv.write<FooT>(e).a++;
+    } else {
+      outside = e;
+    }
+  }
+  ASSERT_NE(outside, entt::null);
+
+  EXPECT_DEATH({ wv.write<FooT>(outside).a++; },
+               "ECS validation failure: method write touched an entity "
+               "outside of its partition for type .*FooT");
+  EXPECT_DEATH({ wv.attach<FooT>(registry.create(), FooT{1}); },
+               "ECS validation failure: method attach \\(structural change "
+               "in partition\\) failed for type .*FooT");
+}
 #endif
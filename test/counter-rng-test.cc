@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <igdemo/logic/counter-rng.h>
+
+#include <cstdint>
+
+using igdemo::CounterRng;
+
+TEST(CounterRng, DependsOnlyOnSeedAndCounter) {
+  const auto a = CounterRng::Of(1234u);
+  const auto b = CounterRng::Of(1234u);
+
+  // Draw order does not matter - there is no hidden state
+  for (std::uint64_t counter = 100u; counter-- > 0u;) {
+    EXPECT_EQ(a.u32(counter), b.u32(counter)) << "counter " << counter;
+  }
+  EXPECT_EQ(a.uniform(7u, -3.f, 3.f), a.uniform(7u, -3.f, 3.f));
+}
+
+TEST(CounterRng, UniformStaysInRange) {
+  struct Range {
+    float min;
+    float max;
+  };
+
+  // Includes a narrow range far from zero, where scaling rounds up to max
+  for (auto range : {Range{0.f, 1.f}, Range{-80.f, 80.f},
+                     Range{0.f, 3.14159265f}, Range{10.f, 10.5f}}) {
+    for (std::uint32_t seed = 0u; seed < 8u; seed++) {
+      const auto rng = CounterRng::Of(seed);
+      for (std::uint64_t counter = 0u; counter < 20000u; counter++) {
+        const float value = rng.uniform(counter, range.min, range.max);
+        ASSERT_GE(value, range.min) << "seed " << seed << ", " << counter;
+        ASSERT_LT(value, range.max) << "seed " << seed << ", " << counter;
+      }
+    }
+  }
+}
+
+TEST(CounterRng, NeighbouringSeedsGiveDifferentStreams) {
+  for (std::uint32_t seed = 0u; seed < 16u; seed++) {
+    const auto a = CounterRng::Of(seed);
+    const auto b = CounterRng::Of(seed + 1u);
+
+    int matches = 0;
+    for (std::uint64_t counter = 0u; counter < 1000u; counter++) {
+      if (a.u32(counter) == b.u32(counter)) {
+        matches++;
+      }
+    }
+
+    // Two independent 32-bit streams should (almost) never agree
+    EXPECT_LE(matches, 1) << "seeds " << seed << " and " << seed + 1u;
+  }
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <igdemo/logic/locomotion-kernel.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/transform.hpp>
+#include <vector>
+
+namespace {
+glm::mat4 glm_transform(glm::vec2 pos, float angle, float scale) {
+  return glm::translate(glm::vec3(pos.x, 0.f, pos.y)) *
+         glm::rotate(angle, glm::vec3(0.f, 1.f, 0.f)) *
+         glm::scale(glm::vec3(scale));
+}
+}  // namespace
+
+TEST(LocomotionKernel, MatchesGlmTransforms) {
+  igdemo::LocomotionBatch batch;
+
+  // Not a multiple of the lane count, and angles in every quadrant
+  for (int i = 0; i < 23; i++) {
+    batch.push(glm::vec2(i * 1.5f, -i * 0.5f), -7.f + i * 0.6f,
+               0.5f + i * 0.1f);
+  }
+
+  std::vector<glm::mat4> transforms(batch.size());
+  igdemo::compute_world_transforms(batch, transforms.data());
+
+  for (std::size_t i = 0; i < batch.size(); i++) {
+    glm::mat4 expected = glm_transform(glm::vec2(batch.x[i], batch.z[i]),
+                                       batch.angle[i], batch.scale[i]);
+    for (int col = 0; col < 4; col++) {
+      for (int row = 0; row < 4; row++) {
+        EXPECT_NEAR(transforms[i][col][row], expected[col][row], 1e-5f)
+            << "entity " << i << ", column " << col << ", row " << row;
+      }
+    }
+  }
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <igdemo/logic/combat.h>
+#include <igdemo/logic/projectile-pool.h>
+#include <igdemo/systems/destroy-actor.h>
+#include <igdemo/systems/projectile-hit.h>
+#include <igecs/world_view.h>
+
+#include <algorithm>
+#include <vector>
+
+using igdemo::ApplyProjectileDamageSystem;
+using igdemo::EvtDestroyActor;
+using igdemo::EvtProjectileDamage;
+using igdemo::HealthComponent;
+
+TEST(ApplyProjectileDamage, SumsDamagePerTargetAndDestroysOnce) {
+  entt::registry r;
+  auto setup = igecs::WorldView::Thin(&r);
+  setup.attach_ctx<igdemo::CtxProjectilePool>();
+  setup.attach_ctx<igecs::CtxEventQueue<EvtProjectileDamage>>();
+  setup.attach_ctx<igecs::CtxEventQueue<EvtDestroyActor>>();
+
+  auto killed = setup.create();
+  setup.attach<HealthComponent>(killed, HealthComponent{10.f, 10.f});
+  auto survivor = setup.create();
+  setup.attach<HealthComponent>(survivor, HealthComponent{100.f, 100.f});
+  auto one_shot = setup.create();
+  setup.attach<HealthComponent>(one_shot, HealthComponent{1.f, 1.f});
+  auto no_health = setup.create();
+  auto stale = setup.create();
+  setup.attach<HealthComponent>(stale, HealthComponent{10.f, 10.f});
+  setup.destroy(stale);
+
+  // Interleaved, with several hits on the same targets
+  for (auto target : {killed, survivor, stale, killed, no_health, one_shot,
+                      survivor, killed}) {
+    setup.enqueue_event(EvtProjectileDamage{target, 4.f});
+  }
+
+  auto wv = ApplyProjectileDamageSystem::decl().create(&r);
+  ApplyProjectileDamageSystem::run(&wv);
+
+  EXPECT_FLOAT_EQ(r.get<HealthComponent>(killed).currentHealth, -2.f);
+  EXPECT_FLOAT_EQ(r.get<HealthComponent>(survivor).currentHealth, 92.f);
+  EXPECT_FLOAT_EQ(r.get<HealthComponent>(one_shot).currentHealth, -3.f);
+  EXPECT_FALSE(r.all_of<HealthComponent>(no_health));
+
+  std::vector<entt::entity> destroyed;
+  for (const auto& evt : setup.consume_events<EvtDestroyActor>()) {
+    destroyed.push_back(evt.e);
+  }
+  std::sort(destroyed.begin(), destroyed.end());
+  std::vector<entt::entity> expected{killed, one_shot};
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(destroyed, expected);
+
+  // Every damage event was consumed
+  EXPECT_TRUE(setup.consume_events<EvtProjectileDamage>().empty());
+}
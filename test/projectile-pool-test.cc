@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <igdemo/logic/projectile-pool.h>
+
+namespace {
+igdemo::EvtSpawnProjectile spawn_at(float x, float lifetime) {
+  return igdemo::EvtSpawnProjectile{glm::vec2(x, 0.f), glm::vec2(1.f, 2.f),
+                                    lifetime, igdemo::ProjectileSource::Hero};
+}
+}  // namespace
+
+TEST(ProjectilePool, IntegratesEveryProjectile) {
+  igdemo::ProjectilePool pool;
+
+  // Not a multiple of the lane count
+  for (int i = 0; i < 11; i++) {
+    pool.spawn(spawn_at(static_cast<float>(i), 10.f));
+  }
+  pool.integrate(0.5f);
+
+  ASSERT_EQ(pool.size(), 11u);
+  for (std::uint32_t i = 0; i < pool.size(); i++) {
+    EXPECT_FLOAT_EQ(pool.position(i).x, i + 0.5f) << "projectile " << i;
+    EXPECT_FLOAT_EQ(pool.position(i).y, 1.f) << "projectile " << i;
+  }
+}
+
+TEST(ProjectilePool, RemovesExpiredProjectiles) {
+  igdemo::ProjectilePool pool;
+
+  // Lifetimes alternate between 0.25 and 1.25 - evens expire
+  for (int i = 0; i < 10; i++) {
+    pool.spawn(spawn_at(static_cast<float>(i), i % 2 == 0 ? 0.25f : 1.25f));
+  }
+  pool.integrate(0.5f);
+  pool.expire(9);
+  pool.remove_expired();
+
+  ASSERT_EQ(pool.size(), 4u);
+  float x_sum = 0.f;
+  for (std::uint32_t i = 0; i < pool.size(); i++) {
+    x_sum += pool.position(i).x;
+  }
+
+  // 1, 3, 5, 7 survive (9 was expired by hand), each moved by 0.5
+  EXPECT_FLOAT_EQ(x_sum, 1.5f + 3.5f + 5.5f + 7.5f);
+}
+
+TEST(ProjectilePool, InterpolatesBetweenLastTwoTicks) {
+  igdemo::ProjectilePool pool;
+  pool.spawn(spawn_at(0.f, 10.f));
+
+  // Nothing to blend from before the first tick
+  EXPECT_FLOAT_EQ(pool.interpolated_position(0, 0.5f).x, 0.f);
+
+  pool.integrate(0.5f);
+  pool.spawn(spawn_at(4.f, 10.f));
+  pool.integrate(0.5f);
+
+  // Moved from 0.5 to 1 (and 2 to 2.5 in z) over the last tick
+  EXPECT_FLOAT_EQ(pool.interpolated_position(0, 0.f).x, 0.5f);
+  EXPECT_FLOAT_EQ(pool.interpolated_position(0, 0.5f).x, 0.75f);
+  EXPECT_FLOAT_EQ(pool.interpolated_position(0, 0.5f).y, 1.5f);
+  EXPECT_FLOAT_EQ(pool.interpolated_position(0, 1.f).x, 1.f);
+  EXPECT_FLOAT_EQ(pool.interpolated_position(1, 0.5f).x, 4.25f);
+}